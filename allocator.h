@@ -0,0 +1,160 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <map>
+#include <set>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+// blocks are handed out in multiples of this, which keeps them as aligned as
+// cudaMalloc's own.
+#define ALLOCATOR_ROUND 512
+
+// requests up to ALLOCATOR_SMALL bytes come from slabs of their own, so small
+// allocations don't break up the slabs large ones need.
+#define ALLOCATOR_SMALL (1024 * 1024)
+#define ALLOCATOR_SMALL_SLAB (2 * 1024 * 1024)
+
+// a large request bigger than a whole slab gets a slab of its own, rounded up
+// to this.
+#define ALLOCATOR_LARGE_ROUND (2 * 1024 * 1024)
+
+typedef struct {
+  uintptr_t slab;
+  size_t size;
+  bool free;
+} allocator_block_t;
+
+typedef struct {
+  size_t size;
+  // bytes of the slab that are handed out; a slab with none is idle.
+  size_t used;
+  bool small;
+} allocator_slab_t;
+
+// the device memory of one device that the client allocated in slabs and
+// hands out in blocks. a freed block is merged with its free neighbours in
+// the same slab, and free blocks are found best fit, smallest first, in the
+// pool of their size class.
+typedef struct {
+  std::map<uintptr_t, allocator_block_t> blocks;
+  std::map<uintptr_t, allocator_slab_t> slabs;
+  // free blocks by (size, address); small and large.
+  std::set<std::pair<size_t, uintptr_t>> free[2];
+  // bytes in idle slabs, which can go back to the server.
+  size_t idle = 0;
+} allocator_t;
+
+static inline size_t allocator_round(const size_t size, const size_t round) {
+  return (size + round - 1) / round * round;
+}
+
+static inline bool allocator_is_small(const size_t size) {
+  return size <= ALLOCATOR_SMALL;
+}
+
+// how much to allocate from the server for a request of size bytes that no
+// free block fits.
+static inline size_t allocator_slab_size(const size_t size,
+                                         const size_t slab) {
+  if (allocator_is_small(size))
+    return ALLOCATOR_SMALL_SLAB;
+  if (size <= slab)
+    return slab;
+  return allocator_round(size, ALLOCATOR_LARGE_ROUND);
+}
+
+static inline void allocator_add_slab(allocator_t *allocator,
+                                      const uintptr_t base, const size_t size,
+                                      const bool small) {
+  allocator->slabs[base] = {size, 0, small};
+  allocator->blocks[base] = {base, size, true};
+  allocator->free[small ? 0 : 1].insert({size, base});
+  allocator->idle += size;
+}
+
+// a block of size bytes, already rounded, or 0 if no free block fits.
+static inline uintptr_t allocator_alloc(allocator_t *allocator,
+                                        const size_t size) {
+  std::set<std::pair<size_t, uintptr_t>> &pool =
+      allocator->free[allocator_is_small(size) ? 0 : 1];
+  auto it = pool.lower_bound({size, 0});
+  if (it == pool.end())
+    return 0;
+
+  uintptr_t address = it->second;
+  pool.erase(it);
+  allocator_block_t &block = allocator->blocks[address];
+  if (block.size > size) {
+    allocator->blocks[address + size] = {block.slab, block.size - size, true};
+    pool.insert({block.size - size, address + size});
+    block.size = size;
+  }
+  block.free = false;
+
+  allocator_slab_t &slab = allocator->slabs[block.slab];
+  if (slab.used == 0)
+    allocator->idle -= slab.size;
+  slab.used += size;
+  return address;
+}
+
+// returns false if address isn't a block this allocator handed out.
+static inline bool allocator_free(allocator_t *allocator,
+                                  const uintptr_t address) {
+  auto it = allocator->blocks.find(address);
+  if (it == allocator->blocks.end() || it->second.free)
+    return false;
+
+  allocator_slab_t &slab = allocator->slabs[it->second.slab];
+  std::set<std::pair<size_t, uintptr_t>> &pool =
+      allocator->free[slab.small ? 0 : 1];
+  slab.used -= it->second.size;
+  if (slab.used == 0)
+    allocator->idle += slab.size;
+  it->second.free = true;
+
+  auto next = std::next(it);
+  if (next != allocator->blocks.end() && next->second.free &&
+      next->second.slab == it->second.slab) {
+    pool.erase({next->second.size, next->first});
+    it->second.size += next->second.size;
+    allocator->blocks.erase(next);
+  }
+  if (it != allocator->blocks.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second.free && prev->second.slab == it->second.slab) {
+      pool.erase({prev->second.size, prev->first});
+      prev->second.size += it->second.size;
+      allocator->blocks.erase(it);
+      it = prev;
+    }
+  }
+  pool.insert({it->second.size, it->first});
+  return true;
+}
+
+// takes idle slabs out of the allocator until no more than keep bytes are
+// idle, and returns their addresses for the caller to free.
+static inline std::vector<uintptr_t>
+allocator_trim(allocator_t *allocator, const size_t keep) {
+  std::vector<uintptr_t> released;
+  for (auto it = allocator->slabs.begin();
+       it != allocator->slabs.end() && allocator->idle > keep;) {
+    if (it->second.used > 0) {
+      ++it;
+      continue;
+    }
+    allocator->free[it->second.small ? 0 : 1].erase(
+        {it->second.size, it->first});
+    allocator->blocks.erase(it->first);
+    allocator->idle -= it->second.size;
+    released.push_back(it->first);
+    it = allocator->slabs.erase(it);
+  }
+  return released;
+}
+
+#endif
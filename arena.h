@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <vector>
+
+// allocations are aligned for any scalar or vector argument type.
+#define ARENA_ALIGN 16
+
+// scratch memory that lives for one request: the argument arrays a handler
+// reads before calling the real function and the buffers it passes for the
+// function to fill in. allocating is a pointer bump and everything goes away
+// at once when the request is done.
+typedef struct {
+  char *block;
+  size_t size;
+  size_t used;
+  // allocations that didn't fit in the block. the next reset grows the block
+  // to cover them, so a connection settles on one block big enough for its
+  // largest request.
+  std::vector<void *> overflow;
+  size_t overflow_size;
+} arena_t;
+
+static inline void *arena_alloc(arena_t *arena, const size_t size) {
+  size_t offset = (arena->used + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+  if (arena->block != NULL && offset + size <= arena->size) {
+    arena->used = offset + size;
+    return arena->block + offset;
+  }
+
+  void *data = malloc(size > 0 ? size : 1);
+  if (data == NULL)
+    return NULL;
+  arena->overflow.push_back(data);
+  arena->overflow_size += (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+  return data;
+}
+
+static inline void arena_reset(arena_t *arena) {
+  arena->used = 0;
+  if (arena->overflow.empty())
+    return;
+
+  for (void *data : arena->overflow)
+    free(data);
+  arena->overflow.clear();
+
+  size_t size = arena->size + arena->overflow_size;
+  arena->overflow_size = 0;
+  char *block = (char *)malloc(size);
+  if (block == NULL)
+    return;
+  free(arena->block);
+  arena->block = block;
+  arena->size = size;
+}
+
+static inline void arena_destroy(arena_t *arena) {
+  for (void *data : arena->overflow)
+    free(data);
+  arena->overflow.clear();
+  arena->overflow_size = 0;
+  free(arena->block);
+  arena->block = NULL;
+  arena->size = 0;
+  arena->used = 0;
+}
+
+#endif
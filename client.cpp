@@ -1,20 +1,30 @@
+#include <algorithm>
 #include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <dlfcn.h>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <netdb.h>
 #include <netinet/tcp.h>
 #include <nvml.h>
 #include <pthread.h>
+#include <random>
+#include <semaphore.h>
+#include <set>
 #include <stdio.h>
 #include <string.h>
 #include <string>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <sys/un.h>
+#include <thread>
 #include <unistd.h>
 #include <unordered_map>
 #include <vector>
@@ -28,20 +38,143 @@
 #include <signal.h>
 #include <sys/mman.h>
 
+#include "allocator.h"
+#include "codegen/gen_api.h"
 #include "codegen/gen_client.h"
+#include "compress.h"
+#include "dedup.h"
+#include "snapshot.h"
+#include "transport.h"
+#include "virtual_handle.h"
+
+// where a waiting caller is woken once the reader thread sees its response.
+// each thread has at most one request in flight, so the slot is thread local.
+struct response_slot_t {
+  sem_t ready;
+  int error = 0;
+
+  response_slot_t() { sem_init(&ready, 0, 0); }
+  ~response_slot_t() { sem_destroy(&ready); }
+};
+
+static thread_local response_slot_t response_slot;
+
+// a managed allocation's host mirror, which sits at the same address as the
+// device memory it copies. the mirror is write-protected whenever it matches
+// the device; the first write to a page after that faults, and the handler
+// marks the page dirty and lets the write through. see unified_upload. it is
+// downloaded again, and write-protected, at sync points. see unified_download.
+typedef struct {
+  // what cudaMallocManaged allocated on the device. the mirror starts at the
+  // first page boundary in it and covers whole pages.
+  void *allocation;
+  size_t size;
+  // a flag per page, set by the segfault handler, which can't take
+  // unified_mutex.
+  std::unique_ptr<std::atomic<uint8_t>[]> dirty;
+  // a library call may have written it on a stream that hasn't been waited
+  // for yet. see unified_sync.
+  std::atomic<bool> pending;
+  // where the segfault handler finds it. see unified_slots.
+  int slot;
+} unified_t;
 
 typedef struct {
-  int connfd;
-  int read_request_id;
-  int active_response_id;
+  transport_t transport;
   int write_request_id;
   unsigned int write_request_op;
-  pthread_mutex_t read_mutex, write_mutex;
-  pthread_cond_t read_cond;
+  pthread_mutex_t write_mutex;
   struct iovec write_iov[128];
   int write_iov_count = 0;
 
-  std::unordered_map<void *, size_t> unified_devices;
+  // the request header and small fields are copied in here, back to back, so
+  // they go out as one piece of write_iov; larger fields are sent straight
+  // from the caller's buffers.
+  char write_inline[4096];
+  size_t write_inline_size = 0;
+
+  // set once rpc_stream_request has sent the head of the current request.
+  bool streamed = false;
+
+  // codec negotiated for large payloads, and the buffers they are compressed
+  // into (under write_mutex) and decompressed from (by the response reader).
+  // chunks alternate between two buffers, so one can be compressed into while
+  // the kernel may still be sending the other with MSG_ZEROCOPY.
+  int compress = COMPRESS_NONE;
+  uint32_t compress_header;
+  std::vector<char> compress_buf[2];
+  uint32_t compress_ticket[2];
+  std::vector<char> decompress_buf;
+
+  // transport ticket taken when the current request started; see
+  // rpc_finish_request.
+  uint32_t request_ticket;
+
+  // requests that don't need a response yet are buffered here and written to
+  // the server as a single batch frame. batch_cond is signalled under
+  // write_mutex when a batch is started, so the flusher thread can send it
+  // once it has been held batch_usec.
+  std::vector<char> batch;
+  uint32_t batch_ticket;
+  std::chrono::steady_clock::time_point batch_start;
+  pthread_cond_t batch_cond;
+
+  // set under write_mutex once a request the caller doesn't wait on is sent.
+  // the server holds the errors of those requests until a sync point, and
+  // cudaGetLastError has to ask for them while this is set.
+  bool deferred = false;
+
+  // responses are read by a dedicated thread per connection. it reads the
+  // response id, wakes the caller waiting on that id, and waits on
+  // response_done while the caller reads the rest of the response into its
+  // own buffers.
+  pthread_mutex_t pending_mutex;
+  std::unordered_map<int, response_slot_t *> pending;
+  sem_t response_done;
+  bool closed = false;
+
+  // bytes read off the socket ahead of the reader thread or the caller, so a
+  // small response arrives with one recv. whoever currently owns the socket
+  // owns these too. unused on shared memory, which is already in memory.
+  std::vector<char> recv_buf;
+  size_t recv_offset = 0;
+  size_t recv_end = 0;
+
+  // extra sockets that large memcpy payloads are striped across. they belong
+  // to the session identified by session_id and are used by one transfer at
+  // a time, under stripe_mutex.
+  uint64_t session_id;
+  std::vector<int> data_fds;
+  pthread_mutex_t stripe_mutex;
+  std::vector<std::thread> stripe_writers;
+  std::vector<int> stripe_results;
+
+  // held across the two requests of a deduplicated copy, which the server
+  // pairs up by connection.
+  pthread_mutex_t dedup_mutex;
+
+  // the versions, device properties and attributes this server sent, which
+  // queries for them are answered from. device_snapshots is in the ordinals
+  // the server gave this client. a call that can change them clears
+  // snapshot_valid and the next query fetches them again.
+  pthread_mutex_t snapshot_mutex;
+  bool snapshot_valid = false;
+  snapshot_t snapshot;
+  std::vector<device_snapshot_t> device_snapshots;
+
+  // the device and stream capture mode the server's thread for this
+  // connection was last left in. see rpc_push_thread_state.
+  int server_device = 0;
+  int server_capture_mode = cudaStreamCaptureModeGlobal;
+
+  // the slabs cudaMalloc hands out blocks of, by the server's device ordinal.
+  // see rpc_cached_malloc.
+  pthread_mutex_t allocator_mutex;
+  std::map<int, allocator_t> allocators;
+
+  // the mirrors of managed allocations on this server, by address. entries
+  // are added and removed under unified_mutex.
+  std::map<void *, unified_t> unified_devices;
 } conn_t;
 
 pthread_mutex_t conn_mutex;
@@ -50,31 +183,112 @@ int nconns = 0;
 
 const char *DEFAULT_PORT = "14833";
 
+// a batch frame is sent as [BATCH_REQUEST_ID][size_t length][requests...] and
+// unpacked by the server in order.
+#define BATCH_REQUEST_ID -1
+
+// sent once on the primary connection as [SESSION_REQUEST_ID][session id], and
+// as the only message on each data connection as
+// [DATA_REQUEST_ID][session id][stripe].
+#define SESSION_REQUEST_ID -2
+#define DATA_REQUEST_ID -3
+
+// sent on tcp connections as [COMPRESS_REQUEST_ID][int codec][uint64 smallest
+// payload to compress]; the server answers [COMPRESS_REQUEST_ID][int codec],
+// COMPRESS_NONE if it declines.
+#define COMPRESS_REQUEST_ID -4
+
+// flush thresholds for batched requests, overridable with SCUDA_BATCH_SIZE
+// (bytes, 0 disables batching) and SCUDA_BATCH_USEC.
+static size_t batch_size = 64 * 1024;
+static long batch_usec = 1000;
+
+// number of data connections opened per server (SCUDA_DATA_CONNECTIONS) and the
+// smallest memcpy that is striped across them (SCUDA_STRIPE_SIZE).
+// SCUDA_DATA_INTERFACES optionally lists local addresses to bind them to.
+static int data_connections = 0;
+static size_t stripe_size = 8 * 1024 * 1024;
+
+// requests of at least this many bytes are sent with MSG_ZEROCOPY, overridable
+// with SCUDA_ZEROCOPY_SIZE (0 disables zero-copy sends).
+static size_t zerocopy_size = 1024 * 1024;
+
+// size of each shared-memory ring, set with SCUDA_SHM_SIZE. servers on this
+// host are reached over shared memory when they listen on the default path;
+// 0 turns that off, leaving only explicit shm:///path entries.
+static size_t shm_size = 16 * 1024 * 1024;
+
+// memcpy and fatbin payloads of at least this many bytes are compressed on tcp
+// connections, overridable with SCUDA_COMPRESS_SIZE (0 disables compression).
+static size_t compress_size = 64 * 1024;
+
+// host to device copies of at least this many bytes over tcp only send the
+// chunks the server hasn't seen, set with SCUDA_DEDUP_SIZE (0, the default,
+// disables deduplication).
+static size_t dedup_size = 0;
+
+// cudaMalloc hands out blocks of slabs this big, set with
+// SCUDA_ALLOCATOR_SLAB (0, the default, sends every cudaMalloc and cudaFree to
+// the server). slabs with nothing allocated from them are kept for reuse
+// until more than SCUDA_ALLOCATOR_CACHE bytes are idle.
+static size_t allocator_slab = 0;
+static size_t allocator_cache = 1024 * 1024 * 1024;
+
+// request fields up to this many bytes are copied into write_inline rather
+// than getting an iovec of their own.
+#define INLINE_WRITE_SIZE 256
+
+// every request starts with [int request id][unsigned int op].
+#define REQUEST_HEADER_SIZE (sizeof(int) + sizeof(unsigned int))
+
+// responses are read up to this many bytes at a time. reads at least this big
+// skip the buffer.
+#define RECV_BUFFER_SIZE (64 * 1024)
+
 static int init = 0;
 static jmp_buf catch_segfault;
 static void *faulting_address = nullptr;
+static size_t page_size = sysconf(_SC_PAGESIZE);
+
+// held while the mirror maps are searched or changed, never across a request.
+// unified_count lets the many calls that check for managed memory skip the
+// search when there is none.
+static pthread_mutex_t unified_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::atomic<int> unified_count{0};
+
+// the mirrors again, for the segfault handler, which can't take
+// unified_mutex. a slot is filled and cleared under it but read with atomics
+// only, up to unified_slots_used. a mirror needs a free slot to be made.
+#define UNIFIED_SLOTS 4096
+typedef struct {
+  std::atomic<uintptr_t> start;
+  std::atomic<size_t> size;
+  std::atomic<std::atomic<uint8_t> *> dirty;
+} unified_slot_t;
+
+static unified_slot_t unified_slots[UNIFIED_SLOTS];
+static std::atomic<int> unified_slots_used{0};
 
 static void segfault(int sig, siginfo_t *info, void *unused) {
   faulting_address = info->si_addr;
 
-  for (const auto &[ptr, sz] : conns[0].unified_devices) {
-    if ((uintptr_t)ptr <= (uintptr_t)faulting_address &&
-        (uintptr_t)faulting_address < ((uintptr_t)ptr + sz)) {
-      // ensure we assign memory as close to the faulting address as possible...
-      // by masking via the allocated unified memory size.
-      uintptr_t aligned = (uintptr_t)faulting_address & ~(sz - 1);
-
-      // Allocate memory at the faulting address
-      void *allocated =
-          mmap((void *)aligned, sz + (uintptr_t)faulting_address - aligned,
-               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
-      if (allocated == MAP_FAILED) {
-        perror("Failed to allocate memory at faulting address");
-        _exit(1);
-      }
+  // a write to a managed mirror since it was last made to match the device.
+  // the page is unprotected before it is marked, so an upload that protects
+  // it again in between leaves it dirty, and the write just faults again.
+  for (int i = 0; i < unified_slots_used; i++) {
+    uintptr_t start = unified_slots[i].start.load(std::memory_order_acquire);
+    uintptr_t offset = (uintptr_t)faulting_address - start;
+    if (start == 0 || offset >= unified_slots[i].size)
+      continue;
 
-      return;
+    size_t page = offset / page_size;
+    if (mprotect((void *)(start + page * page_size), page_size,
+                 PROT_READ | PROT_WRITE) < 0) {
+      perror("Failed to unprotect managed memory");
+      _exit(1);
     }
+    unified_slots[i].dirty.load()[page] = 1;
+    return;
   }
 
   // raise our original segfault handler
@@ -91,26 +305,145 @@ static void segfault(int sig, siginfo_t *info, void *unused) {
   raise(SIGSEGV);
 }
 
+// managed memory can live on any of the servers; index is only where to look
+// first.
+static conn_t *find_unified_pointer(const int index, void *arg) {
+  if (unified_count == 0)
+    return nullptr;
+
+  conn_t *owner = nullptr;
+  pthread_mutex_lock(&unified_mutex);
+  if (conns[index].unified_devices.count(arg))
+    owner = &conns[index];
+  for (int i = 0; i < nconns && owner == nullptr; i++)
+    if (conns[i].unified_devices.count(arg))
+      owner = &conns[i];
+  pthread_mutex_unlock(&unified_mutex);
+  return owner;
+}
+
 int is_unified_pointer(const int index, void *arg) {
-  auto &unified_devices = conns[index].unified_devices;
-  auto found = unified_devices.find(arg);
-  if (found != unified_devices.end())
+  if (find_unified_pointer(index, arg) != nullptr)
     return 1;
 
   return 0;
 }
 
+// uploads the dirty pages of a mirror, a run of adjacent ones at a time.
+// each run is protected again before it is read, so a write racing the upload
+// faults and goes out with the next one.
+static cudaError_t unified_upload(void *ptr, unified_t *unified,
+                                  size_t *copied) {
+  const size_t pages = unified->size / page_size;
+  size_t uploaded = 0;
+  for (size_t i = 0; i < pages;) {
+    if (!unified->dirty[i]) {
+      i++;
+      continue;
+    }
+
+    size_t start = i;
+    while (i < pages && unified->dirty[i].exchange(0))
+      i++;
+    char *run = (char *)ptr + start * page_size;
+    size_t length = (i - start) * page_size;
+    if (mprotect(run, length, PROT_READ) < 0)
+      return cudaErrorUnknown;
+
+    cudaError_t res = cudaMemcpy(run, run, length, cudaMemcpyHostToDevice);
+    if (res != cudaSuccess)
+      return res;
+    uploaded += length;
+  }
+
+  if (uploaded > 0)
+    std::cout << "Uploaded " << uploaded << " bytes of managed memory"
+              << std::endl;
+  *copied += uploaded;
+  return cudaSuccess;
+}
+
+// the device may have written anywhere, so the whole mirror comes back, after
+// the work queued on stream. it is writable only while the copy lands in it.
+static cudaError_t unified_download(void *ptr, unified_t *unified,
+                                    cudaStream_t stream, size_t *copied) {
+  if (mprotect(ptr, unified->size, PROT_READ | PROT_WRITE) < 0)
+    return cudaErrorUnknown;
+
+  cudaError_t res = cudaMemcpyAsync(ptr, ptr, unified->size,
+                                    cudaMemcpyDeviceToHost, stream);
+  for (size_t i = 0; i < unified->size / page_size; i++)
+    unified->dirty[i] = 0;
+  if (mprotect(ptr, unified->size, PROT_READ) < 0)
+    return cudaErrorUnknown;
+  if (res != cudaSuccess)
+    return res;
+
+  std::cout << "Downloaded " << unified->size << " bytes of managed memory"
+            << std::endl;
+  *copied += unified->size;
+  return cudaSuccess;
+}
+
+// gets the managed memory in [ptr, ptr + size) ready for a request that sends
+// or receives it while it holds a connection. the kernel fails on protected
+// pages with EFAULT rather than faulting, so pages about to be written are
+// marked dirty and made writable here. the application has to do the same
+// before it hands managed memory to a system call that writes to it, by
+// writing to the pages itself; see the README.
+int unified_prepare(const void *ptr, const size_t size, const bool write) {
+  if (unified_count == 0 || size == 0)
+    return 0;
+
+  uintptr_t start = (uintptr_t)ptr, end = start + size;
+  std::vector<std::pair<void *, unified_t *>> mirrors;
+  pthread_mutex_lock(&unified_mutex);
+  for (int i = 0; i < nconns; i++) {
+    auto it = conns[i].unified_devices.upper_bound((void *)ptr);
+    if (it != conns[i].unified_devices.begin())
+      --it;
+    for (; it != conns[i].unified_devices.end() &&
+           (uintptr_t)it->first < end;
+         ++it)
+      if ((uintptr_t)it->first + it->second.size > start)
+        mirrors.push_back({it->first, &it->second});
+  }
+  pthread_mutex_unlock(&unified_mutex);
+
+  if (!write)
+    return 0;
+
+  // unprotected before they are marked, as in the segfault handler.
+  for (auto &[base, unified] : mirrors) {
+    size_t first = (std::max(start, (uintptr_t)base) - (uintptr_t)base) /
+                   page_size;
+    size_t last = (std::min(end, (uintptr_t)base + unified->size) -
+                   (uintptr_t)base + page_size - 1) /
+                  page_size;
+    if (mprotect((char *)base + first * page_size, (last - first) * page_size,
+                 PROT_READ | PROT_WRITE) < 0)
+      return -1;
+    for (size_t i = first; i < last; i++)
+      unified->dirty[i] = 1;
+  }
+  return 0;
+}
+
 int maybe_copy_unified_arg(const int index, void *arg,
                            enum cudaMemcpyKind kind) {
-  auto &unified_devices = conns[index].unified_devices;
-  auto found = unified_devices.find(arg);
-  if (found != unified_devices.end()) {
+  conn_t *owner = find_unified_pointer(index, arg);
+  if (owner != nullptr) {
+    auto found = owner->unified_devices.find(arg);
     std::cout << "found unified arg pointer; copying..." << std::endl;
 
-    void *ptr = found->first;
-    size_t size = found->second;
-
-    cudaError_t res = cudaMemcpy(ptr, ptr, size, kind);
+    // after a call, the mirror only comes back at the next sync point: the
+    // call may be queued on a stream the application hasn't waited for yet.
+    size_t copied = 0;
+    cudaError_t res = cudaSuccess;
+    if (kind == cudaMemcpyDeviceToHost)
+      found->second.pending = true;
+    else
+      res = unified_upload(found->first, &found->second, &copied);
 
     if (res != cudaSuccess) {
       std::cerr << "cudaMemcpy failed: " << cudaGetErrorString(res)
@@ -118,13 +451,39 @@ int maybe_copy_unified_arg(const int index, void *arg,
 
       return -1;
     } else {
-      std::cout << "Successfully copied " << size << " bytes" << std::endl;
+      std::cout << "Successfully copied " << copied << " bytes" << std::endl;
     }
   }
 
   return 0;
 }
 
+// at a sync point, brings back the mirrors library calls may have written.
+// only a device sync has waited for every stream; after a stream sync the
+// call may have been on another one, so they stay pending and come back
+// again at the next sync.
+int unified_sync(const bool device) {
+  if (unified_count == 0)
+    return 0;
+
+  std::vector<std::pair<void *, unified_t *>> mirrors;
+  pthread_mutex_lock(&unified_mutex);
+  for (int i = 0; i < nconns; i++)
+    for (auto &[ptr, unified] : conns[i].unified_devices)
+      if (unified.pending)
+        mirrors.push_back({ptr, &unified});
+  pthread_mutex_unlock(&unified_mutex);
+
+  size_t copied = 0;
+  for (auto &[ptr, unified] : mirrors) {
+    if (device)
+      unified->pending = false;
+    if (unified_download(ptr, unified, 0, &copied) != cudaSuccess)
+      return -1;
+  }
+  return 0;
+}
+
 static void set_segfault_handlers() {
   if (init > 0) {
     return;
@@ -145,6 +504,259 @@ static void set_segfault_handlers() {
   init = 1;
 }
 
+// like transport_read, but served from the bytes already read ahead where
+// possible. large reads go straight into data once those are used up.
+static ssize_t rpc_recv(const int index, void *data, const size_t size) {
+  conn_t *conn = &conns[index];
+  if (conn->recv_buf.empty())
+    return transport_read(&conn->transport, data, size);
+
+  size_t copied = 0;
+  while (copied < size) {
+    if (conn->recv_offset == conn->recv_end) {
+      if (size - copied >= RECV_BUFFER_SIZE) {
+        ssize_t n = transport_read(&conn->transport, (char *)data + copied,
+                                   size - copied);
+        if (n < 0)
+          return -1;
+        return copied + n;
+      }
+
+      ssize_t n = recv(conn->transport.fd, conn->recv_buf.data(),
+                       conn->recv_buf.size(), 0);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        return -1;
+      if (n == 0)
+        break;
+      conn->recv_offset = 0;
+      conn->recv_end = n;
+    }
+
+    size_t n = std::min(size - copied, conn->recv_end - conn->recv_offset);
+    memcpy((char *)data + copied, conn->recv_buf.data() + conn->recv_offset,
+           n);
+    conn->recv_offset += n;
+    copied += n;
+  }
+  return copied;
+}
+
+static void rpc_read_responses(const int index) {
+  int response_id;
+  while (rpc_recv(index, &response_id, sizeof(int)) == sizeof(int)) {
+    if (pthread_mutex_lock(&conns[index].pending_mutex) < 0)
+      break;
+    auto found = conns[index].pending.find(response_id);
+    response_slot_t *slot = nullptr;
+    if (found != conns[index].pending.end()) {
+      slot = found->second;
+      conns[index].pending.erase(found);
+    }
+    pthread_mutex_unlock(&conns[index].pending_mutex);
+
+    // without a waiter we don't know how long the response is.
+    if (slot == nullptr) {
+      std::cerr << "Unexpected response id " << response_id << std::endl;
+      break;
+    }
+
+    sem_post(&slot->ready);
+    while (sem_wait(&conns[index].response_done) < 0 && errno == EINTR)
+      ;
+  }
+
+  // the connection is gone; fail everyone still waiting on it.
+  pthread_mutex_lock(&conns[index].pending_mutex);
+  conns[index].closed = true;
+  for (const auto &[id, slot] : conns[index].pending) {
+    slot->error = 1;
+    sem_post(&slot->ready);
+  }
+  conns[index].pending.clear();
+  pthread_mutex_unlock(&conns[index].pending_mutex);
+}
+
+// open the data connections for conns[index] and attach them to its session.
+static int rpc_connect_data(const int index, const addrinfo *res,
+                            const std::vector<std::string> &interfaces) {
+  int session_request_id = SESSION_REQUEST_ID;
+  std::random_device random;
+  conns[index].session_id = ((uint64_t)random() << 32) | random();
+  struct iovec session[2] = {{&session_request_id, sizeof(int)},
+                             {&conns[index].session_id, sizeof(uint64_t)}};
+  if (transport_writev(&conns[index].transport, session, 2, 0, NULL) < 0)
+    return -1;
+
+  for (int i = 0; i < data_connections; i++) {
+    int flag = 1;
+    int sockfd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (sockfd == -1 ||
+        setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, (char *)&flag,
+                   sizeof(int)) < 0)
+      return -1;
+
+    if (!interfaces.empty()) {
+      sockaddr_in local;
+      memset(&local, 0, sizeof(local));
+      local.sin_family = AF_INET;
+      if (inet_pton(AF_INET, interfaces[i % interfaces.size()].c_str(),
+                    &local.sin_addr) != 1 ||
+          bind(sockfd, (sockaddr *)&local, sizeof(local)) < 0) {
+        std::cerr << "Binding data connection to "
+                  << interfaces[i % interfaces.size()]
+                  << " failed: " << strerror(errno) << std::endl;
+        return -1;
+      }
+    }
+
+    int data_request_id = DATA_REQUEST_ID;
+    if (connect(sockfd, res->ai_addr, res->ai_addrlen) < 0 ||
+        write(sockfd, &data_request_id, sizeof(int)) < 0 ||
+        write(sockfd, &conns[index].session_id, sizeof(uint64_t)) < 0 ||
+        write(sockfd, &i, sizeof(int)) < 0)
+      return -1;
+    conns[index].data_fds.push_back(sockfd);
+  }
+  return 0;
+}
+
+// ask the server to compress large payloads on conns[index]. this runs before
+// the reader thread starts, so the answer is read here.
+static int rpc_negotiate_compression(const int index) {
+  int request_id = COMPRESS_REQUEST_ID;
+  int codec = COMPRESS_LZ4;
+  uint64_t size = compress_size;
+  struct iovec request[3] = {{&request_id, sizeof(int)},
+                             {&codec, sizeof(int)},
+                             {&size, sizeof(uint64_t)}};
+  if (transport_writev(&conns[index].transport, request, 3, 0, NULL) < 0 ||
+      rpc_recv(index, &request_id, sizeof(int)) != sizeof(int) ||
+      rpc_recv(index, &codec, sizeof(int)) != sizeof(int) ||
+      request_id != COMPRESS_REQUEST_ID)
+    return -1;
+  conns[index].compress = codec == COMPRESS_LZ4 ? codec : COMPRESS_NONE;
+  return 0;
+}
+
+static int rpc_init_conn(const int index, const transport_kind_t kind,
+                         const int sockfd) {
+  conns[index] = {};
+  transport_init(&conns[index].transport, kind, sockfd, zerocopy_size);
+  conns[index].write_mutex = PTHREAD_MUTEX_INITIALIZER;
+  conns[index].pending_mutex = PTHREAD_MUTEX_INITIALIZER;
+  conns[index].stripe_mutex = PTHREAD_MUTEX_INITIALIZER;
+  conns[index].dedup_mutex = PTHREAD_MUTEX_INITIALIZER;
+  conns[index].snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+  conns[index].allocator_mutex = PTHREAD_MUTEX_INITIALIZER;
+  if (kind != TRANSPORT_SHM)
+    conns[index].recv_buf.resize(RECV_BUFFER_SIZE);
+
+  // batch_start is a steady_clock time, so the flusher waits on that clock.
+  pthread_condattr_t attr;
+  if (pthread_condattr_init(&attr) != 0 ||
+      pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) != 0 ||
+      pthread_cond_init(&conns[index].batch_cond, &attr) != 0)
+    return -1;
+  pthread_condattr_destroy(&attr);
+  return sem_init(&conns[index].response_done, 0, 0);
+}
+
+static int rpc_flush_batch(const int index);
+
+// sends a batch that has been held batch_usec, so an async request that
+// nothing follows doesn't wait for the next sync point. it stops once a flush
+// fails, since the connection is gone by then.
+static void rpc_flush_batches(const int index) {
+  conn_t *conn = &conns[index];
+  if (pthread_mutex_lock(&conn->write_mutex) < 0)
+    return;
+  for (;;) {
+    if (conn->batch.empty()) {
+      pthread_cond_wait(&conn->batch_cond, &conn->write_mutex);
+      continue;
+    }
+
+    auto deadline = conn->batch_start + std::chrono::microseconds(batch_usec);
+    if (std::chrono::steady_clock::now() >= deadline) {
+      if (rpc_flush_batch(index) < 0)
+        break;
+      continue;
+    }
+
+    auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline.time_since_epoch())
+                    .count();
+    struct timespec until = {(time_t)(nsec / 1000000000),
+                             (long)(nsec % 1000000000)};
+    pthread_cond_timedwait(&conn->batch_cond, &conn->write_mutex, &until);
+  }
+  pthread_mutex_unlock(&conn->write_mutex);
+}
+
+static void rpc_start_reader(const int index) {
+  std::thread reader_thread(rpc_read_responses, index);
+  reader_thread.detach();
+  if (batch_size > 0) {
+    std::thread flusher_thread(rpc_flush_batches, index);
+    flusher_thread.detach();
+  }
+}
+
+static int connect_unix(const char *path) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+  int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sockfd == -1)
+    return -1;
+  if (connect(sockfd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(sockfd);
+    return -1;
+  }
+  return sockfd;
+}
+
+// connect to a server on this host over the unix socket at path.
+static int rpc_open_unix(const char *path) {
+  int sockfd = connect_unix(path);
+  if (sockfd < 0)
+    return -1;
+  if (rpc_init_conn(nconns, TRANSPORT_UNIX, sockfd) < 0) {
+    close(sockfd);
+    return -1;
+  }
+
+  rpc_start_reader(nconns++);
+  return 0;
+}
+
+// like rpc_open_unix, but the socket only hands the server a shared-memory
+// region that all traffic goes through.
+static int rpc_open_shm(const char *path) {
+  int sockfd = connect_unix(path);
+  if (sockfd < 0)
+    return -1;
+  if (rpc_init_conn(nconns, TRANSPORT_SHM, sockfd) < 0 ||
+      shm_create(&conns[nconns].transport.shm, sockfd,
+                 shm_size > 0 ? shm_size : 16 * 1024 * 1024) < 0) {
+    shm_close(&conns[nconns].transport.shm);
+    close(sockfd);
+    return -1;
+  }
+
+  rpc_start_reader(nconns++);
+  return 0;
+}
+
+static bool is_local_host(const char *host) {
+  return strcmp(host, "localhost") == 0 || strcmp(host, "0.0.0.0") == 0 ||
+         strncmp(host, "127.", 4) == 0;
+}
+
 int rpc_open() {
   set_segfault_handlers();
 
@@ -165,12 +777,64 @@ int rpc_open() {
     std::exit(1);
   }
 
+  char *p = getenv("SCUDA_BATCH_SIZE");
+  if (p != NULL)
+    batch_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_BATCH_USEC");
+  if (p != NULL)
+    batch_usec = strtol(p, NULL, 10);
+  p = getenv("SCUDA_DATA_CONNECTIONS");
+  if (p != NULL)
+    data_connections = atoi(p);
+  p = getenv("SCUDA_STRIPE_SIZE");
+  if (p != NULL)
+    stripe_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_ZEROCOPY_SIZE");
+  if (p != NULL)
+    zerocopy_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_SHM_SIZE");
+  if (p != NULL)
+    shm_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_COMPRESS_SIZE");
+  if (p != NULL)
+    compress_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_DEDUP_SIZE");
+  if (p != NULL)
+    dedup_size = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_ALLOCATOR_SLAB");
+  if (p != NULL)
+    allocator_slab = strtoul(p, NULL, 10);
+  p = getenv("SCUDA_ALLOCATOR_CACHE");
+  if (p != NULL)
+    allocator_cache = strtoul(p, NULL, 10);
+
+  std::vector<std::string> interfaces;
+  p = getenv("SCUDA_DATA_INTERFACES");
+  if (p != NULL) {
+    char *interface_list = strdup(p);
+    char *interface;
+    while ((interface = strsep(&interface_list, ",")))
+      interfaces.push_back(interface);
+  }
+
   char *server_ip = strdup(server_ips);
   char *token;
   while ((token = strsep(&server_ip, ","))) {
     char *host;
     char *port;
 
+    // unix:///path and shm:///path reach a server on this host.
+    bool is_unix = strncmp(token, "unix://", 7) == 0;
+    bool is_shm = strncmp(token, "shm://", 6) == 0;
+    if (is_unix || is_shm) {
+      if ((is_unix ? rpc_open_unix(token + 7) : rpc_open_shm(token + 6)) < 0) {
+        std::cerr << "Connecting to " << token
+                  << " failed: " << strerror(errno) << std::endl;
+        exit(1);
+      }
+      continue;
+    }
+
     // Split the string into IP address and port
     char *colon = strchr(token, ':');
     if (colon == NULL) {
@@ -182,6 +846,14 @@ int rpc_open() {
       port = colon + 1;
     }
 
+    // a server on this host also listens on a unix socket for shared-memory
+    // clients; use it if it's there and fall back to tcp otherwise.
+    if (shm_size > 0 && is_local_host(host)) {
+      std::string shm_path = std::string("/tmp/scuda-") + port + ".sock";
+      if (rpc_open_shm(shm_path.c_str()) == 0)
+        continue;
+    }
+
     addrinfo hints, *res;
     memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_INET;
@@ -207,14 +879,25 @@ int rpc_open() {
       exit(1);
     }
 
-    conns[nconns++] = {sockfd,
-                       0,
-                       0,
-                       0,
-                       0,
-                       PTHREAD_MUTEX_INITIALIZER,
-                       PTHREAD_MUTEX_INITIALIZER,
-                       PTHREAD_COND_INITIALIZER};
+    if (rpc_init_conn(nconns, TRANSPORT_TCP, sockfd) < 0) {
+      std::cerr << "Error initializing semaphore." << std::endl;
+      exit(1);
+    }
+
+    if (compress_size > 0 && rpc_negotiate_compression(nconns) < 0) {
+      std::cerr << "Negotiating compression with " << host << " port " << port
+                << " failed." << std::endl;
+      exit(1);
+    }
+
+    if (data_connections > 0 &&
+        rpc_connect_data(nconns, res, interfaces) < 0) {
+      std::cerr << "Opening data connections to " << host << " port " << port
+                << " failed: " << strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    rpc_start_reader(nconns++);
   }
 
   if (pthread_mutex_unlock(&conn_mutex) < 0)
@@ -224,7 +907,14 @@ int rpc_open() {
   return 0;
 }
 
-int rpc_size() { return nconns; }
+// the number of servers, connecting to them first if need be.
+int rpc_size() {
+  if (rpc_open() < 0)
+    return 0;
+  return nconns;
+}
+
+static void rpc_push_thread_state(const int index);
 
 int rpc_start_request(const int index, const unsigned int op) {
   if (rpc_open() < 0 || pthread_mutex_lock(&conns[index].write_mutex) < 0) {
@@ -236,63 +926,267 @@ int rpc_start_request(const int index, const unsigned int op) {
     return -1;
   }
 
-  conns[index].write_iov_count = 2;
+  rpc_push_thread_state(index);
+
   conns[index].write_request_op = op;
+  memcpy(conns[index].write_inline + sizeof(int), &op, sizeof(unsigned int));
+  conns[index].write_inline_size = REQUEST_HEADER_SIZE;
+  conns[index].write_iov[0] = {conns[index].write_inline, REQUEST_HEADER_SIZE};
+  conns[index].write_iov_count = 1;
+  conns[index].streamed = false;
+  conns[index].request_ticket = transport_ticket(&conns[index].transport);
   return 0;
 }
 
+static int rpc_stream_request(const int index);
+
 int rpc_write(const int index, const void *data, const size_t size) {
-  conns[index].write_iov[conns[index].write_iov_count++] = {
-      const_cast<void *>(data), size};
+  conn_t *conn = &conns[index];
+  bool copy = size <= INLINE_WRITE_SIZE &&
+              conn->write_inline_size + size <= sizeof(conn->write_inline);
+
+  // a small field right after other inline bytes just extends their piece.
+  // the header of a streamed request is already out, so it can't grow.
+  if (copy && (conn->write_iov_count > 1 || !conn->streamed)) {
+    struct iovec *last = &conn->write_iov[conn->write_iov_count - 1];
+    char *end = conn->write_inline + conn->write_inline_size;
+    if ((char *)last->iov_base + last->iov_len == end) {
+      memcpy(end, data, size);
+      conn->write_inline_size += size;
+      last->iov_len += size;
+      return 0;
+    }
+  }
+
+  // a request with more pieces than write_iov holds goes out in parts.
+  if (conn->write_iov_count == sizeof(conn->write_iov) / sizeof(struct iovec) &&
+      rpc_stream_request(index) < 0)
+    return -1;
+
+  void *piece = const_cast<void *>(data);
+  if (copy) {
+    piece = conn->write_inline + conn->write_inline_size;
+    memcpy(piece, data, size);
+    conn->write_inline_size += size;
+  }
+  conn->write_iov[conn->write_iov_count++] = {piece, size};
   return 0;
 }
 
-int rpc_end_request(const int index) {
-  int write_request_id = ++(conns[index].write_request_id);
+// write out any batched requests. the caller must hold write_mutex.
+static int rpc_flush_batch(const int index) {
+  std::vector<char> &batch = conns[index].batch;
+  if (batch.empty())
+    return 0;
 
-  conns[index].write_iov[0] = {&write_request_id, sizeof(int)};
-  conns[index].write_iov[1] = {&conns[index].write_request_op,
-                               sizeof(unsigned int)};
+  int batch_request_id = BATCH_REQUEST_ID;
+  size_t length = batch.size();
+  struct iovec iov[3] = {{&batch_request_id, sizeof(int)},
+                         {&length, sizeof(size_t)},
+                         {batch.data(), length}};
+
+  if (transport_writev(&conns[index].transport, iov, 3, zerocopy_size,
+                       NULL) < 0)
+    return -1;
+  batch.clear();
+  conns[index].batch_ticket = transport_ticket(&conns[index].transport);
+  return 0;
+}
+
+// start a new batch. its buffer may still be going out with MSG_ZEROCOPY as
+// part of the last one. the caller must hold write_mutex.
+static int rpc_start_batch(const int index) {
+  if (transport_release(&conns[index].transport, conns[index].batch_ticket) <
+      0)
+    return -1;
+  conns[index].batch_start = std::chrono::steady_clock::now();
+  pthread_cond_signal(&conns[index].batch_cond);
+  return 0;
+}
+
+// send the current request. if flush is false the request may sit in the batch
+// until a later request needs a response or a threshold is hit.
+static int rpc_send_request(const int index, const bool flush) {
+  std::vector<char> &batch = conns[index].batch;
+
+  // the head of a streamed request is already out; the rest follows it.
+  if (conns[index].streamed) {
+    if (transport_writev(&conns[index].transport, conns[index].write_iov + 1,
+                         conns[index].write_iov_count - 1, zerocopy_size,
+                         NULL) < 0)
+      return -1;
+    return 0;
+  }
+
+  size_t size = 0;
+  for (int i = 0; i < conns[index].write_iov_count; i++)
+    size += conns[index].write_iov[i].iov_len;
+
+  // requests that don't fit in the batch are written straight from the
+  // caller's buffers, after everything queued before them.
+  if ((flush && batch.empty()) || batch.size() + size > batch_size) {
+    if (rpc_flush_batch(index) < 0 ||
+        transport_writev(&conns[index].transport, conns[index].write_iov,
+                         conns[index].write_iov_count, zerocopy_size,
+                         NULL) < 0)
+      return -1;
+    return 0;
+  }
+
+  if (batch.empty() && rpc_start_batch(index) < 0)
+    return -1;
+  for (int i = 0; i < conns[index].write_iov_count; i++)
+    batch.insert(batch.end(), (char *)conns[index].write_iov[i].iov_base,
+                 (char *)conns[index].write_iov[i].iov_base +
+                     conns[index].write_iov[i].iov_len);
+
+  if (flush || batch.size() >= batch_size ||
+      std::chrono::steady_clock::now() - conns[index].batch_start >=
+          std::chrono::microseconds(batch_usec))
+    return rpc_flush_batch(index);
+  return 0;
+}
+
+static int rpc_finish_request(const int index, const bool flush) {
+  int write_request_id = conns[index].streamed
+                             ? conns[index].write_request_id
+                             : ++(conns[index].write_request_id);
+
+  // a caller that waits on the response has to be registered before the
+  // request goes out, otherwise the response could beat it to the reader.
+  if (flush) {
+    if (pthread_mutex_lock(&conns[index].pending_mutex) < 0)
+      return -1;
+    bool closed = conns[index].closed;
+    if (!closed) {
+      response_slot.error = 0;
+      conns[index].pending[write_request_id] = &response_slot;
+    }
+    if (pthread_mutex_unlock(&conns[index].pending_mutex) < 0 || closed) {
+      pthread_mutex_unlock(&conns[index].write_mutex);
+      return -1;
+    }
+  }
+
+  memcpy(conns[index].write_inline, &write_request_id, sizeof(int));
+  if (!flush)
+    conns[index].deferred = true;
 
   // write the request to the server
-  if (writev(conns[index].connfd, conns[index].write_iov,
-             conns[index].write_iov_count) < 0 ||
-      pthread_mutex_unlock(&conns[index].write_mutex) < 0)
+  int sent = rpc_send_request(index, flush);
+  uint32_t started = conns[index].request_ticket;
+  uint32_t ticket = transport_ticket(&conns[index].transport);
+  conns[index].compress_ticket[0] = ticket;
+  conns[index].compress_ticket[1] = ticket;
+  if (pthread_mutex_unlock(&conns[index].write_mutex) < 0)
+    return -1;
+
+  // the caller may change its buffers once a request it doesn't wait on
+  // returns, so if any of them went out with MSG_ZEROCOPY, wait until the
+  // kernel is done with them. a response means the server has everything.
+  if (sent == 0 && !flush && ticket != started &&
+      transport_release(&conns[index].transport, ticket) < 0)
+    sent = -1;
+  if (sent < 0) {
+    // take the slot back. if the reader already failed it, consume the post so
+    // the next wait on this thread doesn't return early.
+    if (flush) {
+      pthread_mutex_lock(&conns[index].pending_mutex);
+      if (conns[index].pending.erase(write_request_id) == 0)
+        while (sem_wait(&response_slot.ready) < 0 && errno == EINTR)
+          ;
+      pthread_mutex_unlock(&conns[index].pending_mutex);
+    }
     return -1;
+  }
   return write_request_id;
 }
 
+// end a request that the caller won't wait on; it may be batched.
+int rpc_end_request(const int index) {
+  return rpc_finish_request(index, false);
+}
+
 int rpc_wait_for_response(const int index) {
-  int wait_for_request_id = rpc_end_request(index);
+  int wait_for_request_id = rpc_finish_request(index, true);
   if (wait_for_request_id < 0)
     return -1;
 
-  if (pthread_mutex_lock(&conns[index].read_mutex) < 0)
+  // the reader thread posts our slot once it has read our response id; from
+  // then on we own the socket until rpc_end_response.
+  while (sem_wait(&response_slot.ready) < 0 && errno == EINTR)
+    ;
+  if (response_slot.error)
     return -1;
+  return 0;
+}
 
-  // wait for the response
-  while (true) {
-    while (conns[index].active_response_id != wait_for_request_id &&
-           conns[index].active_response_id != 0)
-      pthread_cond_wait(&conns[index].read_cond, &conns[index].read_mutex);
+// send what has been written of the current request so far, so a large
+// payload can go out while the caller is still producing it. the request keeps
+// its id and the rest of it is sent when it ends. on failure write_mutex is
+// released, since the caller gives up on the request.
+static int rpc_stream_request(const int index) {
+  int start = 1;
+  if (!conns[index].streamed) {
+    conns[index].streamed = true;
+    conns[index].write_request_id++;
+    memcpy(conns[index].write_inline, &conns[index].write_request_id,
+           sizeof(int));
+    start = 0;
+  }
 
-    // we currently own mutex. if active response id is 0, read the response id
-    if (conns[index].active_response_id == 0) {
-      if (read(conns[index].connfd, &conns[index].active_response_id,
-               sizeof(int)) < 0) {
-        pthread_mutex_unlock(&conns[index].read_mutex);
-        return -1;
-      }
+  if ((start == 0 && rpc_flush_batch(index) < 0) ||
+      transport_writev(&conns[index].transport,
+                       conns[index].write_iov + start,
+                       conns[index].write_iov_count - start, zerocopy_size,
+                       NULL) < 0) {
+    pthread_mutex_unlock(&conns[index].write_mutex);
+    return -1;
+  }
+  conns[index].write_iov_count = 1;
+  conns[index].write_inline_size = REQUEST_HEADER_SIZE;
+  return 0;
+}
 
-      if (conns[index].active_response_id != wait_for_request_id) {
-        pthread_cond_broadcast(&conns[index].read_cond);
-        continue;
-      }
+// write a payload that is compressed on the wire if the connection negotiated
+// it and the payload is large enough. every chunk but the last is sent right
+// away, so compressing the next chunk overlaps the socket sending this one;
+// the last goes out with the rest of the request. a request carries at most
+// one compressed payload.
+int rpc_write_compressed(const int index, const void *data, const size_t size) {
+  if (conns[index].compress == COMPRESS_NONE || size < compress_size)
+    return rpc_write(index, data, size);
+
+  for (size_t offset = 0; offset < size; offset += COMPRESS_CHUNK) {
+    size_t n = std::min((size_t)COMPRESS_CHUNK, size - offset);
+    int b = offset / COMPRESS_CHUNK % 2;
+    std::vector<char> &buf = conns[index].compress_buf[b];
+    if (transport_release(&conns[index].transport,
+                          conns[index].compress_ticket[b]) < 0)
+      return -1;
+    buf.resize(COMPRESS_CHUNK);
+
+    // a chunk has to shrink by at least an eighth to be worth it; past the
+    // first one that doesn't, the rest is sent as is.
+    size_t length =
+        compress_lz4((char *)data + offset, n, buf.data(), n - n / 8);
+    if (length == 0) {
+      conns[index].compress_header = COMPRESS_STORED;
+      rpc_write(index, &conns[index].compress_header, sizeof(uint32_t));
+      return rpc_write(index, (char *)data + offset, size - offset);
     }
 
-    conns[index].active_response_id = 0;
-    return 0;
+    conns[index].compress_header = length;
+    rpc_write(index, &conns[index].compress_header, sizeof(uint32_t));
+    rpc_write(index, buf.data(), length);
+    if (offset + n < size) {
+      if (rpc_stream_request(index) < 0)
+        return -1;
+      conns[index].compress_ticket[b] =
+          transport_ticket(&conns[index].transport);
+    }
   }
+  return 0;
 }
 
 int rpc_read(const int index, void *data, size_t size) {
@@ -300,10 +1194,10 @@ int rpc_read(const int index, void *data, size_t size) {
     // temp buffer to discard data
     char tempBuffer[256];
     while (size > 0) {
-      ssize_t bytesRead = read(conns[index].connfd, tempBuffer,
-                               std::min(size, sizeof(tempBuffer)));
+      ssize_t bytesRead =
+          rpc_recv(index, tempBuffer, std::min(size, sizeof(tempBuffer)));
       if (bytesRead < 0) {
-        pthread_mutex_unlock(&conns[index].read_mutex);
+        sem_post(&conns[index].response_done);
         return -1; // error if reading fails
       }
       size -= bytesRead;
@@ -311,52 +1205,733 @@ int rpc_read(const int index, void *data, size_t size) {
     return size;
   }
 
-  ssize_t n = recv(conns[index].connfd, data, size, MSG_WAITALL);
+  ssize_t n = rpc_recv(index, data, size);
   if (n < 0)
-    pthread_mutex_unlock(&conns[index].read_mutex);
+    sem_post(&conns[index].response_done);
   return n;
 }
 
-void allocate_unified_mem_pointer(const int index, void *dev_ptr, size_t size) {
-  // allocate new space for pointer mapping
-  conns[index].unified_devices.insert({dev_ptr, size});
+// read a payload written with rpc_write_compressed on the server.
+int rpc_read_compressed(const int index, void *data, const size_t size) {
+  if (conns[index].compress == COMPRESS_NONE || size < compress_size)
+    return rpc_read(index, data, size);
+
+  std::vector<char> &buf = conns[index].decompress_buf;
+  for (size_t offset = 0; offset < size; offset += COMPRESS_CHUNK) {
+    size_t n = std::min((size_t)COMPRESS_CHUNK, size - offset);
+    uint32_t length;
+    if (rpc_read(index, &length, sizeof(uint32_t)) < 0)
+      return -1;
+    if (length == COMPRESS_STORED)
+      return rpc_read(index, (char *)data + offset, size - offset);
+
+    if (length > n) {
+      sem_post(&conns[index].response_done);
+      return -1;
+    }
+    buf.resize(length);
+    if (rpc_read(index, buf.data(), length) < 0)
+      return -1;
+    if (decompress_lz4(buf.data(), length, (char *)data + offset, n) !=
+        (ssize_t)n) {
+      std::cerr << "Corrupt compressed payload." << std::endl;
+      sem_post(&conns[index].response_done);
+      return -1;
+    }
+  }
+  return size;
+}
+
+// returns how many data connections a transfer of size bytes is striped
+// across, or 0 if it should go inline on the primary connection. a non-zero
+// result holds the data connections until rpc_end_stripes.
+int rpc_start_stripes(const int index, const size_t size) {
+  if (conns[index].data_fds.empty() || size < stripe_size ||
+      pthread_mutex_lock(&conns[index].stripe_mutex) < 0)
+    return 0;
+  return conns[index].data_fds.size();
 }
 
-cudaError_t cuda_memcpy_unified_ptrs(const int index, cudaMemcpyKind kind) {
-  for (const auto &[ptr, sz] : conns[index].unified_devices) {
-    size_t size = reinterpret_cast<size_t>(sz);
+// stripe i covers [size * i / stripes, size * (i + 1) / stripes).
+static size_t stripe_offset(const size_t size, const int i,
+                            const int stripes) {
+  return size * i / stripes;
+}
 
-    // ptr is the same on both host/device
-    cudaError_t res = cudaMemcpy(ptr, ptr, size, kind);
+// start sending data across the data connections. this doesn't block, so the
+// request that the server reads the stripes for can be sent in the meantime.
+int rpc_write_stripes(const int index, const void *data, const size_t size,
+                      const int stripes) {
+  conns[index].stripe_results.assign(stripes, 0);
+  for (int i = 0; i < stripes; i++)
+    conns[index].stripe_writers.emplace_back([=]() {
+      size_t offset = stripe_offset(size, i, stripes);
+      size_t end = stripe_offset(size, i + 1, stripes);
+      while (offset < end) {
+        ssize_t n = send(conns[index].data_fds[i], (char *)data + offset,
+                         end - offset, MSG_NOSIGNAL);
+        if (n < 0 && errno != EINTR) {
+          conns[index].stripe_results[i] = -1;
+          return;
+        }
+        if (n > 0)
+          offset += n;
+      }
+    });
+  return 0;
+}
+
+int rpc_read_stripes(const int index, void *data, const size_t size,
+                     const int stripes) {
+  std::vector<int> results(stripes, 0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < stripes; i++)
+    readers.emplace_back([&, i]() {
+      size_t offset = stripe_offset(size, i, stripes);
+      size_t length = stripe_offset(size, i + 1, stripes) - offset;
+      if (recv(conns[index].data_fds[i], (char *)data + offset, length,
+               MSG_WAITALL) != (ssize_t)length)
+        results[i] = -1;
+    });
+
+  int ret = 0;
+  for (int i = 0; i < stripes; i++) {
+    readers[i].join();
+    if (results[i] < 0)
+      ret = -1;
+  }
+  return ret;
+}
+
+// wait for any stripes still being written and release the data connections.
+int rpc_end_stripes(const int index, const int stripes) {
+  if (stripes == 0)
+    return 0;
+
+  int ret = 0;
+  for (auto &writer : conns[index].stripe_writers)
+    writer.join();
+  for (int result : conns[index].stripe_results)
+    if (result < 0)
+      ret = -1;
+  conns[index].stripe_writers.clear();
+  conns[index].stripe_results.clear();
+
+  if (pthread_mutex_unlock(&conns[index].stripe_mutex) < 0)
+    return -1;
+  return ret;
+}
+
+// returns 1 if a host to device copy of size bytes should be deduplicated, in
+// which case conns[index] is held for it until rpc_end_dedup.
+int rpc_start_dedup(const int index, const size_t size) {
+  if (dedup_size == 0 || size < dedup_size ||
+      conns[index].transport.kind != TRANSPORT_TCP ||
+      pthread_mutex_lock(&conns[index].dedup_mutex) < 0)
+    return 0;
+  return 1;
+}
+
+int rpc_end_dedup(const int index) {
+  if (pthread_mutex_unlock(&conns[index].dedup_mutex) < 0)
+    return -1;
+  return 0;
+}
+
+// how much device memory a managed allocation of size bytes needs, so that
+// its mirror can start on a page boundary and still cover whole pages.
+size_t unified_allocation_size(const size_t size) {
+  return (size + page_size - 1) / page_size * page_size + page_size;
+}
+
+// maps the host mirror of a managed allocation, matching the device memory it
+// starts out as. returns the address both share, or nullptr if the mirror
+// couldn't be placed there.
+void *allocate_unified_mem_pointer(const int index, void *allocation,
+                                   size_t size) {
+  uintptr_t start = ((uintptr_t)allocation + page_size - 1) & ~(page_size - 1);
+  size = (size + page_size - 1) / page_size * page_size;
+
+  void *ptr = mmap((void *)start, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1, 0);
+  if (ptr == MAP_FAILED)
+    return nullptr;
+  if (ptr != (void *)start || cudaMemset(ptr, 0, size) != cudaSuccess) {
+    munmap(ptr, size);
+    return nullptr;
+  }
+
+  pthread_mutex_lock(&unified_mutex);
+  int slot = 0;
+  while (slot < UNIFIED_SLOTS && unified_slots[slot].start != 0)
+    slot++;
+  if (slot == UNIFIED_SLOTS) {
+    pthread_mutex_unlock(&unified_mutex);
+    munmap(ptr, size);
+    return nullptr;
+  }
+
+  unified_t &unified = conns[index].unified_devices[ptr];
+  unified.allocation = allocation;
+  unified.size = size;
+  unified.dirty.reset(new std::atomic<uint8_t>[size / page_size]());
+  unified.pending = false;
+  unified.slot = slot;
+
+  // start goes in last, so the handler never sees a half-filled slot.
+  unified_slots[slot].size = size;
+  unified_slots[slot].dirty = unified.dirty.get();
+  unified_slots[slot].start.store((uintptr_t)ptr, std::memory_order_release);
+  if (slot >= unified_slots_used)
+    unified_slots_used = slot + 1;
+  unified_count++;
+  pthread_mutex_unlock(&unified_mutex);
+  return ptr;
+}
+
+// around a launch: what the host wrote goes up before it, and after it every
+// mirror comes back, once the launch is done. the requests are sent without
+// unified_mutex, so the mirrors are listed first.
+cudaError_t cuda_memcpy_unified_ptrs(const int index, cudaMemcpyKind kind,
+                                     cudaStream_t stream) {
+  if (unified_count == 0)
+    return cudaSuccess;
+
+  std::vector<std::pair<void *, unified_t *>> mirrors;
+  pthread_mutex_lock(&unified_mutex);
+  for (auto &[ptr, unified] : conns[index].unified_devices)
+    mirrors.push_back({ptr, &unified});
+  pthread_mutex_unlock(&unified_mutex);
+
+  size_t copied = 0;
+  for (auto &[ptr, unified] : mirrors) {
+    cudaError_t res = kind == cudaMemcpyHostToDevice
+                          ? unified_upload(ptr, unified, &copied)
+                          : unified_download(ptr, unified, stream, &copied);
     if (res != cudaSuccess)
       return res;
   }
   return cudaSuccess;
 }
 
-void maybe_free_unified_mem(const int index, void *ptr) {
-  for (const auto &[dev_ptr, sz] : conns[index].unified_devices) {
-    size_t size = reinterpret_cast<size_t>(sz);
+// unmaps the mirror of a managed allocation and returns the device memory to
+// free, which for anything else is ptr itself.
+void *maybe_free_unified_mem(const int index, void *ptr) {
+  if (unified_count == 0)
+    return ptr;
+
+  pthread_mutex_lock(&unified_mutex);
+  auto it = conns[index].unified_devices.find(ptr);
+  if (it == conns[index].unified_devices.end()) {
+    pthread_mutex_unlock(&unified_mutex);
+    return ptr;
+  }
 
-    if (dev_ptr == ptr) {
-      munmap(dev_ptr, size);
+  // start goes first, so the handler stops looking at the slot before the
+  // mirror goes away.
+  void *allocation = it->second.allocation;
+  unified_slots[it->second.slot].start = 0;
+  munmap(ptr, it->second.size);
+  conns[index].unified_devices.erase(it);
+  unified_count--;
+  pthread_mutex_unlock(&unified_mutex);
+  return allocation;
+}
+
+int rpc_end_response(const int index, void *result) {
+  // hand the socket back to the reader thread even if the read failed, so it
+  // notices the connection is gone and fails everyone else waiting on it.
+  ssize_t n = rpc_recv(index, result, sizeof(int));
+  if (sem_post(&conns[index].response_done) < 0 || n != sizeof(int))
+    return -1;
+  return 0;
+}
+
+// every device of every server, in SCUDA_SERVER order, as the connection
+// and the ordinal the server knows it by. the application's device ordinals
+// index this table.
+static std::vector<std::pair<int, int>> devices;
+static int ndevices = -1;
+static pthread_once_t devices_once = PTHREAD_ONCE_INIT;
+
+// set by cudaSetDevice and cudaThreadExchangeStreamCaptureMode, per thread
+// like the real thing. a server only hears about them with the next request
+// this thread sends it.
+static thread_local int current_device = 0;
+static thread_local int capture_mode = cudaStreamCaptureModeGlobal;
+
+// what cudaGetLastError returns on this thread.
+static thread_local cudaError_t last_error = cudaSuccess;
+
+// streams being captured, by any thread. while there are none, no stream is
+// capturing and cudaStreamIsCapturing doesn't have to ask.
+static pthread_mutex_t captures_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::set<uintptr_t> captures;
+
+// device memory and handles, from start to size, by the connection they were
+// created on. a handle is a region one byte long. identical servers can hand
+// out the same or overlapping ranges, so each connection keeps its own.
+static pthread_mutex_t regions_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::map<uintptr_t, size_t> regions[sizeof(conns) / sizeof(conn_t)];
+
+// one request for everything the snapshot holds, instead of one per query.
+// called with snapshot_mutex held.
+static int rpc_fetch_snapshot(const int index) {
+  conn_t *conn = &conns[index];
+  int count, result;
+
+  if (conn->snapshot_valid)
+    return 0;
+
+  if (rpc_start_request(index, RPC___scudaGetDeviceSnapshot) < 0 ||
+      rpc_wait_for_response(index) < 0 ||
+      rpc_read(index, &conn->snapshot, sizeof(snapshot_t)) < 0 ||
+      rpc_read(index, &count, sizeof(int)) < 0)
+    return -1;
+  conn->device_snapshots.resize(count);
+  if (rpc_read(index, conn->device_snapshots.data(),
+               count * sizeof(device_snapshot_t)) < 0 ||
+      rpc_end_response(index, &result) < 0)
+    return -1;
+
+  conn->snapshot_valid = true;
+  return 0;
+}
+
+// the device list comes with the first snapshot of every server.
+static void rpc_discover_devices() {
+  for (int i = 0; i < rpc_size(); i++) {
+    pthread_mutex_lock(&conns[i].snapshot_mutex);
+    int result = rpc_fetch_snapshot(i);
+    int count = conns[i].device_snapshots.size();
+    pthread_mutex_unlock(&conns[i].snapshot_mutex);
+    if (result < 0) {
+      std::cerr << "Listing the devices of server " << i << " failed."
+                << std::endl;
       return;
     }
+    for (int j = 0; j < count; j++)
+      devices.push_back({i, j});
   }
+  ndevices = devices.size();
 }
 
-int rpc_end_response(const int index, void *result) {
-  if (read(conns[index].connfd, result, sizeof(int)) < 0 ||
-      pthread_mutex_unlock(&conns[index].read_mutex) < 0)
+// -1 if the servers couldn't be reached.
+int rpc_device_count() {
+  pthread_once(&devices_once, rpc_discover_devices);
+  return ndevices;
+}
+
+int rpc_get_device() { return current_device; }
+
+void rpc_set_device(const int device) { current_device = device; }
+
+int rpc_exchange_capture_mode(const int mode) {
+  int previous = capture_mode;
+  capture_mode = mode;
+  return previous;
+}
+
+// the server runs all of a connection's requests on one thread, which every
+// thread of the application shares. a request goes out behind a
+// __scudaSetThreadState that puts that thread in the sending thread's device
+// and capture mode, whenever those differ from what the last request left.
+// the device is only set on the server of the current device; -1 leaves it.
+// called with write_mutex held.
+static void rpc_push_thread_state(const int index) {
+  conn_t *conn = &conns[index];
+  int device = -1;
+
+  // before the device list is in, every thread is on device 0.
+  if (current_device < ndevices && devices[current_device].first == index &&
+      devices[current_device].second != conn->server_device)
+    device = devices[current_device].second;
+  if (device < 0 && capture_mode == conn->server_capture_mode)
+    return;
+
+  // it has no response, so it can wait in the batch with the requests that
+  // follow it.
+  int request_id = ++conn->write_request_id;
+  unsigned int op = RPC___scudaSetThreadState;
+  char request[REQUEST_HEADER_SIZE + 2 * sizeof(int)];
+  memcpy(request, &request_id, sizeof(int));
+  memcpy(request + sizeof(int), &op, sizeof(unsigned int));
+  memcpy(request + REQUEST_HEADER_SIZE, &device, sizeof(int));
+  memcpy(request + REQUEST_HEADER_SIZE + sizeof(int), &capture_mode,
+         sizeof(int));
+  if (conn->batch.empty() && rpc_start_batch(index) < 0)
+    return;
+  conn->batch.insert(conn->batch.end(), request, request + sizeof(request));
+
+  if (device >= 0)
+    conn->server_device = device;
+  conn->server_capture_mode = capture_mode;
+}
+
+// folds the result of a runtime call into this thread's last error. like the
+// runtime, a stream or event that isn't done yet doesn't count as an error.
+// errors that stick to a context come back from every later call, so they
+// land here again after cudaGetLastError clears them.
+void rpc_record_error(const cudaError_t error) {
+  if (error != cudaSuccess && error != cudaErrorNotReady)
+    last_error = error;
+}
+
+// requests the client didn't wait on report their errors at the next sync
+// point, and a server holds them until then. while any may be outstanding,
+// cudaGetLastError and cudaPeekAtLastError are a sync point too: the server's
+// cudaGetLastError waits for the stream executors and hands over the first
+// deferred error, which lands in this thread's last error. the server keeps
+// one such error per connection, so the thread that asks first gets it.
+static void rpc_collect_deferred_error(const int index) {
+  cudaError_t result;
+  pthread_mutex_lock(&conns[index].write_mutex);
+  bool deferred = conns[index].deferred;
+  conns[index].deferred = false;
+  pthread_mutex_unlock(&conns[index].write_mutex);
+  if (!deferred)
+    return;
+  if (rpc_start_request(index, RPC_cudaGetLastError) < 0 ||
+      rpc_wait_for_response(index) < 0 ||
+      rpc_end_response(index, &result) < 0) {
+    last_error = cudaErrorDevicesUnavailable;
+    return;
+  }
+  rpc_record_error(result);
+}
+
+cudaError_t rpc_last_error(const bool clear) {
+  for (int i = 0; i < rpc_size(); i++)
+    rpc_collect_deferred_error(i);
+
+  cudaError_t error = last_error;
+  if (clear)
+    last_error = cudaSuccess;
+  return error;
+}
+
+void rpc_begin_capture(const void *stream) {
+  pthread_mutex_lock(&captures_mutex);
+  captures.insert((uintptr_t)stream);
+  pthread_mutex_unlock(&captures_mutex);
+}
+
+void rpc_end_capture(const void *stream) {
+  pthread_mutex_lock(&captures_mutex);
+  captures.erase((uintptr_t)stream);
+  pthread_mutex_unlock(&captures_mutex);
+}
+
+bool rpc_capturing() {
+  pthread_mutex_lock(&captures_mutex);
+  bool capturing = !captures.empty();
+  pthread_mutex_unlock(&captures_mutex);
+  return capturing;
+}
+
+// the connection of the current device, where anything that doesn't name a
+// device or handle goes.
+int rpc_current_conn() {
+  if (current_device < rpc_device_count())
+    return devices[current_device].first;
+  return 0;
+}
+
+// for calls that name a device: rewrite the ordinal to the server's own and
+// return that server's connection. ordinals that aren't devices, like
+// cudaCpuDeviceId, are left alone and go to the current device's server.
+int rpc_device_conn(int *device) {
+  if (*device < 0 || *device >= rpc_device_count())
+    return rpc_current_conn();
+  int index = devices[*device].first;
+  *device = devices[*device].second;
+  return index;
+}
+
+// for the second device of a peer call that went to index. a device on
+// another server can't be its peer, so it becomes an ordinal the server
+// rejects.
+void rpc_device_peer(const int index, int *device) {
+  if (*device < 0 || *device >= rpc_device_count())
+    return;
+  *device = devices[*device].first == index ? devices[*device].second : -1;
+}
+
+// the snapshot of one of the application's devices, with its server's
+// snapshot_mutex held, or nullptr if its server couldn't be reached.
+static const device_snapshot_t *rpc_lock_device_snapshot(const int device) {
+  const int index = devices[device].first;
+  const size_t ordinal = devices[device].second;
+
+  pthread_mutex_lock(&conns[index].snapshot_mutex);
+  if (rpc_fetch_snapshot(index) < 0 ||
+      ordinal >= conns[index].device_snapshots.size()) {
+    pthread_mutex_unlock(&conns[index].snapshot_mutex);
+    return nullptr;
+  }
+  return &conns[index].device_snapshots[ordinal];
+}
+
+static void rpc_unlock_device_snapshot(const int device) {
+  pthread_mutex_unlock(&conns[devices[device].first].snapshot_mutex);
+}
+
+// these answer from the snapshot, and return -1 if device isn't one of the
+// application's devices or its server couldn't be reached. values are only
+// written if the server's call succeeded, as the call itself would.
+int rpc_device_properties(const int device, cudaDeviceProp *prop,
+                          cudaError_t *result) {
+  if (device < 0 || device >= rpc_device_count())
+    return -1;
+  const device_snapshot_t *snapshot = rpc_lock_device_snapshot(device);
+  if (snapshot == nullptr)
     return -1;
+  *result = snapshot->prop_result;
+  if (*result == cudaSuccess)
+    *prop = snapshot->prop;
+  rpc_unlock_device_snapshot(device);
   return 0;
 }
 
+int rpc_device_attribute(const int device, const int attr, int *value,
+                         cudaError_t *result) {
+  if (device < 0 || device >= rpc_device_count() || attr < 0 ||
+      attr >= SNAPSHOT_ATTRIBUTES)
+    return -1;
+  const device_snapshot_t *snapshot = rpc_lock_device_snapshot(device);
+  if (snapshot == nullptr)
+    return -1;
+  *result = snapshot->attribute_results[attr];
+  if (*result == cudaSuccess)
+    *value = snapshot->attributes[attr];
+  rpc_unlock_device_snapshot(device);
+  return 0;
+}
+
+int rpc_cu_device_attribute(const int device, const int attr, int *value,
+                            CUresult *result) {
+  if (device < 0 || device >= rpc_device_count() || attr < 0 ||
+      attr >= SNAPSHOT_ATTRIBUTES)
+    return -1;
+  const device_snapshot_t *snapshot = rpc_lock_device_snapshot(device);
+  if (snapshot == nullptr)
+    return -1;
+  *result = snapshot->cu_attribute_results[attr];
+  if (*result == CUDA_SUCCESS)
+    *value = snapshot->cu_attributes[attr];
+  rpc_unlock_device_snapshot(device);
+  return 0;
+}
+
+// the versions of the current device's server.
+int rpc_server_snapshot(snapshot_t *snapshot) {
+  const int index = rpc_current_conn();
+  if (index >= rpc_size())
+    return -1;
+
+  pthread_mutex_lock(&conns[index].snapshot_mutex);
+  int result = rpc_fetch_snapshot(index);
+  if (result == 0)
+    *snapshot = conns[index].snapshot;
+  pthread_mutex_unlock(&conns[index].snapshot_mutex);
+  return result;
+}
+
+void rpc_invalidate_snapshot(const int index) {
+  pthread_mutex_lock(&conns[index].snapshot_mutex);
+  conns[index].snapshot_valid = false;
+  pthread_mutex_unlock(&conns[index].snapshot_mutex);
+}
+
+void rpc_register_pointer(const int index, const void *ptr,
+                          const size_t size) {
+  pthread_mutex_lock(&regions_mutex);
+  size_t &region = regions[index][(uintptr_t)ptr];
+  region = std::max(region, size);
+  pthread_mutex_unlock(&regions_mutex);
+}
+
+void rpc_register_handle(const int index, const void *handle) {
+  rpc_register_pointer(index, handle, 1);
+}
+
+void rpc_unregister_handle(const int index, const void *handle) {
+  pthread_mutex_lock(&regions_mutex);
+  regions[index].erase((uintptr_t)handle);
+  pthread_mutex_unlock(&regions_mutex);
+}
+
+// a name for a stream, event or library handle the client is creating, so the
+// create needn't wait for the server's. names are unique across connections;
+// each server maps them to what it created. see rpc_real_handle.
+void *rpc_new_handle() {
+  static std::atomic<uint64_t> handles{0};
+  return (void *)(VIRTUAL_HANDLE_BIT | ++handles);
+}
+
+// the connection a handle, or a pointer anywhere into device memory, came
+// from. unknown values go to the current device's server. -1 if several
+// servers returned it, as nothing tells which one the caller means; the call
+// then fails with an invalid value error rather than going to the wrong one.
+int rpc_handle_conn(const void *handle) {
+  uint32_t owners = 0;
+
+  pthread_mutex_lock(&regions_mutex);
+  for (int i = 0; i < nconns; i++) {
+    auto it = regions[i].upper_bound((uintptr_t)handle);
+    if (it != regions[i].begin()) {
+      --it;
+      if ((uintptr_t)handle - it->first < it->second)
+        owners |= 1u << i;
+    }
+  }
+  pthread_mutex_unlock(&regions_mutex);
+
+  if (owners == 0)
+    return rpc_current_conn();
+  if (owners & (owners - 1))
+    return -1;
+  return __builtin_ctz(owners);
+}
+
+cudaError_t rpc_malloc(const int index, void **devPtr, const size_t size) {
+  cudaError_t return_value;
+
+  if (rpc_start_request(index, RPC_cudaMalloc) < 0 ||
+      rpc_write(index, &size, sizeof(size_t)) < 0 ||
+      rpc_wait_for_response(index) < 0 ||
+      rpc_read(index, devPtr, sizeof(void *)) < 0 ||
+      rpc_end_response(index, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+
+  // copies, launches and frees find this server again by any address inside
+  // the allocation.
+  if (return_value == cudaSuccess)
+    rpc_register_pointer(index, *devPtr, size);
+  return return_value;
+}
+
+// gives slabs back to the server in one request that doesn't wait for it.
+// called with allocator_mutex held.
+static int rpc_free_slabs(const int index,
+                          const std::vector<uintptr_t> &slabs) {
+  int count = slabs.size();
+  if (count == 0)
+    return 0;
+
+  for (uintptr_t slab : slabs)
+    rpc_unregister_handle(index, (const void *)slab);
+  if (rpc_start_request(index, RPC___scudaFreeBatch) < 0 ||
+      rpc_write(index, &count, sizeof(int)) < 0 ||
+      rpc_write(index, slabs.data(), count * sizeof(uintptr_t)) < 0 ||
+      rpc_end_request(index) < 0)
+    return -1;
+  return 0;
+}
+
+// cudaMalloc, handed out from the current device's slabs once
+// SCUDA_ALLOCATOR_SLAB is set. only a block no slab has room for costs a round
+// trip, for a new slab.
+cudaError_t rpc_cached_malloc(void **devPtr, const size_t size) {
+  const int index = rpc_current_conn();
+  if (allocator_slab == 0 || size == 0 || current_device >= ndevices)
+    return rpc_malloc(index, devPtr, size);
+
+  conn_t *conn = &conns[index];
+  const size_t rounded = allocator_round(size, ALLOCATOR_ROUND);
+  cudaError_t result = cudaSuccess;
+
+  pthread_mutex_lock(&conn->allocator_mutex);
+  allocator_t *allocator = &conn->allocators[devices[current_device].second];
+  uintptr_t address = allocator_alloc(allocator, rounded);
+  if (address == 0) {
+    size_t slab_size = allocator_slab_size(rounded, allocator_slab);
+    void *slab;
+    result = rpc_malloc(index, &slab, slab_size);
+    // the idle slabs may be what the server is short of, and failing that a
+    // slab just big enough may still fit.
+    if (result == cudaErrorMemoryAllocation && allocator->idle > 0) {
+      rpc_free_slabs(index, allocator_trim(allocator, 0));
+      result = rpc_malloc(index, &slab, slab_size);
+    }
+    if (result == cudaErrorMemoryAllocation && slab_size > rounded) {
+      slab_size = rounded;
+      result = rpc_malloc(index, &slab, slab_size);
+    }
+    if (result == cudaSuccess) {
+      allocator_add_slab(allocator, (uintptr_t)slab, slab_size,
+                         allocator_is_small(rounded));
+      address = allocator_alloc(allocator, rounded);
+    }
+  }
+  pthread_mutex_unlock(&conn->allocator_mutex);
+
+  if (result == cudaSuccess)
+    *devPtr = (void *)address;
+  return result;
+}
+
+// puts a block from rpc_cached_malloc back in its slab, or returns false if
+// the allocator didn't hand it out. the device's idle slabs beyond
+// SCUDA_ALLOCATOR_CACHE bytes go back to the server.
+bool rpc_cached_free(const int index, const void *devPtr) {
+  if (allocator_slab == 0 || devPtr == nullptr)
+    return false;
+
+  conn_t *conn = &conns[index];
+  bool freed = false;
+
+  pthread_mutex_lock(&conn->allocator_mutex);
+  for (auto &it : conn->allocators) {
+    allocator_t *allocator = &it.second;
+    if (!allocator_free(allocator, (uintptr_t)devPtr))
+      continue;
+    if (allocator->idle > allocator_cache)
+      rpc_free_slabs(index, allocator_trim(allocator, allocator_cache));
+    freed = true;
+    break;
+  }
+  pthread_mutex_unlock(&conn->allocator_mutex);
+  return freed;
+}
+
+// a reset frees everything on the device, slabs included. -1 is the current
+// device, if it is on this server.
+void rpc_reset_allocator(const int index, int device) {
+  if (device < 0) {
+    if (current_device >= rpc_device_count() ||
+        devices[current_device].first != index)
+      return;
+    device = devices[current_device].second;
+  }
+
+  pthread_mutex_lock(&conns[index].allocator_mutex);
+  auto it = conns[index].allocators.find(device);
+  if (it != conns[index].allocators.end()) {
+    for (auto &slab : it->second.slabs)
+      rpc_unregister_handle(index, (const void *)slab.first);
+    conns[index].allocators.erase(it);
+  }
+  pthread_mutex_unlock(&conns[index].allocator_mutex);
+}
+
 void rpc_close() {
   if (pthread_mutex_lock(&conn_mutex) < 0)
     return;
-  while (--nconns >= 0)
-    close(conns[nconns].connfd);
+  while (--nconns >= 0) {
+    if (pthread_mutex_lock(&conns[nconns].write_mutex) == 0) {
+      rpc_flush_batch(nconns);
+      pthread_mutex_unlock(&conns[nconns].write_mutex);
+    }
+    // wakes the reader thread out of recv.
+    shutdown(conns[nconns].transport.fd, SHUT_RDWR);
+    // shared-memory regions stay mapped; the reader thread may still be
+    // polling them until it notices the socket is gone.
+    close(conns[nconns].transport.fd);
+    for (int fd : conns[nconns].data_fds)
+      close(fd);
+    conns[nconns].data_fds.clear();
+  }
   pthread_mutex_unlock(&conn_mutex);
 }
 
@@ -4603,6 +4603,7 @@ CUresult cuGetExportTable(const void **ppExportTable,
  */
 cudaError_t cudaDeviceReset();
 /**
+ * @sync
  */
 cudaError_t cudaDeviceSynchronize();
 /**
@@ -4716,6 +4717,7 @@ cudaError_t cudaThreadGetCacheConfig(enum cudaFuncCache *pCacheConfig);
  */
 cudaError_t cudaThreadSetCacheConfig(enum cudaFuncCache cacheConfig);
 /**
+ * @sync
  */
 cudaError_t cudaGetLastError();
 /**
@@ -4871,6 +4873,7 @@ cudaError_t cudaStreamSetAttribute(cudaStream_t hStream,
  */
 cudaError_t cudaStreamDestroy(cudaStream_t stream);
 /**
+ * @async
  * @param stream SEND_ONLY
  * @param event SEND_ONLY
  * @param flags SEND_ONLY
@@ -4887,6 +4890,7 @@ cudaError_t cudaStreamAddCallback(cudaStream_t stream,
                                   cudaStreamCallback_t callback, void *userData,
                                   unsigned int flags);
 /**
+ * @sync
  * @param stream SEND_ONLY
  */
 cudaError_t cudaStreamSynchronize(cudaStream_t stream);
@@ -4956,11 +4960,13 @@ cudaError_t cudaEventCreate(cudaEvent_t *event);
  */
 cudaError_t cudaEventCreateWithFlags(cudaEvent_t *event, unsigned int flags);
 /**
+ * @async
  * @param event SEND_ONLY
  * @param stream SEND_ONLY
  */
 cudaError_t cudaEventRecord(cudaEvent_t event, cudaStream_t stream);
 /**
+ * @async
  * @param event SEND_ONLY
  * @param stream SEND_ONLY
  * @param flags SEND_ONLY
@@ -4972,6 +4978,7 @@ cudaError_t cudaEventRecordWithFlags(cudaEvent_t event, cudaStream_t stream,
  */
 cudaError_t cudaEventQuery(cudaEvent_t event);
 /**
+ * @sync
  * @param event SEND_ONLY
  */
 cudaError_t cudaEventSynchronize(cudaEvent_t event);
@@ -5558,6 +5565,7 @@ cudaError_t cudaMemset2D(void *devPtr, size_t pitch, int value, size_t width,
 cudaError_t cudaMemset3D(struct cudaPitchedPtr pitchedDevPtr, int value,
                          struct cudaExtent extent);
 /**
+ * @async
  * @param devPtr SEND_ONLY
  * @param value SEND_ONLY
  * @param count SEND_ONLY
@@ -5566,6 +5574,7 @@ cudaError_t cudaMemset3D(struct cudaPitchedPtr pitchedDevPtr, int value,
 cudaError_t cudaMemsetAsync(void *devPtr, int value, size_t count,
                             cudaStream_t stream);
 /**
+ * @async
  * @param devPtr SEND_ONLY
  * @param pitch SEND_ONLY
  * @param value SEND_ONLY
@@ -5576,6 +5585,7 @@ cudaError_t cudaMemsetAsync(void *devPtr, int value, size_t count,
 cudaError_t cudaMemset2DAsync(void *devPtr, size_t pitch, int value,
                               size_t width, size_t height, cudaStream_t stream);
 /**
+ * @async
  * @param pitchedDevPtr SEND_ONLY
  * @param value SEND_ONLY
  * @param extent SEND_ONLY
@@ -6673,6 +6683,7 @@ cublasStatus_t cublasCreate_v2(cublasHandle_t *handle);
  */
 cublasStatus_t cublasDestroy_v2(cublasHandle_t handle);
 /**
+ * @async
  * @param handle SEND_ONLY
  * @param transa SEND_ONLY
  * @param transb SEND_ONLY
@@ -6694,6 +6705,7 @@ cublasStatus_t cublasSgemm_v2(cublasHandle_t handle, cublasOperation_t transa,
                               const float *B, int ldb, const float *beta,
                               float *C, int ldc);
 /**
+ * @async
  * @param handle SEND_ONLY
  * @param activationDesc SEND_ONLY
  * @param alpha SEND_ONLY NULLABLE
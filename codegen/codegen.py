@@ -5,6 +5,7 @@ from typing import Optional
 from dataclasses import dataclass
 import os
 import glob
+import re
 
 # this table is manually generated from the cuda.h headers
 MANUAL_REMAPPINGS = [
@@ -67,6 +68,169 @@ INTERNAL_FUNCTIONS = [
     "__cudaPopCallConfiguration",
 ]
 
+# requests of scuda's own, with no cuda function behind them. they are
+# numbered after every generated function so adding one doesn't move the
+# others, and both sides implement them by hand.
+EXTENSION_FUNCTIONS = [
+    "__scudaGetDeviceSnapshot",
+    "__scudaSetThreadState",
+    "__scudaFreeBatch",
+]
+
+# functions the client implements by hand around the device table while the
+# server side stays generated: device counts and ordinals are the client's
+# own, initialization goes to every server and allocations are recorded so
+# later calls find the server that holds them.
+CLIENT_MANUAL_IMPLEMENTATIONS = [
+    "cuInit",
+    "cuDeviceGet",
+    "cuDeviceGetCount",
+    "cudaGetDeviceCount",
+    "cudaGetDevice",
+    "cudaSetDevice",
+    "cudaMalloc",
+    "nvmlInit_v2",
+    "nvmlInitWithFlags",
+    "nvmlDeviceGetCount_v2",
+    # answered from the device snapshot. see snapshot.h.
+    "cuDriverGetVersion",
+    "cuDeviceGetAttribute",
+    "cudaDriverGetVersion",
+    "cudaRuntimeGetVersion",
+    "cudaGetDeviceProperties_v2",
+    "cudaDeviceGetAttribute",
+    # per-thread state the client keeps itself and hands to the server with
+    # the next request. see rpc_push_thread_state.
+    "cudaGetLastError",
+    "cudaPeekAtLastError",
+    "cudaThreadExchangeStreamCaptureMode",
+    "cuThreadExchangeStreamCaptureMode",
+    "cudaStreamIsCapturing",
+    "cuStreamIsCapturing",
+]
+
+# calls that start or end a stream capture, by the stream parameter. while
+# the client knows of no capture, it answers cudaStreamIsCapturing itself.
+CLIENT_CAPTURE_BEGINS = {
+    "cudaStreamBeginCapture": "stream",
+    "cuStreamBeginCapture_v2": "hStream",
+}
+CLIENT_CAPTURE_ENDS = {
+    "cudaStreamEndCapture": "stream",
+    "cuStreamEndCapture": "hStream",
+}
+
+# sync points, and whether they wait for the whole device. managed memory
+# library calls may have written comes back from them; see unified_sync.
+CLIENT_UNIFIED_SYNCS = {
+    "cudaDeviceSynchronize": "true",
+    "cudaStreamSynchronize": "false",
+    "cuCtxSynchronize": "true",
+    "cuStreamSynchronize": "false",
+}
+
+# calls that can change what the device snapshot holds. the client fetches
+# the snapshot of that server again before it answers from it next.
+CLIENT_SNAPSHOT_INVALIDATORS = [
+    "nvmlDeviceSetComputeMode",
+    "nvmlDeviceSetMigMode",
+    "nvmlDeviceSetGpuLockedClocks",
+    "nvmlDeviceResetGpuLockedClocks",
+    "nvmlDeviceSetApplicationsClocks",
+    "nvmlDeviceResetApplicationsClocks",
+]
+
+# resets that free a device's memory, and the device they reset; -1 is the
+# current one. the client drops the slabs it hands cudaMalloc blocks from.
+CLIENT_ALLOCATOR_RESETS = {
+    "cudaDeviceReset": "-1",
+    "cuDevicePrimaryCtxReset_v2": "dev",
+}
+
+# opaque handles that belong to whichever server created them. a call that
+# takes one by value goes to that server.
+HANDLE_TYPES = [
+    "cudaStream_t",
+    "cudaEvent_t",
+    "cudaGraph_t",
+    "cudaGraphExec_t",
+    "cudaGraphNode_t",
+    "cudaArray_t",
+    "cudaMipmappedArray_t",
+    "cudaMemPool_t",
+    "cudaExternalSemaphore_t",
+    "cudaExternalMemory_t",
+    "cudaGraphicsResource_t",
+    "cudaFunction_t",
+    "cudaUserObject_t",
+    "CUcontext",
+    "CUmodule",
+    "CUfunction",
+    "CUstream",
+    "CUevent",
+    "CUarray",
+    "CUmipmappedArray",
+    "CUgraph",
+    "CUgraphExec",
+    "CUgraphNode",
+    "CUmemoryPool",
+    "CUlinkState",
+    "CUlibrary",
+    "CUkernel",
+    "CUexternalSemaphore",
+    "CUexternalMemory",
+    "CUgraphicsResource",
+    "CUtexref",
+    "CUsurfref",
+    "cublasHandle_t",
+    "cublasLtHandle_t",
+    "cudnnHandle_t",
+    "nvmlDevice_t",
+    "nvmlUnit_t",
+    "nvmlEventSet_t",
+    "nvmlGpuInstance_t",
+    "nvmlComputeInstance_t",
+]
+
+# handles the client names itself, so that creating one doesn't wait on the
+# server. the server maps the names to the objects it created; see
+# rpc_real_handle. cudnn's backend descriptors are left out, as they are also
+# passed inside untyped attribute arrays.
+VIRTUAL_HANDLE_TYPES = [
+    "cudaStream_t",
+    "cudaEvent_t",
+    "CUstream",
+    "CUevent",
+    "cublasHandle_t",
+    "cudnnHandle_t",
+]
+
+# device ordinal parameters. one of DEVICE_PARAMS picks the server; one of
+# PEER_DEVICE_PARAMS must be on that same server.
+DEVICE_PARAMS = ["device", "dev", "srcDevice"]
+PEER_DEVICE_PARAMS = ["peerDevice", "peerDev", "dstDevice"]
+
+# device ordinal parameters the server translates between the client's
+# numbering and its own, inputs before the call and outputs after it.
+SERVER_DEVICE_PARAMS = DEVICE_PARAMS + PEER_DEVICE_PARAMS + ["ordinal"]
+
+# device counts the server answers with the size of the client's device set.
+SERVER_DEVICE_COUNTS = {
+    "cuDeviceGetCount": "count",
+    "cudaGetDeviceCount": "count",
+    "nvmlDeviceGetCount_v2": "deviceCount",
+}
+
+# calls that block until a stream or event is done, by the parameter to wait
+# on. the server finishes them on an executor thread for that handle so the
+# client's other streams aren't held up behind them.
+SERVER_STREAM_WAITS = {
+    "cuStreamSynchronize": "hStream",
+    "cuEventSynchronize": "hEvent",
+    "cudaStreamSynchronize": "stream",
+    "cudaEventSynchronize": "event",
+}
+
 # a list of manually implemented cuda/nvml functions.
 # these are automatically appended to each file; operation order is maintained as well.
 MANUAL_IMPLEMENTATIONS = [
@@ -93,14 +257,14 @@ class NullableOperation:
         if not self.send:
             return
         f.write(
-            "        rpc_write(0, &{param_name}, sizeof({server_type})) < 0 ||\n".format(
+            "        rpc_write(scuda_conn, &{param_name}, sizeof({server_type})) < 0 ||\n".format(
                 param_name=self.parameter.name,
                 server_type=self.ptr.format(),
             )
         )
 
         f.write(
-            "        ({param_name} != nullptr && rpc_write(0, {param_name}, sizeof({base_type})) < 0) ||\n".format(
+            "        ({param_name} != nullptr && rpc_write(scuda_conn, {param_name}, sizeof({base_type})) < 0) ||\n".format(
                 param_name=self.parameter.name,
                 # void is treated differently from non void pointer types
                 base_type=(
@@ -112,7 +276,7 @@ class NullableOperation:
         )
 
     def client_unified_copy(self, f, direction, error):
-        f.write("    if (maybe_copy_unified_arg(0, (void*){name}, cudaMemcpyDeviceToHost) < 0)\n".format(name=self.parameter.name))
+        f.write("    if (maybe_copy_unified_arg(0, (void*){name}, {direction}) < 0)\n".format(name=self.parameter.name, direction=direction))
         f.write("      return {error};\n".format(error=error))
 
     @property
@@ -172,13 +336,13 @@ class NullableOperation:
         if not self.recv:
             return
         f.write(
-            "        rpc_read(0, &{param_name}_null_check, sizeof({server_type})) < 0 ||\n".format(
+            "        rpc_read(scuda_conn, &{param_name}_null_check, sizeof({server_type})) < 0 ||\n".format(
                 param_name=self.parameter.name,
                 server_type=self.ptr.format(),
             )
         )
         f.write(
-            "        ({param_name}_null_check && rpc_read(0, {param_name}, sizeof({base_type})) < 0) ||\n".format(
+            "        ({param_name}_null_check && rpc_read(scuda_conn, {param_name}, sizeof({base_type})) < 0) ||\n".format(
                 param_name=self.parameter.name,
                 base_type=self.ptr.ptr_to.format(),
             )
@@ -204,7 +368,7 @@ class ArrayOperation:
             return
         elif isinstance(self.length, int):
             f.write(
-                "        rpc_write(0, {param_name}, {size}) < 0 ||\n".format(
+                "        rpc_write(scuda_conn, {param_name}, {size}) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     size=self.length,
                 )
@@ -212,7 +376,7 @@ class ArrayOperation:
         # array length operations are handled differently than char
         elif isinstance(self.ptr, Array):
             f.write(
-                "        rpc_write(0, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
+                "        rpc_write(scuda_conn, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     param_type=self.ptr.array_of.format(),
                 )
@@ -223,7 +387,7 @@ class ArrayOperation:
             else:
                 length = self.length.name
             f.write(
-                "        rpc_write(0, {param_name}, {length} * sizeof({param_type})) < 0 ||\n".format(
+                "        rpc_write(scuda_conn, {param_name}, {length} * sizeof({param_type})) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     param_type=self.ptr.ptr_to.format(),
                     length=length,
@@ -306,14 +470,15 @@ class ArrayOperation:
             self.ptr.ptr_to.const = c
         return s
         
-    def server_rpc_read(self, f, index) -> Optional[str]:
+    def server_rpc_read(self, f):
         if not self.send:
-            # if this parameter is recv only and it's a type pointer, it needs to be malloc'd.
+            # if this parameter is recv only and it's a type pointer, it needs
+            # scratch space from the request arena.
             if isinstance(self.ptr, Pointer):
                 f.write("        false)\n")
-                f.write("        goto ERROR_{index};\n".format(index=index))
+                f.write("        goto ERROR_0;\n")
                 f.write(
-                    "    {param_name} = ({server_type})malloc({length} * sizeof({param_type}));\n".format(
+                    "    {param_name} = ({server_type})rpc_arena_alloc(conn, {length} * sizeof({param_type}));\n".format(
                         param_name=self.parameter.name,
                         param_type=self.ptr.ptr_to.format(),
                         server_type=self.ptr.format(),
@@ -321,7 +486,6 @@ class ArrayOperation:
                     )
                 )
                 f.write("    if(")
-                return self.parameter.name
             return
         elif isinstance(self.length, int):
             f.write(
@@ -378,7 +542,7 @@ class ArrayOperation:
             return
         if isinstance(self.length, int):
             f.write(
-                "        rpc_read(0, {param_name}, {size}) < 0 ||\n".format(
+                "        rpc_read(scuda_conn, {param_name}, {size}) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     size=self.length,
                 )
@@ -389,7 +553,7 @@ class ArrayOperation:
             else:
                 length = self.length.name
             f.write(
-                "        rpc_read(0, {param_name}, {length} * sizeof({param_type})) < 0 ||\n".format(
+                "        rpc_read(scuda_conn, {param_name}, {length} * sizeof({param_type})) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     param_type=self.ptr.ptr_to.format(),
                     length=length,
@@ -412,12 +576,12 @@ class NullTerminatedOperation:
         if not self.send:
             return
         f.write(
-            "        rpc_write(0, &{param_name}_len, sizeof(std::size_t)) < 0 ||\n".format(
+            "        rpc_write(scuda_conn, &{param_name}_len, sizeof(std::size_t)) < 0 ||\n".format(
                 param_name=self.parameter.name,
             )
         )
         f.write(
-            "        rpc_write(0, {param_name}, {param_name}_len) < 0 ||\n".format(
+            "        rpc_write(scuda_conn, {param_name}, {param_name}_len) < 0 ||\n".format(
                 param_name=self.parameter.name,
             )
         )
@@ -437,7 +601,7 @@ class NullTerminatedOperation:
         )
         f.write("      return {error};\n".format(error=error))
 
-    def server_rpc_read(self, f, index) -> Optional[str]:
+    def server_rpc_read(self, f):
         if not self.send:
             return
         f.write(
@@ -445,9 +609,9 @@ class NullTerminatedOperation:
                 param_name=self.parameter.name
             )
         )
-        f.write("        goto ERROR_{index};\n".format(index=index))
+        f.write("        goto ERROR_0;\n")
         f.write(
-            "    {param_name} = ({server_type})malloc({param_name}_len);\n".format(
+            "    {param_name} = ({server_type})rpc_arena_alloc(conn, {param_name}_len);\n".format(
                 param_name=self.parameter.name,
                 server_type=self.ptr.format(),
             )
@@ -457,7 +621,6 @@ class NullTerminatedOperation:
                 param_name=self.parameter.name
             )
         )
-        return self.parameter.name
 
     @property
     def server_reference(self) -> str:
@@ -481,12 +644,12 @@ class NullTerminatedOperation:
         if not self.recv:
             return
         f.write(
-            "        rpc_read(0, &{param_name}_len, sizeof(std::size_t)) < 0 ||\n".format(
+            "        rpc_read(scuda_conn, &{param_name}_len, sizeof(std::size_t)) < 0 ||\n".format(
                 param_name=self.parameter.name
             )
         )
         f.write(
-            "        rpc_read(0, {param_name}, {param_name}_len) < 0 ||\n".format(
+            "        rpc_read(scuda_conn, {param_name}, {param_name}_len) < 0 ||\n".format(
                 param_name=self.parameter.name
             )
         )
@@ -509,7 +672,7 @@ class OpaqueTypeOperation:
             return
         else:
             f.write(
-                "        rpc_write(0, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
+                "        rpc_write(scuda_conn, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
                     param_name=self.parameter.name,
                     param_type=self.type_.format(),
                 )
@@ -576,7 +739,7 @@ class OpaqueTypeOperation:
         if not self.recv:
             return
         f.write(
-            "        rpc_read(0, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
+            "        rpc_read(scuda_conn, &{param_name}, sizeof({param_type})) < 0 ||\n".format(
                 param_name=self.parameter.name,
                 param_type=self.type_.format(),
             )
@@ -599,7 +762,7 @@ class DereferenceOperation:
         if not self.send:
             return
         f.write(
-            "        rpc_write(0, {param_name}, sizeof({param_type})) < 0 ||\n".format(
+            "        rpc_write(scuda_conn, {param_name}, sizeof({param_type})) < 0 ||\n".format(
                 param_name=self.parameter.name,
                 param_type=self.type_.ptr_to.format(),
             )
@@ -646,7 +809,7 @@ class DereferenceOperation:
             return
         # if this parameter is recv only then dereference it.
         f.write(
-            "        rpc_read(0, {param_name}, sizeof({param_type})) < 0 ||\n".format(
+            "        rpc_read(scuda_conn, {param_name}, sizeof({param_type})) < 0 ||\n".format(
                 param_name=self.parameter.name,
                 param_type=self.type_.ptr_to.format(),
             )
@@ -904,6 +1067,196 @@ def error_const(return_type: str) -> str:
     raise NotImplementedError("Unknown return type: %s" % return_type)
 
 
+# what a call returns when its arguments don't make sense, such as a handle
+# that several servers returned.
+def invalid_const(return_type: str) -> str:
+    if return_type == "nvmlReturn_t":
+        return "NVML_ERROR_INVALID_ARGUMENT"
+    if return_type == "CUresult":
+        return "CUDA_ERROR_INVALID_VALUE"
+    if return_type == "cudaError_t":
+        return "cudaErrorInvalidValue"
+    if return_type == "cublasStatus_t":
+        return "CUBLAS_STATUS_INVALID_VALUE"
+    if return_type == "cudnnStatus_t":
+        return "CUDNN_STATUS_BAD_PARAM"
+    return error_const(return_type)
+
+
+def success_const(return_type: str) -> str:
+    if return_type == "nvmlReturn_t":
+        return "NVML_SUCCESS"
+    if return_type == "CUresult":
+        return "CUDA_SUCCESS"
+    if return_type == "cudaError_t":
+        return "cudaSuccess"
+    if return_type == "cublasStatus_t":
+        return "CUBLAS_STATUS_SUCCESS"
+    if return_type == "cudnnStatus_t":
+        return "CUDNN_STATUS_SUCCESS"
+    raise NotImplementedError("Unknown return type: %s" % return_type)
+
+
+# deferred errors are reported through cuda runtime sync points, so statuses
+# from other libraries are folded into a generic launch failure.
+def deferred_error(return_type: str, result: str) -> str:
+    if return_type == "cudaError_t":
+        return result
+    return "{result} == {success} ? cudaSuccess : cudaErrorLaunchFailure".format(
+        result=result,
+        success=success_const(return_type),
+    )
+
+
+# checks for a bare tag such as @async or @sync in a function annotation.
+def has_annotation_tag(annotation: str, tag: str) -> bool:
+    if not annotation:
+        return False
+    for line in annotation.split("\n"):
+        # compare whole words; @sync is a substring of @async.
+        words = line.split()
+        if tag in words or tag.upper() in words:
+            return True
+    return False
+
+
+def is_handle_type(type: str) -> bool:
+    type = type.replace("const ", "").strip()
+    return type in HANDLE_TYPES or re.fullmatch(r"cudnn\w+Descriptor_t", type)
+
+
+def is_virtual_handle_type(type: str) -> bool:
+    type = type.replace("const ", "").strip()
+    return type in VIRTUAL_HANDLE_TYPES or (
+        re.fullmatch(r"cudnn\w+Descriptor_t", type) is not None
+        and type != "cudnnBackendDescriptor_t"
+    )
+
+
+# the operation a create returns its one new handle through, if that handle is
+# virtual. the client sends the name it picked in its place and doesn't wait.
+def virtual_handle_create(function: Function, operations) -> Optional[Operation]:
+    name = function.name.format()
+    if (
+        "Create" not in name
+        or name in MANUAL_IMPLEMENTATIONS
+        or name in CLIENT_MANUAL_IMPLEMENTATIONS
+    ):
+        return None
+    outputs = [op for op in operations if op.recv]
+    if (
+        len(outputs) != 1
+        or not isinstance(outputs[0], DereferenceOperation)
+        or not is_virtual_handle_type(outputs[0].type_.ptr_to.format())
+    ):
+        return None
+    return outputs[0]
+
+
+# virtual handles passed by value, as (name, type) in parameter order.
+def virtual_handle_inputs(function: Function, operations) -> list[tuple[str, str]]:
+    inputs = []
+    for param in function.parameters:
+        for op in operations:
+            if (
+                op.parameter.name == param.name
+                and isinstance(op, OpaqueTypeOperation)
+                and op.send
+                and not isinstance(op.type_, Pointer)
+                and is_virtual_handle_type(op.type_.format())
+            ):
+                inputs.append(
+                    (param.name, op.type_.format().replace("const ", "").strip())
+                )
+    return inputs
+
+
+# virtual handles a call hands back that it didn't create, as (name, type).
+def virtual_handle_outputs(function: Function, operations) -> list[tuple[str, str]]:
+    create = virtual_handle_create(function, operations)
+    outputs = []
+    for param in function.parameters:
+        for op in operations:
+            if (
+                op.parameter.name == param.name
+                and op is not create
+                and isinstance(op, DereferenceOperation)
+                and op.recv
+                and is_virtual_handle_type(op.type_.ptr_to.format())
+            ):
+                outputs.append((param.name, op.type_.ptr_to.format()))
+    return outputs
+
+
+def is_device_param(function: Function, param: Parameter) -> bool:
+    if param.type.format() not in ["int", "CUdevice", "unsigned int"]:
+        return False
+    # nvml devices are looked up by the same ordinals.
+    if function.name.format().startswith("nvmlDeviceGetHandleByIndex"):
+        return param.name == "index"
+    return param.type.format() != "unsigned int" and param.name in DEVICE_PARAMS
+
+
+# which connection a client stub sends its request on: the server of the
+# device it names, else of the first handle it takes, else of the current
+# device.
+def client_route(function: Function) -> str:
+    for param in function.parameters:
+        if is_device_param(function, param):
+            return "rpc_device_conn({cast}&{name})".format(
+                cast="(int *)" if param.type.format() == "unsigned int" else "",
+                name=param.name,
+            )
+    for param in function.parameters:
+        if param.name and is_handle_type(param.type.format()):
+            return "rpc_handle_conn((const void *){name})".format(name=param.name)
+    return "rpc_current_conn()"
+
+
+def client_route_handle(function: Function) -> Optional[str]:
+    for param in function.parameters:
+        if is_device_param(function, param):
+            return None
+    for param in function.parameters:
+        if param.name and is_handle_type(param.type.format()):
+            return param.name
+    return None
+
+
+def server_device_inputs(function: Function, operations) -> list[str]:
+    references = [op.server_reference for op in operations]
+    names = []
+    for param in function.parameters:
+        if param.name not in references:
+            continue
+        if function.name.format().startswith("nvmlDeviceGetHandleByIndex"):
+            if param.name == "index":
+                names.append(param.name)
+        elif (
+            param.type.format() in ["int", "CUdevice"]
+            and param.name in SERVER_DEVICE_PARAMS
+        ):
+            names.append(param.name)
+    return names
+
+
+def server_device_outputs(function: Function, operations) -> list[str]:
+    references = [op.server_reference for op in operations]
+    names = []
+    for param in function.parameters:
+        if "&" + param.name not in references:
+            continue
+        if function.name.format() == "nvmlDeviceGetIndex":
+            if param.name == "index":
+                names.append(param.name)
+        elif (
+            param.type.format() in ["int *", "CUdevice *"]
+            and param.name in SERVER_DEVICE_PARAMS
+        ):
+            names.append(param.name)
+    return names
+
+
 def prefix_std(type: str) -> str:
     # if type in ["size_t", "std::size_t"]:
     #     return "std::size_t"
@@ -994,9 +1347,18 @@ def main():
             operations, is_func_disabled = parse_annotation(
                 annotation.doxygen, function.parameters
             )
+            # async requests are never answered, so they can't receive anything.
+            if has_annotation_tag(annotation.doxygen, "@async") and any(
+                op.recv for op in operations
+            ):
+                raise NotImplementedError("@async functions cannot RECV")
         except Exception as e:
             print(f"Error parsing annotation for {function.name}: {e}")
             continue
+        # the client sends the name it picked for the new handle.
+        create = virtual_handle_create(function, operations)
+        if create:
+            create.send = True
         functions_with_annotations.append(
             (function, annotation, operations, is_func_disabled)
         )
@@ -1021,6 +1383,15 @@ def main():
                 )
             )
 
+        lastIndex += len(functions_with_annotations)
+        for i, function in enumerate(EXTENSION_FUNCTIONS):
+            f.write(
+                "#define RPC_{name} {value}\n".format(
+                    name=function,
+                    value=i + lastIndex,
+                )
+            )
+
     with open("gen_client.cpp", "w") as f:
         f.write(
             "#include <nvml.h>\n"
@@ -1042,11 +1413,24 @@ def main():
             "extern int rpc_read(const int index, void *data, const std::size_t size);\n"
             "extern int rpc_end_response(const int index, void *return_value);\n"
             "int maybe_copy_unified_arg(const int index, void* arg, enum cudaMemcpyKind kind);\n"
-            "extern int rpc_close();\n\n"
+            "extern int rpc_close();\n"
+            "extern int rpc_current_conn();\n"
+            "extern int rpc_device_conn(int *device);\n"
+            "extern void rpc_device_peer(const int index, int *device);\n"
+            "extern int rpc_handle_conn(const void *handle);\n"
+            "extern void rpc_register_handle(const int index, const void *handle);\n"
+            "extern void rpc_unregister_handle(const int index, const void *handle);\n"
+            "extern void rpc_invalidate_snapshot(const int index);\n"
+            "extern void rpc_record_error(const cudaError_t error);\n"
+            "extern void rpc_begin_capture(const void *stream);\n"
+            "extern void rpc_end_capture(const void *stream);\n"
+            "extern int unified_sync(const bool device);\n"
+            "extern void *rpc_new_handle();\n"
+            "extern void rpc_reset_allocator(const int index, int device);\n\n"
         )
         for function, annotation, operations, disabled in functions_with_annotations:
             # we don't generate client function definitions for disabled functions; only the RPC definitions.
-            if disabled:
+            if disabled or function.name.format() in CLIENT_MANUAL_IMPLEMENTATIONS:
                 continue
 
             params = []
@@ -1080,6 +1464,41 @@ def main():
             )
             f.write("{\n")
 
+            f.write(
+                "    const int scuda_conn = {route};\n".format(
+                    route=client_route(function)
+                )
+            )
+            # rpc_handle_conn can't tell which server a value several of them
+            # returned belongs to.
+            if client_route(function).startswith("rpc_handle_conn"):
+                invalid = invalid_const(function.return_type.format())
+                if function.return_type.format() == "cudaError_t":
+                    f.write(
+                        "    if (scuda_conn < 0) {{\n"
+                        "        rpc_record_error({invalid});\n"
+                        "        return {invalid};\n"
+                        "    }}\n".format(invalid=invalid)
+                    )
+                else:
+                    f.write(
+                        "    if (scuda_conn < 0)\n"
+                        "        return {invalid};\n".format(invalid=invalid)
+                    )
+            for param in function.parameters:
+                if param.name in PEER_DEVICE_PARAMS and param.type.format() in [
+                    "int",
+                    "CUdevice",
+                ]:
+                    f.write(
+                        "    rpc_device_peer(scuda_conn, &{name});\n".format(
+                            name=param.name
+                        )
+                    )
+
+            create = virtual_handle_create(function, operations)
+            is_async = has_annotation_tag(annotation.doxygen, "@async") or create
+
             for operation in operations:
                 operation.client_unified_copy(
                     f,
@@ -1087,11 +1506,20 @@ def main():
                     error_const(function.return_type.format()),
                 )
 
-            f.write(
-                "    {return_type} return_value;\n".format(
-                    return_type=function.return_type.format()
+            if create:
+                f.write(
+                    "    *{name} = ({type})rpc_new_handle();\n".format(
+                        name=create.parameter.name,
+                        type=create.type_.ptr_to.format(),
+                    )
+                )
+
+            if not is_async:
+                f.write(
+                    "    {return_type} return_value;\n".format(
+                        return_type=function.return_type.format()
+                    )
                 )
-            )
 
             # compute the strlen's for null-terminated operations.
             for operation in operations:
@@ -1110,7 +1538,7 @@ def main():
                         )
 
             f.write(
-                "    if (rpc_start_request(0, RPC_{name}) < 0 ||\n".format(
+                "    if (rpc_start_request(scuda_conn, RPC_{name}) < 0 ||\n".format(
                     name=function.name.format()
                 )
             )
@@ -1118,18 +1546,107 @@ def main():
             for operation in operations:
                 operation.client_rpc_write(f)
 
-            f.write("        rpc_wait_for_response(0) < 0 ||\n")
+            # async requests return immediately; the server holds on to any
+            # error until the next sync point.
+            if is_async:
+                f.write("        rpc_end_request(scuda_conn) < 0)\n")
+            else:
+                f.write("        rpc_wait_for_response(scuda_conn) < 0 ||\n")
 
-            for operation in operations:
-                operation.client_rpc_read(f)
+                for operation in operations:
+                    operation.client_rpc_read(f)
 
-            f.write("        rpc_end_response(0, &return_value) < 0)\n")
+                f.write("        rpc_end_response(scuda_conn, &return_value) < 0)\n")
             f.write(
                 "        return {error_return};\n".format(
                     error_return=error_const(function.return_type.format())
                 )
             )
 
+            # handles the server just created are remembered so later calls
+            # that take them find their way back to it.
+            for operation in operations:
+                if (
+                    not is_async
+                    and isinstance(operation, DereferenceOperation)
+                    and operation.recv
+                    and is_handle_type(operation.type_.ptr_to.format())
+                ):
+                    f.write(
+                        "    if (return_value == {success})\n".format(
+                            success=success_const(function.return_type.format())
+                        )
+                    )
+                    f.write(
+                        "        rpc_register_handle(scuda_conn, (const void *)*{name});\n".format(
+                            name=operation.parameter.name
+                        )
+                    )
+
+            if create:
+                f.write(
+                    "    rpc_register_handle(scuda_conn, (const void *)*{name});\n".format(
+                        name=create.parameter.name
+                    )
+                )
+
+            handle = client_route_handle(function)
+            if handle and "Destroy" in function.name.format():
+                f.write(
+                    "    rpc_unregister_handle(scuda_conn, (const void *){name});\n".format(
+                        name=handle
+                    )
+                )
+
+            if function.name.format() in CLIENT_SNAPSHOT_INVALIDATORS:
+                f.write("    rpc_invalidate_snapshot(scuda_conn);\n")
+
+            if function.name.format() in CLIENT_ALLOCATOR_RESETS:
+                f.write(
+                    "    if (return_value == {success})\n".format(
+                        success=success_const(function.return_type.format())
+                    )
+                )
+                f.write(
+                    "        rpc_reset_allocator(scuda_conn, {device});\n".format(
+                        device=CLIENT_ALLOCATOR_RESETS[function.name.format()]
+                    )
+                )
+
+            if function.name.format() in CLIENT_CAPTURE_BEGINS:
+                f.write(
+                    "    if (return_value == {success})\n".format(
+                        success=success_const(function.return_type.format())
+                    )
+                )
+                f.write(
+                    "        rpc_begin_capture((const void *){name});\n".format(
+                        name=CLIENT_CAPTURE_BEGINS[function.name.format()]
+                    )
+                )
+            if function.name.format() in CLIENT_CAPTURE_ENDS:
+                f.write(
+                    "    rpc_end_capture((const void *){name});\n".format(
+                        name=CLIENT_CAPTURE_ENDS[function.name.format()]
+                    )
+                )
+            if function.name.format() in CLIENT_UNIFIED_SYNCS:
+                f.write(
+                    "    if (unified_sync({device}) < 0)\n".format(
+                        device=CLIENT_UNIFIED_SYNCS[function.name.format()]
+                    )
+                )
+                f.write(
+                    "        return {error_return};\n".format(
+                        error_return=error_const(function.return_type.format())
+                    )
+                )
+
+            # the runtime's last error is kept by the client, from the result
+            # of every call that waited for one.
+            if not is_async and function.return_type.format() == "cudaError_t":
+                f.write("    rpc_record_error(return_value);\n")
+
             for operation in operations:
                 operation.client_unified_copy(
                     f,
@@ -1145,7 +1662,14 @@ def main():
                     )
                 )
 
-            f.write("    return return_value;\n")
+            if is_async:
+                f.write(
+                    "    return {success};\n".format(
+                        success=success_const(function.return_type.format())
+                    )
+                )
+            else:
+                f.write("    return return_value;\n")
             f.write("}\n\n")
 
         f.write("std::unordered_map<std::string, void *> functionMap = {\n")
@@ -1207,6 +1731,7 @@ def main():
             "#include <cublas_v2.h>\n"
             "#include <cuda_runtime_api.h>\n\n"
             "#include <cstring>\n"
+            "#include <functional>\n"
             "#include <string>\n"
             "#include <unordered_map>\n\n"
             '#include "gen_api.h"\n\n'
@@ -1216,7 +1741,18 @@ def main():
             "extern int rpc_end_request(const void *conn);\n"
             "extern int rpc_start_response(const void *conn, const int request_id);\n"
             "extern int rpc_write(const void *conn, const void *data, const std::size_t size);\n"
-            "extern int rpc_end_response(const void *conn, void *return_value);\n\n"
+            "extern int rpc_end_response(const void *conn, void *return_value);\n"
+            "extern int rpc_defer_error(const void *conn, const int error);\n"
+            "extern int rpc_merge_deferred_error(const void *conn, const int request_id, void *return_value);\n"
+            "extern void *rpc_arena_alloc(const void *conn, const std::size_t size);\n"
+            "extern int rpc_server_device(const void *conn, const int device);\n"
+            "extern int rpc_client_device(const void *conn, const int device);\n"
+            "extern int rpc_client_device_count(const void *conn, const int count);\n"
+            "extern int rpc_run_on_stream(const void *conn, const void *stream, std::function<int()> job);\n"
+            "extern const void *rpc_real_handle(const void *conn, const void *handle);\n"
+            "extern void rpc_map_handle(const void *conn, const void *handle, const void *real);\n"
+            "extern const void *rpc_unmap_handle(const void *conn, const void *handle);\n"
+            "extern const void *rpc_virtual_handle(const void *conn, const void *real);\n\n"
         )
         for function, annotation, operations, disabled in functions_with_annotations:
             if function.name.format() in MANUAL_IMPLEMENTATIONS or disabled:
@@ -1230,13 +1766,15 @@ def main():
             )
             f.write("{\n")
 
-            defers = []
-
             for operation in operations:
                 f.write(operation.server_declaration)
 
             f.write("    int request_id;\n")
 
+            create = virtual_handle_create(function, operations)
+            if create:
+                f.write("    const void *scuda_virtual_handle;\n")
+
             # we only generate return from non-void types
             if function.return_type.format() != "void":
                 f.write(
@@ -1249,19 +1787,49 @@ def main():
 
             f.write("    if (\n")
             for operation in operations:
-                if isinstance(operation, NullTerminatedOperation) or isinstance(operation, ArrayOperation):
-                    if error := operation.server_rpc_read(f, len(defers)):
-                        defers.append(error)
-                else:
-                    operation.server_rpc_read(f)
+                operation.server_rpc_read(f)
             f.write("        false)\n")
-            f.write("        goto ERROR_{index};\n".format(index=len(defers)))
+            f.write("        goto ERROR_0;\n")
 
             f.write("\n")
 
             f.write("    request_id = rpc_end_request(conn);\n")
             f.write("    if (request_id < 0)\n")
-            f.write("        goto ERROR_{index};\n".format(index=len(defers)))
+            f.write("        goto ERROR_0;\n")
+
+            # the client numbers only the devices it was given, from 0.
+            for name in server_device_inputs(function, operations):
+                f.write(
+                    "    {name} = rpc_server_device(conn, {name});\n".format(name=name)
+                )
+
+            # the client's names for handles become the objects they stand for.
+            # a destroy forgets the first one.
+            for i, (name, type) in enumerate(virtual_handle_inputs(function, operations)):
+                translate = "rpc_real_handle"
+                if i == 0 and "Destroy" in function.name.format():
+                    translate = "rpc_unmap_handle"
+                f.write(
+                    "    {name} = ({type}){translate}(conn, (const void *){name});\n".format(
+                        name=name, type=type, translate=translate
+                    )
+                )
+            if create:
+                f.write(
+                    "    scuda_virtual_handle = (const void *){name};\n".format(
+                        name=create.parameter.name
+                    )
+                )
+
+            # the rest runs on the handle's executor, once the request is read.
+            error_exit = "goto ERROR_0"
+            if function.name.format() in SERVER_STREAM_WAITS:
+                f.write(
+                    "    if (rpc_run_on_stream(conn, (const void *){name}, [=]() {{\n".format(
+                        name=SERVER_STREAM_WAITS[function.name.format()]
+                    )
+                )
+                error_exit = "return -1"
 
             params: list[str] = []
             # these need to be in function param order, not operation order.
@@ -1270,34 +1838,104 @@ def main():
                     if op.parameter.name == param.name:
                         params.append(op.server_reference)
 
-            if function.return_type.format() != "void":
+            if function.name.format() in SERVER_STREAM_WAITS:
                 f.write(
-                    "    scuda_intercept_result = {name}({params});\n\n".format(
+                    "    {return_type} scuda_intercept_result = {name}({params});\n".format(
+                        return_type=function.return_type.format(),
+                        name=function.name.format(),
+                        params=", ".join(params),
+                    )
+                )
+            elif function.return_type.format() != "void":
+                f.write(
+                    "    scuda_intercept_result = {name}({params});\n".format(
                         name=function.name.format(),
                         params=", ".join(params),
                     )
                 )
             else:
                 f.write(
-                    "    {name}({params});\n\n".format(
+                    "    {name}({params});\n".format(
                         name=function.name.format(),
                         params=", ".join(params),
                     )
                 )
 
-            f.write("    if (rpc_start_response(conn, request_id) < 0 ||\n")
+            if create:
+                f.write(
+                    "    if (scuda_intercept_result == {success})\n".format(
+                        success=success_const(function.return_type.format())
+                    )
+                )
+                f.write(
+                    "        rpc_map_handle(conn, scuda_virtual_handle, (const void *){name});\n".format(
+                        name=create.parameter.name
+                    )
+                )
+            for name, type in virtual_handle_outputs(function, operations):
+                f.write(
+                    "    {name} = ({type})rpc_virtual_handle(conn, (const void *){name});\n".format(
+                        name=name, type=type
+                    )
+                )
+            # a failed call leaves its outputs unset, so they are passed back
+            # untranslated.
+            translations = [
+                "{name} = rpc_client_device(conn, {name});".format(name=name)
+                for name in server_device_outputs(function, operations)
+            ]
+            if function.name.format() in SERVER_DEVICE_COUNTS:
+                translations.append(
+                    "{name} = rpc_client_device_count(conn, {name});".format(
+                        name=SERVER_DEVICE_COUNTS[function.name.format()]
+                    )
+                )
+            for translation in translations:
+                f.write(
+                    "    if (scuda_intercept_result == {success})\n".format(
+                        success=success_const(function.return_type.format())
+                    )
+                )
+                f.write("        {translation}\n".format(translation=translation))
+            f.write("\n")
+
+            if has_annotation_tag(annotation.doxygen, "@async") or create:
+                # the client isn't waiting on a response; hold on to the error
+                # so that the next sync point can report it.
+                f.write(
+                    "    if (rpc_defer_error(conn, {error}) < 0)\n".format(
+                        error=deferred_error(
+                            function.return_type.format(), "scuda_intercept_result"
+                        )
+                    )
+                )
+                f.write("        {exit};\n".format(exit=error_exit))
+            else:
+                # sync points report whatever the async requests before them hit.
+                if has_annotation_tag(annotation.doxygen, "@sync"):
+                    f.write(
+                        "    if (rpc_merge_deferred_error(conn, request_id, &scuda_intercept_result) < 0 ||\n"
+                    )
+                    f.write("        rpc_start_response(conn, request_id) < 0 ||\n")
+                else:
+                    f.write("    if (rpc_start_response(conn, request_id) < 0 ||\n")
 
-            for operation in operations:
-                operation.server_rpc_write(f)
+                for operation in operations:
+                    operation.server_rpc_write(f)
 
-            f.write("        rpc_end_response(conn, &scuda_intercept_result) < 0)\n")
-            f.write("        goto ERROR_{index};\n".format(index=len(defers)))
+                f.write(
+                    "        rpc_end_response(conn, &scuda_intercept_result) < 0)\n"
+                )
+                f.write("        {exit};\n".format(exit=error_exit))
+            if function.name.format() in SERVER_STREAM_WAITS:
+                f.write("    return 0;\n")
+                f.write("    }) < 0)\n")
+                f.write("        goto ERROR_0;\n")
             f.write("\n")
             f.write("    return 0;\n")
 
-            for i, defer in enumerate(defers):
-                f.write("ERROR_{index}:\n".format(index=len(defers) - i))
-                f.write("    free((void *) {param_name});\n".format(param_name=defer))
+            # argument arrays come from the request arena, so there is
+            # nothing to free here.
             f.write("ERROR_0:\n")
             f.write("    return -1;\n")
             f.write("}\n\n")
@@ -1310,6 +1948,8 @@ def main():
                 f.write("    nullptr,\n")
             else:
                 f.write("    handle_{name},\n".format(name=function.name.format()))
+        for function in EXTENSION_FUNCTIONS:
+            f.write("    handle_{name},\n".format(name=function))
         f.write("};\n\n")
 
         f.write("RequestHandler get_handler(const int op)\n")
@@ -1412,3 +1412,6 @@
 #define RPC_cudnnGetNormalizationForwardTrainingWorkspaceSize 1411
 #define RPC_cudnnGetNormalizationBackwardWorkspaceSize 1412
 #define RPC_cudnnGetNormalizationTrainingReserveSpaceSize 1413
+#define RPC___scudaGetDeviceSnapshot 1414
+#define RPC___scudaSetThreadState 1415
+#define RPC___scudaFreeBatch 1416
@@ -6,6 +6,7 @@
 #include <nvml.h>
 
 #include <cstring>
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -21,6 +22,20 @@ extern int rpc_start_response(const void *conn, const int request_id);
 extern int rpc_write(const void *conn, const void *data,
                      const std::size_t size);
 extern int rpc_end_response(const void *conn, void *return_value);
+extern int rpc_defer_error(const void *conn, const int error);
+extern int rpc_merge_deferred_error(const void *conn, const int request_id,
+                                    void *return_value);
+extern void *rpc_arena_alloc(const void *conn, const std::size_t size);
+extern int rpc_server_device(const void *conn, const int device);
+extern int rpc_client_device(const void *conn, const int device);
+extern int rpc_client_device_count(const void *conn, const int count);
+extern int rpc_run_on_stream(const void *conn, const void *stream,
+                             std::function<int()> job);
+extern const void *rpc_real_handle(const void *conn, const void *handle);
+extern void rpc_map_handle(const void *conn, const void *handle,
+                           const void *real);
+extern const void *rpc_unmap_handle(const void *conn, const void *handle);
+extern const void *rpc_virtual_handle(const void *conn, const void *real);
 
 int handle_nvmlInit_v2(void *conn) {
   int request_id;
@@ -90,23 +105,21 @@ int handle_nvmlSystemGetDriverVersion(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlSystemGetDriverVersion(version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -118,23 +131,21 @@ int handle_nvmlSystemGetNVMLVersion(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlSystemGetNVMLVersion(version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -193,23 +204,21 @@ int handle_nvmlSystemGetProcessName(void *conn) {
   if (rpc_read(conn, &pid, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  name = (char *)malloc(length * sizeof(char));
+  name = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlSystemGetProcessName(pid, name, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, name, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -385,24 +394,23 @@ int handle_nvmlUnitGetDevices(void *conn) {
   if (rpc_read(conn, &unit, sizeof(nvmlUnit_t)) < 0 ||
       rpc_read(conn, &deviceCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  devices = (nvmlDevice_t *)malloc(deviceCount * sizeof(nvmlDevice_t));
+  devices = (nvmlDevice_t *)rpc_arena_alloc(
+      conn, deviceCount * sizeof(nvmlDevice_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlUnitGetDevices(unit, &deviceCount, devices);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &deviceCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, devices, deviceCount * sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)devices);
 ERROR_0:
   return -1;
 }
@@ -414,24 +422,23 @@ int handle_nvmlSystemGetHicVersion(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &hwbcCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  hwbcEntries = (nvmlHwbcEntry_t *)malloc(hwbcCount * sizeof(nvmlHwbcEntry_t));
+  hwbcEntries = (nvmlHwbcEntry_t *)rpc_arena_alloc(
+      conn, hwbcCount * sizeof(nvmlHwbcEntry_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlSystemGetHicVersion(&hwbcCount, hwbcEntries);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &hwbcCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, hwbcEntries, hwbcCount * sizeof(nvmlHwbcEntry_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)hwbcEntries);
 ERROR_0:
   return -1;
 }
@@ -447,6 +454,8 @@ int handle_nvmlDeviceGetCount_v2(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetCount_v2(&deviceCount);
+  if (scuda_intercept_result == NVML_SUCCESS)
+    deviceCount = rpc_client_device_count(conn, deviceCount);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &deviceCount, sizeof(unsigned int)) < 0 ||
@@ -492,6 +501,7 @@ int handle_nvmlDeviceGetHandleByIndex_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  index = rpc_server_device(conn, index);
   scuda_intercept_result = nvmlDeviceGetHandleByIndex_v2(index, &device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -512,23 +522,21 @@ int handle_nvmlDeviceGetHandleBySerial(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &serial_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  serial = (const char *)malloc(serial_len);
+  serial = (const char *)rpc_arena_alloc(conn, serial_len);
   if (rpc_read(conn, (void *)serial, serial_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetHandleBySerial(serial, &device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)serial);
 ERROR_0:
   return -1;
 }
@@ -541,23 +549,21 @@ int handle_nvmlDeviceGetHandleByUUID(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &uuid_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  uuid = (const char *)malloc(uuid_len);
+  uuid = (const char *)rpc_arena_alloc(conn, uuid_len);
   if (rpc_read(conn, (void *)uuid, uuid_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetHandleByUUID(uuid, &device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)uuid);
 ERROR_0:
   return -1;
 }
@@ -570,23 +576,21 @@ int handle_nvmlDeviceGetHandleByPciBusId_v2(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &pciBusId_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  pciBusId = (const char *)malloc(pciBusId_len);
+  pciBusId = (const char *)rpc_arena_alloc(conn, pciBusId_len);
   if (rpc_read(conn, (void *)pciBusId, pciBusId_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetHandleByPciBusId_v2(pciBusId, &device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pciBusId);
 ERROR_0:
   return -1;
 }
@@ -600,23 +604,21 @@ int handle_nvmlDeviceGetName(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  name = (char *)malloc(length * sizeof(char));
+  name = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetName(device, name, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, name, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -656,6 +658,8 @@ int handle_nvmlDeviceGetIndex(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetIndex(device, &index);
+  if (scuda_intercept_result == NVML_SUCCESS)
+    index = rpc_client_device(conn, index);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &index, sizeof(unsigned int)) < 0 ||
@@ -676,23 +680,21 @@ int handle_nvmlDeviceGetSerial(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  serial = (char *)malloc(length * sizeof(char));
+  serial = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetSerial(device, serial, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, serial, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)serial);
 ERROR_0:
   return -1;
 }
@@ -707,24 +709,23 @@ int handle_nvmlDeviceGetMemoryAffinity(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &nodeSetSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  nodeSet = (unsigned long *)malloc(nodeSetSize * sizeof(unsigned long));
+  nodeSet = (unsigned long *)rpc_arena_alloc(
+      conn, nodeSetSize * sizeof(unsigned long));
   if (rpc_read(conn, &scope, sizeof(nvmlAffinityScope_t)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetMemoryAffinity(device, nodeSetSize, nodeSet, scope);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, nodeSet, nodeSetSize * sizeof(unsigned long)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)nodeSet);
 ERROR_0:
   return -1;
 }
@@ -739,24 +740,23 @@ int handle_nvmlDeviceGetCpuAffinityWithinScope(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &cpuSetSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  cpuSet = (unsigned long *)malloc(cpuSetSize * sizeof(unsigned long));
+  cpuSet = (unsigned long *)rpc_arena_alloc(
+      conn, cpuSetSize * sizeof(unsigned long));
   if (rpc_read(conn, &scope, sizeof(nvmlAffinityScope_t)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetCpuAffinityWithinScope(device, cpuSetSize, cpuSet, scope);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, cpuSet, cpuSetSize * sizeof(unsigned long)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)cpuSet);
 ERROR_0:
   return -1;
 }
@@ -770,23 +770,22 @@ int handle_nvmlDeviceGetCpuAffinity(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &cpuSetSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  cpuSet = (unsigned long *)malloc(cpuSetSize * sizeof(unsigned long));
+  cpuSet = (unsigned long *)rpc_arena_alloc(
+      conn, cpuSetSize * sizeof(unsigned long));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetCpuAffinity(device, cpuSetSize, cpuSet);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, cpuSet, cpuSetSize * sizeof(unsigned long)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)cpuSet);
 ERROR_0:
   return -1;
 }
@@ -870,13 +869,14 @@ int handle_nvmlDeviceGetTopologyNearestGpus(void *conn) {
       rpc_read(conn, &level, sizeof(nvmlGpuTopologyLevel_t)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  deviceArray = (nvmlDevice_t *)malloc(count * sizeof(nvmlDevice_t));
+  deviceArray = (nvmlDevice_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlDevice_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetTopologyNearestGpus(device, level, &count, deviceArray);
 
@@ -884,11 +884,9 @@ int handle_nvmlDeviceGetTopologyNearestGpus(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, deviceArray, count * sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)deviceArray);
 ERROR_0:
   return -1;
 }
@@ -902,13 +900,14 @@ int handle_nvmlSystemGetTopologyGpuSet(void *conn) {
   if (rpc_read(conn, &cpuNumber, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  deviceArray = (nvmlDevice_t *)malloc(count * sizeof(nvmlDevice_t));
+  deviceArray = (nvmlDevice_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlDevice_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlSystemGetTopologyGpuSet(cpuNumber, &count, deviceArray);
 
@@ -916,11 +915,9 @@ int handle_nvmlSystemGetTopologyGpuSet(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, deviceArray, count * sizeof(nvmlDevice_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)deviceArray);
 ERROR_0:
   return -1;
 }
@@ -962,23 +959,21 @@ int handle_nvmlDeviceGetUUID(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  uuid = (char *)malloc(length * sizeof(char));
+  uuid = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetUUID(device, uuid, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, uuid, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)uuid);
 ERROR_0:
   return -1;
 }
@@ -992,24 +987,22 @@ int handle_nvmlVgpuInstanceGetMdevUUID(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  mdevUuid = (char *)malloc(size * sizeof(char));
+  mdevUuid = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetMdevUUID(vgpuInstance, mdevUuid, size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, mdevUuid, size * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)mdevUuid);
 ERROR_0:
   return -1;
 }
@@ -1046,24 +1039,22 @@ int handle_nvmlDeviceGetBoardPartNumber(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  partNumber = (char *)malloc(length * sizeof(char));
+  partNumber = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetBoardPartNumber(device, partNumber, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, partNumber, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)partNumber);
 ERROR_0:
   return -1;
 }
@@ -1079,24 +1070,22 @@ int handle_nvmlDeviceGetInforomVersion(void *conn) {
       rpc_read(conn, &object, sizeof(nvmlInforomObject_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetInforomVersion(device, object, version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -1110,24 +1099,22 @@ int handle_nvmlDeviceGetInforomImageVersion(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetInforomImageVersion(device, version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -1622,13 +1609,14 @@ int handle_nvmlDeviceGetSupportedMemoryClocks(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  clocksMHz = (unsigned int *)malloc(count * sizeof(unsigned int));
+  clocksMHz = (unsigned int *)rpc_arena_alloc(
+      conn, count * sizeof(unsigned int));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetSupportedMemoryClocks(device, &count, clocksMHz);
 
@@ -1636,11 +1624,9 @@ int handle_nvmlDeviceGetSupportedMemoryClocks(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, clocksMHz, count * sizeof(unsigned int)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)clocksMHz);
 ERROR_0:
   return -1;
 }
@@ -1656,13 +1642,14 @@ int handle_nvmlDeviceGetSupportedGraphicsClocks(void *conn) {
       rpc_read(conn, &memoryClockMHz, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  clocksMHz = (unsigned int *)malloc(count * sizeof(unsigned int));
+  clocksMHz = (unsigned int *)rpc_arena_alloc(
+      conn, count * sizeof(unsigned int));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetSupportedGraphicsClocks(
       device, memoryClockMHz, &count, clocksMHz);
 
@@ -1670,11 +1657,9 @@ int handle_nvmlDeviceGetSupportedGraphicsClocks(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, clocksMHz, count * sizeof(unsigned int)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)clocksMHz);
 ERROR_0:
   return -1;
 }
@@ -2732,14 +2717,14 @@ int handle_nvmlDeviceGetEncoderSessions(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &sessionCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  sessionInfos = (nvmlEncoderSessionInfo_t *)malloc(
-      sessionCount * sizeof(nvmlEncoderSessionInfo_t));
+  sessionInfos = (nvmlEncoderSessionInfo_t *)rpc_arena_alloc(
+      conn, sessionCount * sizeof(nvmlEncoderSessionInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetEncoderSessions(device, &sessionCount, sessionInfos);
 
@@ -2748,11 +2733,9 @@ int handle_nvmlDeviceGetEncoderSessions(void *conn) {
       rpc_write(conn, sessionInfos,
                 sessionCount * sizeof(nvmlEncoderSessionInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)sessionInfos);
 ERROR_0:
   return -1;
 }
@@ -2815,14 +2798,14 @@ int handle_nvmlDeviceGetFBCSessions(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &sessionCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  sessionInfo = (nvmlFBCSessionInfo_t *)malloc(sessionCount *
-                                               sizeof(nvmlFBCSessionInfo_t));
+  sessionInfo = (nvmlFBCSessionInfo_t *)rpc_arena_alloc(
+      conn, sessionCount * sizeof(nvmlFBCSessionInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetFBCSessions(device, &sessionCount, sessionInfo);
 
@@ -2831,11 +2814,9 @@ int handle_nvmlDeviceGetFBCSessions(void *conn) {
       rpc_write(conn, sessionInfo,
                 sessionCount * sizeof(nvmlFBCSessionInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)sessionInfo);
 ERROR_0:
   return -1;
 }
@@ -2874,23 +2855,21 @@ int handle_nvmlDeviceGetVbiosVersion(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetVbiosVersion(device, version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -2929,13 +2908,14 @@ int handle_nvmlDeviceGetComputeRunningProcesses_v3(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &infoCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  infos = (nvmlProcessInfo_t *)malloc(infoCount * sizeof(nvmlProcessInfo_t));
+  infos = (nvmlProcessInfo_t *)rpc_arena_alloc(
+      conn, infoCount * sizeof(nvmlProcessInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetComputeRunningProcesses_v3(device, &infoCount, infos);
 
@@ -2943,11 +2923,9 @@ int handle_nvmlDeviceGetComputeRunningProcesses_v3(void *conn) {
       rpc_write(conn, &infoCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, infos, infoCount * sizeof(nvmlProcessInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)infos);
 ERROR_0:
   return -1;
 }
@@ -2961,13 +2939,14 @@ int handle_nvmlDeviceGetGraphicsRunningProcesses_v3(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &infoCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  infos = (nvmlProcessInfo_t *)malloc(infoCount * sizeof(nvmlProcessInfo_t));
+  infos = (nvmlProcessInfo_t *)rpc_arena_alloc(
+      conn, infoCount * sizeof(nvmlProcessInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetGraphicsRunningProcesses_v3(device, &infoCount, infos);
 
@@ -2975,11 +2954,9 @@ int handle_nvmlDeviceGetGraphicsRunningProcesses_v3(void *conn) {
       rpc_write(conn, &infoCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, infos, infoCount * sizeof(nvmlProcessInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)infos);
 ERROR_0:
   return -1;
 }
@@ -2993,13 +2970,14 @@ int handle_nvmlDeviceGetMPSComputeRunningProcesses_v3(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &infoCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  infos = (nvmlProcessInfo_t *)malloc(infoCount * sizeof(nvmlProcessInfo_t));
+  infos = (nvmlProcessInfo_t *)rpc_arena_alloc(
+      conn, infoCount * sizeof(nvmlProcessInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetMPSComputeRunningProcesses_v3(device, &infoCount, infos);
 
@@ -3007,11 +2985,9 @@ int handle_nvmlDeviceGetMPSComputeRunningProcesses_v3(void *conn) {
       rpc_write(conn, &infoCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, infos, infoCount * sizeof(nvmlProcessInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)infos);
 ERROR_0:
   return -1;
 }
@@ -3082,13 +3058,14 @@ int handle_nvmlDeviceGetSamples(void *conn) {
       rpc_read(conn, &lastSeenTimeStamp, sizeof(unsigned long long)) < 0 ||
       rpc_read(conn, &sampleCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  samples = (nvmlSample_t *)malloc(sampleCount * sizeof(nvmlSample_t));
+  samples = (nvmlSample_t *)rpc_arena_alloc(
+      conn, sampleCount * sizeof(nvmlSample_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetSamples(
       device, type, lastSeenTimeStamp, &sampleValType, &sampleCount, samples);
 
@@ -3097,11 +3074,9 @@ int handle_nvmlDeviceGetSamples(void *conn) {
       rpc_write(conn, &sampleCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, samples, sampleCount * sizeof(nvmlSample_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)samples);
 ERROR_0:
   return -1;
 }
@@ -3375,24 +3350,22 @@ int handle_nvmlDeviceGetAccountingPids(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  pids = (unsigned int *)malloc(count * sizeof(unsigned int));
+  pids = (unsigned int *)rpc_arena_alloc(conn, count * sizeof(unsigned int));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetAccountingPids(device, &count, pids);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, pids, count * sizeof(unsigned int)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pids);
 ERROR_0:
   return -1;
 }
@@ -3432,14 +3405,14 @@ int handle_nvmlDeviceGetRetiredPages(void *conn) {
       rpc_read(conn, &cause, sizeof(nvmlPageRetirementCause_t)) < 0 ||
       rpc_read(conn, &pageCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  addresses =
-      (unsigned long long *)malloc(pageCount * sizeof(unsigned long long));
+  addresses = (unsigned long long *)rpc_arena_alloc(
+      conn, pageCount * sizeof(unsigned long long));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetRetiredPages(device, cause, &pageCount, addresses);
 
@@ -3447,11 +3420,9 @@ int handle_nvmlDeviceGetRetiredPages(void *conn) {
       rpc_write(conn, &pageCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, addresses, pageCount * sizeof(unsigned long long)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)addresses);
 ERROR_0:
   return -1;
 }
@@ -3468,18 +3439,18 @@ int handle_nvmlDeviceGetRetiredPages_v2(void *conn) {
       rpc_read(conn, &cause, sizeof(nvmlPageRetirementCause_t)) < 0 ||
       rpc_read(conn, &pageCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  addresses =
-      (unsigned long long *)malloc(pageCount * sizeof(unsigned long long));
+  addresses = (unsigned long long *)rpc_arena_alloc(
+      conn, pageCount * sizeof(unsigned long long));
   if (false)
-    goto ERROR_1;
-  timestamps =
-      (unsigned long long *)malloc(pageCount * sizeof(unsigned long long));
+    goto ERROR_0;
+  timestamps = (unsigned long long *)rpc_arena_alloc(
+      conn, pageCount * sizeof(unsigned long long));
   if (false)
-    goto ERROR_2;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_2;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetRetiredPages_v2(
       device, cause, &pageCount, addresses, timestamps);
 
@@ -3488,13 +3459,9 @@ int handle_nvmlDeviceGetRetiredPages_v2(void *conn) {
       rpc_write(conn, addresses, pageCount * sizeof(unsigned long long)) < 0 ||
       rpc_write(conn, timestamps, pageCount * sizeof(unsigned long long)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_2;
+    goto ERROR_0;
 
   return 0;
-ERROR_2:
-  free((void *)addresses);
-ERROR_1:
-  free((void *)timestamps);
 ERROR_0:
   return -1;
 }
@@ -4545,24 +4512,23 @@ int handle_nvmlDeviceGetFieldValues(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &valuesCount, sizeof(int)) < 0 || false)
     goto ERROR_0;
-  values = (nvmlFieldValue_t *)malloc(valuesCount * sizeof(nvmlFieldValue_t));
+  values = (nvmlFieldValue_t *)rpc_arena_alloc(
+      conn, valuesCount * sizeof(nvmlFieldValue_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetFieldValues(device, valuesCount, values);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, values, valuesCount * sizeof(nvmlFieldValue_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)values);
 ERROR_0:
   return -1;
 }
@@ -4576,24 +4542,23 @@ int handle_nvmlDeviceClearFieldValues(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &valuesCount, sizeof(int)) < 0 || false)
     goto ERROR_0;
-  values = (nvmlFieldValue_t *)malloc(valuesCount * sizeof(nvmlFieldValue_t));
+  values = (nvmlFieldValue_t *)rpc_arena_alloc(
+      conn, valuesCount * sizeof(nvmlFieldValue_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceClearFieldValues(device, valuesCount, values);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, values, valuesCount * sizeof(nvmlFieldValue_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)values);
 ERROR_0:
   return -1;
 }
@@ -4704,15 +4669,15 @@ int handle_nvmlDeviceGetProcessUtilization(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &processSamplesCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  utilization = (nvmlProcessUtilizationSample_t *)malloc(
-      processSamplesCount * sizeof(nvmlProcessUtilizationSample_t));
+  utilization = (nvmlProcessUtilizationSample_t *)rpc_arena_alloc(
+      conn, processSamplesCount * sizeof(nvmlProcessUtilizationSample_t));
   if (rpc_read(conn, &lastSeenTimeStamp, sizeof(unsigned long long)) < 0 ||
       false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetProcessUtilization(
       device, utilization, &processSamplesCount, lastSeenTimeStamp);
 
@@ -4722,11 +4687,9 @@ int handle_nvmlDeviceGetProcessUtilization(void *conn) {
                 processSamplesCount * sizeof(nvmlProcessUtilizationSample_t)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)utilization);
 ERROR_0:
   return -1;
 }
@@ -4841,14 +4804,14 @@ int handle_nvmlDeviceGetSupportedVgpus(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &vgpuCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuTypeIds =
-      (nvmlVgpuTypeId_t *)malloc(vgpuCount * sizeof(nvmlVgpuTypeId_t));
+  vgpuTypeIds = (nvmlVgpuTypeId_t *)rpc_arena_alloc(
+      conn, vgpuCount * sizeof(nvmlVgpuTypeId_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetSupportedVgpus(device, &vgpuCount, vgpuTypeIds);
 
@@ -4856,11 +4819,9 @@ int handle_nvmlDeviceGetSupportedVgpus(void *conn) {
       rpc_write(conn, &vgpuCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, vgpuTypeIds, vgpuCount * sizeof(nvmlVgpuTypeId_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuTypeIds);
 ERROR_0:
   return -1;
 }
@@ -4874,14 +4835,14 @@ int handle_nvmlDeviceGetCreatableVgpus(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &vgpuCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuTypeIds =
-      (nvmlVgpuTypeId_t *)malloc(vgpuCount * sizeof(nvmlVgpuTypeId_t));
+  vgpuTypeIds = (nvmlVgpuTypeId_t *)rpc_arena_alloc(
+      conn, vgpuCount * sizeof(nvmlVgpuTypeId_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetCreatableVgpus(device, &vgpuCount, vgpuTypeIds);
 
@@ -4889,11 +4850,9 @@ int handle_nvmlDeviceGetCreatableVgpus(void *conn) {
       rpc_write(conn, &vgpuCount, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, vgpuTypeIds, vgpuCount * sizeof(nvmlVgpuTypeId_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuTypeIds);
 ERROR_0:
   return -1;
 }
@@ -4906,13 +4865,13 @@ int handle_nvmlVgpuTypeGetClass(void *conn) {
   nvmlReturn_t scuda_intercept_result;
   if (rpc_read(conn, &vgpuTypeId, sizeof(nvmlVgpuTypeId_t)) < 0 || false)
     goto ERROR_0;
-  vgpuTypeClass = (char *)malloc(size * sizeof(char));
+  vgpuTypeClass = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuTypeGetClass(vgpuTypeId, vgpuTypeClass, &size);
 
@@ -4920,11 +4879,9 @@ int handle_nvmlVgpuTypeGetClass(void *conn) {
       rpc_write(conn, &size, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, vgpuTypeClass, size * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuTypeClass);
 ERROR_0:
   return -1;
 }
@@ -4938,24 +4895,22 @@ int handle_nvmlVgpuTypeGetName(void *conn) {
   if (rpc_read(conn, &vgpuTypeId, sizeof(nvmlVgpuTypeId_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuTypeName = (char *)malloc(size * sizeof(char));
+  vgpuTypeName = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlVgpuTypeGetName(vgpuTypeId, vgpuTypeName, &size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &size, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, vgpuTypeName, size * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuTypeName);
 ERROR_0:
   return -1;
 }
@@ -5094,24 +5049,22 @@ int handle_nvmlVgpuTypeGetLicense(void *conn) {
   if (rpc_read(conn, &vgpuTypeId, sizeof(nvmlVgpuTypeId_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuTypeLicenseString = (char *)malloc(size * sizeof(char));
+  vgpuTypeLicenseString = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuTypeGetLicense(vgpuTypeId, vgpuTypeLicenseString, size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, vgpuTypeLicenseString, size * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuTypeLicenseString);
 ERROR_0:
   return -1;
 }
@@ -5199,14 +5152,14 @@ int handle_nvmlDeviceGetActiveVgpus(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &vgpuCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuInstances =
-      (nvmlVgpuInstance_t *)malloc(vgpuCount * sizeof(nvmlVgpuInstance_t));
+  vgpuInstances = (nvmlVgpuInstance_t *)rpc_arena_alloc(
+      conn, vgpuCount * sizeof(nvmlVgpuInstance_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetActiveVgpus(device, &vgpuCount, vgpuInstances);
 
@@ -5215,11 +5168,9 @@ int handle_nvmlDeviceGetActiveVgpus(void *conn) {
       rpc_write(conn, vgpuInstances, vgpuCount * sizeof(nvmlVgpuInstance_t)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuInstances);
 ERROR_0:
   return -1;
 }
@@ -5234,13 +5185,13 @@ int handle_nvmlVgpuInstanceGetVmID(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vmId = (char *)malloc(size * sizeof(char));
+  vmId = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetVmID(vgpuInstance, vmId, size, &vmIdType);
 
@@ -5248,11 +5199,9 @@ int handle_nvmlVgpuInstanceGetVmID(void *conn) {
       rpc_write(conn, vmId, size * sizeof(char)) < 0 ||
       rpc_write(conn, &vmIdType, sizeof(nvmlVgpuVmIdType_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vmId);
 ERROR_0:
   return -1;
 }
@@ -5266,23 +5215,21 @@ int handle_nvmlVgpuInstanceGetUUID(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  uuid = (char *)malloc(size * sizeof(char));
+  uuid = (char *)rpc_arena_alloc(conn, size * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlVgpuInstanceGetUUID(vgpuInstance, uuid, size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, uuid, size * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)uuid);
 ERROR_0:
   return -1;
 }
@@ -5296,24 +5243,22 @@ int handle_nvmlVgpuInstanceGetVmDriverVersion(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  version = (char *)malloc(length * sizeof(char));
+  version = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetVmDriverVersion(vgpuInstance, version, length);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, version, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)version);
 ERROR_0:
   return -1;
 }
@@ -5520,14 +5465,14 @@ int handle_nvmlVgpuInstanceGetEncoderSessions(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &sessionCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  sessionInfo = (nvmlEncoderSessionInfo_t *)malloc(
-      sessionCount * sizeof(nvmlEncoderSessionInfo_t));
+  sessionInfo = (nvmlEncoderSessionInfo_t *)rpc_arena_alloc(
+      conn, sessionCount * sizeof(nvmlEncoderSessionInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlVgpuInstanceGetEncoderSessions(
       vgpuInstance, &sessionCount, sessionInfo);
 
@@ -5536,11 +5481,9 @@ int handle_nvmlVgpuInstanceGetEncoderSessions(void *conn) {
       rpc_write(conn, sessionInfo,
                 sessionCount * sizeof(nvmlEncoderSessionInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)sessionInfo);
 ERROR_0:
   return -1;
 }
@@ -5577,14 +5520,14 @@ int handle_nvmlVgpuInstanceGetFBCSessions(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &sessionCount, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  sessionInfo = (nvmlFBCSessionInfo_t *)malloc(sessionCount *
-                                               sizeof(nvmlFBCSessionInfo_t));
+  sessionInfo = (nvmlFBCSessionInfo_t *)rpc_arena_alloc(
+      conn, sessionCount * sizeof(nvmlFBCSessionInfo_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetFBCSessions(vgpuInstance, &sessionCount, sessionInfo);
 
@@ -5593,11 +5536,9 @@ int handle_nvmlVgpuInstanceGetFBCSessions(void *conn) {
       rpc_write(conn, sessionInfo,
                 sessionCount * sizeof(nvmlFBCSessionInfo_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)sessionInfo);
 ERROR_0:
   return -1;
 }
@@ -5635,13 +5576,13 @@ int handle_nvmlVgpuInstanceGetGpuPciId(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &length, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuPciId = (char *)malloc(length * sizeof(char));
+  vgpuPciId = (char *)rpc_arena_alloc(conn, length * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetGpuPciId(vgpuInstance, vgpuPciId, &length);
 
@@ -5649,11 +5590,9 @@ int handle_nvmlVgpuInstanceGetGpuPciId(void *conn) {
       rpc_write(conn, &length, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, vgpuPciId, length * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuPciId);
 ERROR_0:
   return -1;
 }
@@ -5693,14 +5632,14 @@ int handle_nvmlVgpuInstanceGetMetadata(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &bufferSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  vgpuMetadata =
-      (nvmlVgpuMetadata_t *)malloc(bufferSize * sizeof(nvmlVgpuMetadata_t));
+  vgpuMetadata = (nvmlVgpuMetadata_t *)rpc_arena_alloc(
+      conn, bufferSize * sizeof(nvmlVgpuMetadata_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetMetadata(vgpuInstance, vgpuMetadata, &bufferSize);
 
@@ -5709,11 +5648,9 @@ int handle_nvmlVgpuInstanceGetMetadata(void *conn) {
       rpc_write(conn, vgpuMetadata, bufferSize * sizeof(nvmlVgpuMetadata_t)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)vgpuMetadata);
 ERROR_0:
   return -1;
 }
@@ -5727,14 +5664,14 @@ int handle_nvmlDeviceGetVgpuMetadata(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &bufferSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  pgpuMetadata = (nvmlVgpuPgpuMetadata_t *)malloc(
-      bufferSize * sizeof(nvmlVgpuPgpuMetadata_t));
+  pgpuMetadata = (nvmlVgpuPgpuMetadata_t *)rpc_arena_alloc(
+      conn, bufferSize * sizeof(nvmlVgpuPgpuMetadata_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetVgpuMetadata(device, pgpuMetadata, &bufferSize);
 
@@ -5743,11 +5680,9 @@ int handle_nvmlDeviceGetVgpuMetadata(void *conn) {
       rpc_write(conn, pgpuMetadata,
                 bufferSize * sizeof(nvmlVgpuPgpuMetadata_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pgpuMetadata);
 ERROR_0:
   return -1;
 }
@@ -5789,13 +5724,13 @@ int handle_nvmlDeviceGetPgpuMetadataString(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &bufferSize, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  pgpuMetadata = (char *)malloc(bufferSize * sizeof(char));
+  pgpuMetadata = (char *)rpc_arena_alloc(conn, bufferSize * sizeof(char));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetPgpuMetadataString(device, pgpuMetadata, &bufferSize);
 
@@ -5803,11 +5738,9 @@ int handle_nvmlDeviceGetPgpuMetadataString(void *conn) {
       rpc_write(conn, &bufferSize, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, pgpuMetadata, bufferSize * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pgpuMetadata);
 ERROR_0:
   return -1;
 }
@@ -5946,14 +5879,15 @@ int handle_nvmlDeviceGetVgpuUtilization(void *conn) {
       rpc_read(conn, &vgpuInstanceSamplesCount, sizeof(unsigned int)) < 0 ||
       false)
     goto ERROR_0;
-  utilizationSamples = (nvmlVgpuInstanceUtilizationSample_t *)malloc(
+  utilizationSamples = (nvmlVgpuInstanceUtilizationSample_t *)rpc_arena_alloc(
+      conn,
       vgpuInstanceSamplesCount * sizeof(nvmlVgpuInstanceUtilizationSample_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetVgpuUtilization(
       device, lastSeenTimeStamp, &sampleValType, &vgpuInstanceSamplesCount,
       utilizationSamples);
@@ -5965,11 +5899,9 @@ int handle_nvmlDeviceGetVgpuUtilization(void *conn) {
                 vgpuInstanceSamplesCount *
                     sizeof(nvmlVgpuInstanceUtilizationSample_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)utilizationSamples);
 ERROR_0:
   return -1;
 }
@@ -5986,14 +5918,15 @@ int handle_nvmlDeviceGetVgpuProcessUtilization(void *conn) {
       rpc_read(conn, &vgpuProcessSamplesCount, sizeof(unsigned int)) < 0 ||
       false)
     goto ERROR_0;
-  utilizationSamples = (nvmlVgpuProcessUtilizationSample_t *)malloc(
+  utilizationSamples = (nvmlVgpuProcessUtilizationSample_t *)rpc_arena_alloc(
+      conn,
       vgpuProcessSamplesCount * sizeof(nvmlVgpuProcessUtilizationSample_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetVgpuProcessUtilization(
       device, lastSeenTimeStamp, &vgpuProcessSamplesCount, utilizationSamples);
 
@@ -6003,11 +5936,9 @@ int handle_nvmlDeviceGetVgpuProcessUtilization(void *conn) {
                 vgpuProcessSamplesCount *
                     sizeof(nvmlVgpuProcessUtilizationSample_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)utilizationSamples);
 ERROR_0:
   return -1;
 }
@@ -6045,13 +5976,13 @@ int handle_nvmlVgpuInstanceGetAccountingPids(void *conn) {
   if (rpc_read(conn, &vgpuInstance, sizeof(nvmlVgpuInstance_t)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  pids = (unsigned int *)malloc(count * sizeof(unsigned int));
+  pids = (unsigned int *)rpc_arena_alloc(conn, count * sizeof(unsigned int));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlVgpuInstanceGetAccountingPids(vgpuInstance, &count, pids);
 
@@ -6059,11 +5990,9 @@ int handle_nvmlVgpuInstanceGetAccountingPids(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, pids, count * sizeof(unsigned int)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pids);
 ERROR_0:
   return -1;
 }
@@ -6299,14 +6228,14 @@ int handle_nvmlDeviceGetGpuInstancePossiblePlacements_v2(void *conn) {
       rpc_read(conn, &profileId, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  placements = (nvmlGpuInstancePlacement_t *)malloc(
-      count * sizeof(nvmlGpuInstancePlacement_t));
+  placements = (nvmlGpuInstancePlacement_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlGpuInstancePlacement_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlDeviceGetGpuInstancePossiblePlacements_v2(
       device, profileId, placements, &count);
 
@@ -6315,11 +6244,9 @@ int handle_nvmlDeviceGetGpuInstancePossiblePlacements_v2(void *conn) {
       rpc_write(conn, placements, count * sizeof(nvmlGpuInstancePlacement_t)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)placements);
 ERROR_0:
   return -1;
 }
@@ -6408,13 +6335,14 @@ int handle_nvmlDeviceGetGpuInstances(void *conn) {
       rpc_read(conn, &profileId, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  gpuInstances = (nvmlGpuInstance_t *)malloc(count * sizeof(nvmlGpuInstance_t));
+  gpuInstances = (nvmlGpuInstance_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlGpuInstance_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetGpuInstances(device, profileId, gpuInstances, &count);
 
@@ -6422,11 +6350,9 @@ int handle_nvmlDeviceGetGpuInstances(void *conn) {
       rpc_write(conn, &count, sizeof(unsigned int)) < 0 ||
       rpc_write(conn, gpuInstances, count * sizeof(nvmlGpuInstance_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)gpuInstances);
 ERROR_0:
   return -1;
 }
@@ -6573,14 +6499,14 @@ int handle_nvmlGpuInstanceGetComputeInstancePossiblePlacements(void *conn) {
       rpc_read(conn, &profileId, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  placements = (nvmlComputeInstancePlacement_t *)malloc(
-      count * sizeof(nvmlComputeInstancePlacement_t));
+  placements = (nvmlComputeInstancePlacement_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlComputeInstancePlacement_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlGpuInstanceGetComputeInstancePossiblePlacements(
       gpuInstance, profileId, placements, &count);
 
@@ -6589,11 +6515,9 @@ int handle_nvmlGpuInstanceGetComputeInstancePossiblePlacements(void *conn) {
       rpc_write(conn, placements,
                 count * sizeof(nvmlComputeInstancePlacement_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)placements);
 ERROR_0:
   return -1;
 }
@@ -6657,14 +6581,14 @@ int handle_nvmlGpuInstanceGetComputeInstances(void *conn) {
       rpc_read(conn, &profileId, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &count, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  computeInstances =
-      (nvmlComputeInstance_t *)malloc(count * sizeof(nvmlComputeInstance_t));
+  computeInstances = (nvmlComputeInstance_t *)rpc_arena_alloc(
+      conn, count * sizeof(nvmlComputeInstance_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = nvmlGpuInstanceGetComputeInstances(
       gpuInstance, profileId, computeInstances, &count);
 
@@ -6673,11 +6597,9 @@ int handle_nvmlGpuInstanceGetComputeInstances(void *conn) {
       rpc_write(conn, computeInstances, count * sizeof(nvmlComputeInstance_t)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)computeInstances);
 ERROR_0:
   return -1;
 }
@@ -7079,24 +7001,23 @@ int handle_nvmlDeviceGetSupportedPerformanceStates(void *conn) {
   if (rpc_read(conn, &device, sizeof(nvmlDevice_t)) < 0 ||
       rpc_read(conn, &size, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
-  pstates = (nvmlPstates_t *)malloc(size * sizeof(nvmlPstates_t));
+  pstates = (nvmlPstates_t *)rpc_arena_alloc(
+      conn, size * sizeof(nvmlPstates_t));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       nvmlDeviceGetSupportedPerformanceStates(device, pstates, size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, pstates, size * sizeof(nvmlPstates_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pstates);
 ERROR_0:
   return -1;
 }
@@ -7391,7 +7312,10 @@ int handle_cuDeviceGet(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  ordinal = rpc_server_device(conn, ordinal);
   scuda_intercept_result = cuDeviceGet(&device, ordinal);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    device = rpc_client_device(conn, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(CUdevice)) < 0 ||
@@ -7414,6 +7338,8 @@ int handle_cuDeviceGetCount(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cuDeviceGetCount(&count);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    count = rpc_client_device_count(conn, count);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &count, sizeof(int)) < 0 ||
@@ -7433,23 +7359,22 @@ int handle_cuDeviceGetName(void *conn) {
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &len, sizeof(int)) < 0 || false)
     goto ERROR_0;
-  name = (char *)malloc(len * sizeof(char));
+  name = (char *)rpc_arena_alloc(conn, len * sizeof(char));
   if (rpc_read(conn, &dev, sizeof(CUdevice)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetName(name, len, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, name, len * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -7461,23 +7386,22 @@ int handle_cuDeviceGetUuid(void *conn) {
   CUresult scuda_intercept_result;
   if (false)
     goto ERROR_0;
-  uuid = (CUuuid *)malloc(16 * sizeof(CUuuid));
+  uuid = (CUuuid *)rpc_arena_alloc(conn, 16 * sizeof(CUuuid));
   if (rpc_read(conn, &dev, sizeof(CUdevice)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetUuid(uuid, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, uuid, 16) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)uuid);
 ERROR_0:
   return -1;
 }
@@ -7489,23 +7413,22 @@ int handle_cuDeviceGetUuid_v2(void *conn) {
   CUresult scuda_intercept_result;
   if (false)
     goto ERROR_0;
-  uuid = (CUuuid *)malloc(16 * sizeof(CUuuid));
+  uuid = (CUuuid *)rpc_arena_alloc(conn, 16 * sizeof(CUuuid));
   if (rpc_read(conn, &dev, sizeof(CUdevice)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetUuid_v2(uuid, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, uuid, 16) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)uuid);
 ERROR_0:
   return -1;
 }
@@ -7523,6 +7446,7 @@ int handle_cuDeviceGetLuid(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetLuid(luid, &deviceNodeMask, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7548,6 +7472,7 @@ int handle_cuDeviceTotalMem_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceTotalMem_v2(&bytes, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7575,6 +7500,7 @@ int handle_cuDeviceGetTexture1DLinearMaxWidth(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetTexture1DLinearMaxWidth(
       &maxWidthInElements, format, numChannels, dev);
 
@@ -7601,6 +7527,7 @@ int handle_cuDeviceGetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetAttribute(&pi, attrib, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7625,6 +7552,7 @@ int handle_cuDeviceSetMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceSetMemPool(dev, pool);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7647,6 +7575,7 @@ int handle_cuDeviceGetMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetMemPool(&pool, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7670,6 +7599,7 @@ int handle_cuDeviceGetDefaultMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetDefaultMemPool(&pool_out, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7695,6 +7625,7 @@ int handle_cuDeviceGetExecAffinitySupport(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetExecAffinitySupport(&pi, type, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7742,6 +7673,7 @@ int handle_cuDeviceGetProperties(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetProperties(&prop, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7766,6 +7698,7 @@ int handle_cuDeviceComputeCapability(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceComputeCapability(&major, &minor, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7790,6 +7723,7 @@ int handle_cuDevicePrimaryCtxRetain(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDevicePrimaryCtxRetain(&pctx, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7812,6 +7746,7 @@ int handle_cuDevicePrimaryCtxRelease_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDevicePrimaryCtxRelease_v2(dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7835,6 +7770,7 @@ int handle_cuDevicePrimaryCtxSetFlags_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDevicePrimaryCtxSetFlags_v2(dev, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7858,6 +7794,7 @@ int handle_cuDevicePrimaryCtxGetState(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDevicePrimaryCtxGetState(dev, &flags, &active);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7881,6 +7818,7 @@ int handle_cuDevicePrimaryCtxReset_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDevicePrimaryCtxReset_v2(dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7905,6 +7843,7 @@ int handle_cuCtxCreate_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuCtxCreate_v2(&pctx, flags, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -7927,15 +7866,16 @@ int handle_cuCtxCreate_v3(void *conn) {
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &numParams, sizeof(int)) < 0 || false)
     goto ERROR_0;
-  paramsArray =
-      (CUexecAffinityParam *)malloc(numParams * sizeof(CUexecAffinityParam));
+  paramsArray = (CUexecAffinityParam *)rpc_arena_alloc(
+      conn, numParams * sizeof(CUexecAffinityParam));
   if (rpc_read(conn, &flags, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, &dev, sizeof(CUdevice)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result =
       cuCtxCreate_v3(&pctx, paramsArray, numParams, flags, dev);
 
@@ -7944,11 +7884,9 @@ int handle_cuCtxCreate_v3(void *conn) {
       rpc_write(conn, paramsArray, numParams * sizeof(CUexecAffinityParam)) <
           0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)paramsArray);
 ERROR_0:
   return -1;
 }
@@ -8071,6 +8009,8 @@ int handle_cuCtxGetDevice(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cuCtxGetDevice(&device);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    device = rpc_client_device(conn, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(CUdevice)) < 0 ||
@@ -8422,23 +8362,21 @@ int handle_cuModuleLoad(void *conn) {
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &fname_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  fname = (const char *)malloc(fname_len);
+  fname = (const char *)rpc_arena_alloc(conn, fname_len);
   if (rpc_read(conn, (void *)fname, fname_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuModuleLoad(&module, fname);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &module, sizeof(CUmodule)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)fname);
 ERROR_0:
   return -1;
 }
@@ -8496,23 +8434,21 @@ int handle_cuModuleGetFunction(void *conn) {
   if (rpc_read(conn, &hmod, sizeof(CUmodule)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuModuleGetFunction(&hfunc, hmod, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &hfunc, sizeof(CUfunction)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8528,24 +8464,22 @@ int handle_cuModuleGetGlobal_v2(void *conn) {
   if (rpc_read(conn, &hmod, sizeof(CUmodule)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuModuleGetGlobal_v2(&dptr, &bytes, hmod, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &dptr, sizeof(CUdeviceptr)) < 0 ||
       rpc_write(conn, &bytes, sizeof(size_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8595,26 +8529,24 @@ int handle_cuLinkAddFile_v2(void *conn) {
       rpc_read(conn, &type, sizeof(CUjitInputType)) < 0 ||
       rpc_read(conn, &path_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  path = (const char *)malloc(path_len);
+  path = (const char *)rpc_arena_alloc(conn, path_len);
   if (rpc_read(conn, (void *)path, path_len) < 0 ||
       rpc_read(conn, &numOptions, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, options, numOptions * sizeof(CUjit_option)) < 0 ||
       rpc_read(conn, optionValues, numOptions * sizeof(void *)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result =
       cuLinkAddFile_v2(state, type, path, numOptions, options, optionValues);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)path);
 ERROR_0:
   return -1;
 }
@@ -8675,23 +8607,21 @@ int handle_cuModuleGetTexRef(void *conn) {
   if (rpc_read(conn, &hmod, sizeof(CUmodule)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuModuleGetTexRef(&pTexRef, hmod, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &pTexRef, sizeof(CUtexref)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8706,23 +8636,21 @@ int handle_cuModuleGetSurfRef(void *conn) {
   if (rpc_read(conn, &hmod, sizeof(CUmodule)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuModuleGetSurfRef(&pSurfRef, hmod, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &pSurfRef, sizeof(CUsurfref)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8741,7 +8669,7 @@ int handle_cuLibraryLoadFromFile(void *conn) {
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &fileName_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  fileName = (const char *)malloc(fileName_len);
+  fileName = (const char *)rpc_arena_alloc(conn, fileName_len);
   if (rpc_read(conn, (void *)fileName, fileName_len) < 0 ||
       rpc_read(conn, &numJitOptions, sizeof(unsigned int)) < 0 ||
       rpc_read(conn, jitOptions, numJitOptions * sizeof(CUjit_option)) < 0 ||
@@ -8752,11 +8680,11 @@ int handle_cuLibraryLoadFromFile(void *conn) {
       rpc_read(conn, libraryOptionValues, numLibraryOptions * sizeof(void *)) <
           0 ||
       false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuLibraryLoadFromFile(
       &library, fileName, jitOptions, jitOptionsValues, numJitOptions,
       libraryOptions, libraryOptionValues, numLibraryOptions);
@@ -8764,11 +8692,9 @@ int handle_cuLibraryLoadFromFile(void *conn) {
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &library, sizeof(CUlibrary)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)fileName);
 ERROR_0:
   return -1;
 }
@@ -8804,23 +8730,21 @@ int handle_cuLibraryGetKernel(void *conn) {
   if (rpc_read(conn, &library, sizeof(CUlibrary)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuLibraryGetKernel(&pKernel, library, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &pKernel, sizeof(CUkernel)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8882,24 +8806,22 @@ int handle_cuLibraryGetGlobal(void *conn) {
   if (rpc_read(conn, &library, sizeof(CUlibrary)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuLibraryGetGlobal(&dptr, &bytes, library, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &dptr, sizeof(CUdeviceptr)) < 0 ||
       rpc_write(conn, &bytes, sizeof(size_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8915,24 +8837,22 @@ int handle_cuLibraryGetManaged(void *conn) {
   if (rpc_read(conn, &library, sizeof(CUlibrary)) < 0 ||
       rpc_read(conn, &name_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  name = (const char *)malloc(name_len);
+  name = (const char *)rpc_arena_alloc(conn, name_len);
   if (rpc_read(conn, (void *)name, name_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuLibraryGetManaged(&dptr, &bytes, library, name);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &dptr, sizeof(CUdeviceptr)) < 0 ||
       rpc_write(conn, &bytes, sizeof(size_t)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)name);
 ERROR_0:
   return -1;
 }
@@ -8947,23 +8867,21 @@ int handle_cuLibraryGetUnifiedFunction(void *conn) {
   if (rpc_read(conn, &library, sizeof(CUlibrary)) < 0 ||
       rpc_read(conn, &symbol_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  symbol = (const char *)malloc(symbol_len);
+  symbol = (const char *)rpc_arena_alloc(conn, symbol_len);
   if (rpc_read(conn, (void *)symbol, symbol_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuLibraryGetUnifiedFunction(&fptr, library, symbol);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &fptr, sizeof(void *)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)symbol);
 ERROR_0:
   return -1;
 }
@@ -8984,6 +8902,7 @@ int handle_cuKernelGetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuKernelGetAttribute(&pi, attrib, kernel, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -9012,6 +8931,7 @@ int handle_cuKernelSetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuKernelSetAttribute(attrib, val, kernel, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -9037,6 +8957,7 @@ int handle_cuKernelSetCacheConfig(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuKernelSetCacheConfig(kernel, config, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -9331,23 +9252,23 @@ int handle_cuDeviceGetByPCIBusId(void *conn) {
   if (rpc_read(conn, &dev, sizeof(CUdevice)) < 0 ||
       rpc_read(conn, &pciBusId_len, sizeof(std::size_t)) < 0)
     goto ERROR_0;
-  pciBusId = (const char *)malloc(pciBusId_len);
+  pciBusId = (const char *)rpc_arena_alloc(conn, pciBusId_len);
   if (rpc_read(conn, (void *)pciBusId, pciBusId_len) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
   scuda_intercept_result = cuDeviceGetByPCIBusId(&dev, pciBusId);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    dev = rpc_client_device(conn, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &dev, sizeof(CUdevice)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pciBusId);
 ERROR_0:
   return -1;
 }
@@ -9360,23 +9281,22 @@ int handle_cuDeviceGetPCIBusId(void *conn) {
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &len, sizeof(int)) < 0 || false)
     goto ERROR_0;
-  pciBusId = (char *)malloc(len * sizeof(char));
+  pciBusId = (char *)rpc_arena_alloc(conn, len * sizeof(char));
   if (rpc_read(conn, &dev, sizeof(CUdevice)) < 0 || false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
   scuda_intercept_result = cuDeviceGetPCIBusId(pciBusId, len, dev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, pciBusId, len * sizeof(char)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)pciBusId);
 ERROR_0:
   return -1;
 }
@@ -9393,6 +9313,7 @@ int handle_cuIpcGetEventHandle(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cuIpcGetEventHandle(&pHandle, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -9418,6 +9339,7 @@ int handle_cuIpcOpenEventHandle(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cuIpcOpenEventHandle(&phEvent, handle);
+  phEvent = (CUevent)rpc_virtual_handle(conn, (const void *)phEvent);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &phEvent, sizeof(CUevent)) < 0 ||
@@ -9735,6 +9657,7 @@ int handle_cuMemcpyAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemcpyAsync(dst, src, ByteCount, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -9766,6 +9689,7 @@ int handle_cuMemcpyPeerAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemcpyPeerAsync(dstDevice, dstContext, srcDevice,
                                              srcContext, ByteCount, hStream);
 
@@ -9794,6 +9718,7 @@ int handle_cuMemcpyHtoDAsync_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemcpyHtoDAsync_v2(dstDevice, srcHost, ByteCount, hStream);
 
@@ -9822,6 +9747,7 @@ int handle_cuMemcpyDtoDAsync_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemcpyDtoDAsync_v2(dstDevice, srcDevice, ByteCount, hStream);
 
@@ -10015,6 +9941,7 @@ int handle_cuMemsetD8Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemsetD8Async(dstDevice, uc, N, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10042,6 +9969,7 @@ int handle_cuMemsetD16Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemsetD16Async(dstDevice, us, N, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10069,6 +9997,7 @@ int handle_cuMemsetD32Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemsetD32Async(dstDevice, ui, N, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10100,6 +10029,7 @@ int handle_cuMemsetD2D8Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemsetD2D8Async(dstDevice, dstPitch, uc, Width, Height, hStream);
 
@@ -10132,6 +10062,7 @@ int handle_cuMemsetD2D16Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemsetD2D16Async(dstDevice, dstPitch, us, Width, Height, hStream);
 
@@ -10164,6 +10095,7 @@ int handle_cuMemsetD2D32Async(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemsetD2D32Async(dstDevice, dstPitch, ui, Width, Height, hStream);
 
@@ -10294,6 +10226,7 @@ int handle_cuArrayGetMemoryRequirements(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result =
       cuArrayGetMemoryRequirements(&memoryRequirements, array, device);
 
@@ -10323,6 +10256,7 @@ int handle_cuMipmappedArrayGetMemoryRequirements(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cuMipmappedArrayGetMemoryRequirements(
       &memoryRequirements, mipmap, device);
 
@@ -10657,6 +10591,7 @@ int handle_cuMemMapArrayAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemMapArrayAsync(&mapInfoList, count, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10811,6 +10746,7 @@ int handle_cuMemFreeAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemFreeAsync(dptr, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10836,6 +10772,7 @@ int handle_cuMemAllocAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuMemAllocAsync(&dptr, bytesize, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -10984,6 +10921,7 @@ int handle_cuMemAllocFromPoolAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemAllocFromPoolAsync(&dptr, bytesize, pool, hStream);
 
@@ -11064,6 +11002,8 @@ int handle_cuMemPrefetchAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dstDevice = rpc_server_device(conn, dstDevice);
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuMemPrefetchAsync(devPtr, count, dstDevice, hStream);
 
@@ -11092,6 +11032,7 @@ int handle_cuMemAdvise(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cuMemAdvise(devPtr, count, advice, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11197,6 +11138,7 @@ int handle_cuStreamCreate(void *conn) {
   CUstream phStream;
   unsigned int Flags;
   int request_id;
+  const void *scuda_virtual_handle;
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &phStream, sizeof(CUstream)) < 0 ||
       rpc_read(conn, &Flags, sizeof(unsigned int)) < 0 || false)
@@ -11205,11 +11147,14 @@ int handle_cuStreamCreate(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)phStream;
   scuda_intercept_result = cuStreamCreate(&phStream, Flags);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)phStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &phStream, sizeof(CUstream)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDA_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -11222,6 +11167,7 @@ int handle_cuStreamCreateWithPriority(void *conn) {
   unsigned int flags;
   int priority;
   int request_id;
+  const void *scuda_virtual_handle;
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &phStream, sizeof(CUstream)) < 0 ||
       rpc_read(conn, &flags, sizeof(unsigned int)) < 0 ||
@@ -11231,12 +11177,15 @@ int handle_cuStreamCreateWithPriority(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)phStream;
   scuda_intercept_result =
       cuStreamCreateWithPriority(&phStream, flags, priority);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)phStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &phStream, sizeof(CUstream)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDA_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -11256,6 +11205,7 @@ int handle_cuStreamGetPriority(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamGetPriority(hStream, &priority);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11280,6 +11230,7 @@ int handle_cuStreamGetFlags(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamGetFlags(hStream, &flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11304,6 +11255,7 @@ int handle_cuStreamGetId(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamGetId(hStream, &streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11328,6 +11280,7 @@ int handle_cuStreamGetCtx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamGetCtx(hStream, &pctx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11354,6 +11307,8 @@ int handle_cuStreamWaitEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
+  hEvent = (CUevent)rpc_real_handle(conn, (const void *)hEvent);
   scuda_intercept_result = cuStreamWaitEvent(hStream, hEvent, Flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11377,6 +11332,7 @@ int handle_cuStreamBeginCapture_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamBeginCapture_v2(hStream, mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11422,6 +11378,7 @@ int handle_cuStreamEndCapture(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamEndCapture(hStream, &phGraph);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11447,6 +11404,7 @@ int handle_cuStreamIsCapturing(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamIsCapturing(hStream, &captureStatus);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11475,6 +11433,7 @@ int handle_cuStreamUpdateCaptureDependencies(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamUpdateCaptureDependencies(
       hStream, &dependencies, numDependencies, flags);
 
@@ -11504,6 +11463,7 @@ int handle_cuStreamAttachMemAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamAttachMemAsync(hStream, dptr, length, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11525,6 +11485,7 @@ int handle_cuStreamQuery(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamQuery(hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11546,10 +11507,15 @@ int handle_cuStreamSynchronize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
-  scuda_intercept_result = cuStreamSynchronize(hStream);
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
+  if (rpc_run_on_stream(conn, (const void *)hStream, [=]() {
+        CUresult scuda_intercept_result = cuStreamSynchronize(hStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+        if (rpc_start_response(conn, request_id) < 0 ||
+            rpc_end_response(conn, &scuda_intercept_result) < 0)
+          return -1;
+        return 0;
+      }) < 0)
     goto ERROR_0;
 
   return 0;
@@ -11567,6 +11533,7 @@ int handle_cuStreamDestroy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_unmap_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamDestroy_v2(hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11590,6 +11557,8 @@ int handle_cuStreamCopyAttributes(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dst = (CUstream)rpc_real_handle(conn, (const void *)dst);
+  src = (CUstream)rpc_real_handle(conn, (const void *)src);
   scuda_intercept_result = cuStreamCopyAttributes(dst, src);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11615,6 +11584,7 @@ int handle_cuStreamGetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamGetAttribute(hStream, attr, &value_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11641,6 +11611,7 @@ int handle_cuStreamSetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuStreamSetAttribute(hStream, attr, value);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11656,6 +11627,7 @@ int handle_cuEventCreate(void *conn) {
   CUevent phEvent;
   unsigned int Flags;
   int request_id;
+  const void *scuda_virtual_handle;
   CUresult scuda_intercept_result;
   if (rpc_read(conn, &phEvent, sizeof(CUevent)) < 0 ||
       rpc_read(conn, &Flags, sizeof(unsigned int)) < 0 || false)
@@ -11664,11 +11636,14 @@ int handle_cuEventCreate(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)phEvent;
   scuda_intercept_result = cuEventCreate(&phEvent, Flags);
+  if (scuda_intercept_result == CUDA_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)phEvent);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &phEvent, sizeof(CUevent)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDA_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -11688,6 +11663,8 @@ int handle_cuEventRecord(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hEvent = (CUevent)rpc_real_handle(conn, (const void *)hEvent);
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuEventRecord(hEvent, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11713,6 +11690,8 @@ int handle_cuEventRecordWithFlags(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hEvent = (CUevent)rpc_real_handle(conn, (const void *)hEvent);
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuEventRecordWithFlags(hEvent, hStream, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11734,6 +11713,7 @@ int handle_cuEventQuery(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hEvent = (CUevent)rpc_real_handle(conn, (const void *)hEvent);
   scuda_intercept_result = cuEventQuery(hEvent);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11755,10 +11735,15 @@ int handle_cuEventSynchronize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
-  scuda_intercept_result = cuEventSynchronize(hEvent);
+  hEvent = (CUevent)rpc_real_handle(conn, (const void *)hEvent);
+  if (rpc_run_on_stream(conn, (const void *)hEvent, [=]() {
+        CUresult scuda_intercept_result = cuEventSynchronize(hEvent);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+        if (rpc_start_response(conn, request_id) < 0 ||
+            rpc_end_response(conn, &scuda_intercept_result) < 0)
+          return -1;
+        return 0;
+      }) < 0)
     goto ERROR_0;
 
   return 0;
@@ -11776,6 +11761,7 @@ int handle_cuEventDestroy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hEvent = (CUevent)rpc_unmap_handle(conn, (const void *)hEvent);
   scuda_intercept_result = cuEventDestroy_v2(hEvent);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11801,6 +11787,8 @@ int handle_cuEventElapsedTime(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStart = (CUevent)rpc_real_handle(conn, (const void *)hStart);
+  hEnd = (CUevent)rpc_real_handle(conn, (const void *)hEnd);
   scuda_intercept_result = cuEventElapsedTime(&pMilliseconds, hStart, hEnd);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -11962,6 +11950,7 @@ int handle_cuSignalExternalSemaphoresAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuSignalExternalSemaphoresAsync(
       extSemArray, paramsArray, numExtSems, stream);
 
@@ -11991,6 +11980,7 @@ int handle_cuWaitExternalSemaphoresAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuWaitExternalSemaphoresAsync(
       extSemArray, paramsArray, numExtSems, stream);
 
@@ -12040,6 +12030,7 @@ int handle_cuStreamWaitValue32_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuStreamWaitValue32_v2(stream, addr, value, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -12067,6 +12058,7 @@ int handle_cuStreamWaitValue64_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuStreamWaitValue64_v2(stream, addr, value, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -12094,6 +12086,7 @@ int handle_cuStreamWriteValue32_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuStreamWriteValue32_v2(stream, addr, value, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -12121,6 +12114,7 @@ int handle_cuStreamWriteValue64_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cuStreamWriteValue64_v2(stream, addr, value, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -12148,6 +12142,7 @@ int handle_cuStreamBatchMemOp_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (CUstream)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cuStreamBatchMemOp_v2(stream, count, &paramArray, flags);
 
@@ -12312,6 +12307,7 @@ int handle_cuLaunchKernel(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuLaunchKernel(f, gridDimX, gridDimY, gridDimZ, blockDimX, blockDimY,
                      blockDimZ, sharedMemBytes, hStream, kernelParams, extra);
@@ -12353,6 +12349,7 @@ int handle_cuLaunchCooperativeKernel(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuLaunchCooperativeKernel(
       f, gridDimX, gridDimY, gridDimZ, blockDimX, blockDimY, blockDimZ,
       sharedMemBytes, hStream, &kernelParams);
@@ -12579,6 +12576,7 @@ int handle_cuLaunchGridAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result =
       cuLaunchGridAsync(f, grid_width, grid_height, hStream);
 
@@ -13067,6 +13065,7 @@ int handle_cuGraphAddEventRecordNode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cuGraphAddEventRecordNode(
       &phGraphNode, hGraph, dependencies, numDependencies, event);
 
@@ -13093,6 +13092,7 @@ int handle_cuGraphEventRecordNodeGetEvent(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cuGraphEventRecordNodeGetEvent(hNode, &event_out);
+  event_out = (CUevent)rpc_virtual_handle(conn, (const void *)event_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &event_out, sizeof(CUevent)) < 0 ||
@@ -13116,6 +13116,7 @@ int handle_cuGraphEventRecordNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cuGraphEventRecordNodeSetEvent(hNode, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -13145,6 +13146,7 @@ int handle_cuGraphAddEventWaitNode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cuGraphAddEventWaitNode(
       &phGraphNode, hGraph, dependencies, numDependencies, event);
 
@@ -13171,6 +13173,7 @@ int handle_cuGraphEventWaitNodeGetEvent(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cuGraphEventWaitNodeGetEvent(hNode, &event_out);
+  event_out = (CUevent)rpc_virtual_handle(conn, (const void *)event_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &event_out, sizeof(CUevent)) < 0 ||
@@ -13194,6 +13197,7 @@ int handle_cuGraphEventWaitNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cuGraphEventWaitNodeSetEvent(hNode, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -13615,6 +13619,7 @@ int handle_cuDeviceGraphMemTrim(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cuDeviceGraphMemTrim(device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -14153,6 +14158,7 @@ int handle_cuGraphExecEventRecordNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result =
       cuGraphExecEventRecordNodeSetEvent(hGraphExec, hNode, event);
 
@@ -14179,6 +14185,7 @@ int handle_cuGraphExecEventWaitNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (CUevent)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result =
       cuGraphExecEventWaitNodeSetEvent(hGraphExec, hNode, event);
 
@@ -14310,6 +14317,7 @@ int handle_cuGraphUpload(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuGraphUpload(hGraphExec, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -14333,6 +14341,7 @@ int handle_cuGraphLaunch(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuGraphLaunch(hGraphExec, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -15677,6 +15686,8 @@ int handle_cuDeviceCanAccessPeer(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dev = rpc_server_device(conn, dev);
+  peerDev = rpc_server_device(conn, peerDev);
   scuda_intercept_result = cuDeviceCanAccessPeer(&canAccessPeer, dev, peerDev);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -15749,6 +15760,8 @@ int handle_cuDeviceGetP2PAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  srcDevice = rpc_server_device(conn, srcDevice);
+  dstDevice = rpc_server_device(conn, dstDevice);
   scuda_intercept_result =
       cuDeviceGetP2PAttribute(&value, attrib, srcDevice, dstDevice);
 
@@ -15902,6 +15915,7 @@ int handle_cuGraphicsMapResources(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuGraphicsMapResources(count, &resources, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -15928,6 +15942,7 @@ int handle_cuGraphicsUnmapResources(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (CUstream)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cuGraphicsUnmapResources(count, &resources, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -15971,7 +15986,8 @@ int handle_cudaDeviceSynchronize(void *conn) {
     goto ERROR_0;
   scuda_intercept_result = cudaDeviceSynchronize();
 
-  if (rpc_start_response(conn, request_id) < 0 ||
+  if (rpc_merge_deferred_error(conn, request_id, &scuda_intercept_result) < 0 ||
+      rpc_start_response(conn, request_id) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
     goto ERROR_0;
 
@@ -16042,6 +16058,7 @@ int handle_cudaDeviceGetTexture1DLinearMaxWidth(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGetTexture1DLinearMaxWidth(
       &maxWidthInElements, fmtDesc, device);
 
@@ -16180,6 +16197,8 @@ int handle_cudaDeviceGetByPCIBusId(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaDeviceGetByPCIBusId(&device, pciBusId);
+  if (scuda_intercept_result == cudaSuccess)
+    device = rpc_client_device(conn, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(int)) < 0 ||
@@ -16205,6 +16224,7 @@ int handle_cudaDeviceGetPCIBusId(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGetPCIBusId(&pciBusId, len, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16229,6 +16249,7 @@ int handle_cudaIpcGetEventHandle(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaIpcGetEventHandle(&handle, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16254,6 +16275,7 @@ int handle_cudaIpcOpenEventHandle(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaIpcOpenEventHandle(&event, handle);
+  event = (cudaEvent_t)rpc_virtual_handle(conn, (const void *)event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &event, sizeof(cudaEvent_t)) < 0 ||
@@ -16458,7 +16480,8 @@ int handle_cudaGetLastError(void *conn) {
     goto ERROR_0;
   scuda_intercept_result = cudaGetLastError();
 
-  if (rpc_start_response(conn, request_id) < 0 ||
+  if (rpc_merge_deferred_error(conn, request_id, &scuda_intercept_result) < 0 ||
+      rpc_start_response(conn, request_id) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
     goto ERROR_0;
 
@@ -16498,6 +16521,8 @@ int handle_cudaGetDeviceCount(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaGetDeviceCount(&count);
+  if (scuda_intercept_result == cudaSuccess)
+    count = rpc_client_device_count(conn, count);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &count, sizeof(int)) < 0 ||
@@ -16520,6 +16545,7 @@ int handle_cudaGetDeviceProperties_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaGetDeviceProperties_v2(&prop, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16546,6 +16572,7 @@ int handle_cudaDeviceGetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGetAttribute(&value, attr, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16570,6 +16597,7 @@ int handle_cudaDeviceGetDefaultMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGetDefaultMemPool(&memPool, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16594,6 +16622,7 @@ int handle_cudaDeviceSetMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceSetMemPool(device, memPool);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16617,6 +16646,7 @@ int handle_cudaDeviceGetMemPool(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGetMemPool(&memPool, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16645,6 +16675,8 @@ int handle_cudaDeviceGetP2PAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  srcDevice = rpc_server_device(conn, srcDevice);
+  dstDevice = rpc_server_device(conn, dstDevice);
   scuda_intercept_result =
       cudaDeviceGetP2PAttribute(&value, attr, srcDevice, dstDevice);
 
@@ -16671,6 +16703,8 @@ int handle_cudaChooseDevice(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaChooseDevice(&device, prop);
+  if (scuda_intercept_result == cudaSuccess)
+    device = rpc_client_device(conn, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(int)) < 0 ||
@@ -16696,6 +16730,7 @@ int handle_cudaInitDevice(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaInitDevice(device, deviceFlags, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16717,6 +16752,7 @@ int handle_cudaSetDevice(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaSetDevice(device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16739,6 +16775,8 @@ int handle_cudaGetDevice(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaGetDevice(&device);
+  if (scuda_intercept_result == cudaSuccess)
+    device = rpc_client_device(conn, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &device, sizeof(int)) < 0 ||
@@ -16820,6 +16858,7 @@ ERROR_0:
 int handle_cudaStreamCreate(void *conn) {
   cudaStream_t pStream;
   int request_id;
+  const void *scuda_virtual_handle;
   cudaError_t scuda_intercept_result;
   if (rpc_read(conn, &pStream, sizeof(cudaStream_t)) < 0 || false)
     goto ERROR_0;
@@ -16827,11 +16866,12 @@ int handle_cudaStreamCreate(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)pStream;
   scuda_intercept_result = cudaStreamCreate(&pStream);
+  if (scuda_intercept_result == cudaSuccess)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)pStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &pStream, sizeof(cudaStream_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -16843,6 +16883,7 @@ int handle_cudaStreamCreateWithFlags(void *conn) {
   cudaStream_t pStream;
   unsigned int flags;
   int request_id;
+  const void *scuda_virtual_handle;
   cudaError_t scuda_intercept_result;
   if (rpc_read(conn, &pStream, sizeof(cudaStream_t)) < 0 ||
       rpc_read(conn, &flags, sizeof(unsigned int)) < 0 || false)
@@ -16851,11 +16892,12 @@ int handle_cudaStreamCreateWithFlags(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)pStream;
   scuda_intercept_result = cudaStreamCreateWithFlags(&pStream, flags);
+  if (scuda_intercept_result == cudaSuccess)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)pStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &pStream, sizeof(cudaStream_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -16868,6 +16910,7 @@ int handle_cudaStreamCreateWithPriority(void *conn) {
   unsigned int flags;
   int priority;
   int request_id;
+  const void *scuda_virtual_handle;
   cudaError_t scuda_intercept_result;
   if (rpc_read(conn, &pStream, sizeof(cudaStream_t)) < 0 ||
       rpc_read(conn, &flags, sizeof(unsigned int)) < 0 ||
@@ -16877,12 +16920,13 @@ int handle_cudaStreamCreateWithPriority(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)pStream;
   scuda_intercept_result =
       cudaStreamCreateWithPriority(&pStream, flags, priority);
+  if (scuda_intercept_result == cudaSuccess)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)pStream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &pStream, sizeof(cudaStream_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -16902,6 +16946,7 @@ int handle_cudaStreamGetPriority(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaStreamGetPriority(hStream, &priority);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16926,6 +16971,7 @@ int handle_cudaStreamGetFlags(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaStreamGetFlags(hStream, &flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16950,6 +16996,7 @@ int handle_cudaStreamGetId(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaStreamGetId(hStream, &streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -16994,6 +17041,8 @@ int handle_cudaStreamCopyAttributes(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dst = (cudaStream_t)rpc_real_handle(conn, (const void *)dst);
+  src = (cudaStream_t)rpc_real_handle(conn, (const void *)src);
   scuda_intercept_result = cudaStreamCopyAttributes(dst, src);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17019,6 +17068,7 @@ int handle_cudaStreamGetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaStreamGetAttribute(hStream, attr, &value_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17046,6 +17096,7 @@ int handle_cudaStreamSetAttribute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaStreamSetAttribute(hStream, attr, value);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17067,6 +17118,7 @@ int handle_cudaStreamDestroy(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_unmap_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamDestroy(stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17092,10 +17144,11 @@ int handle_cudaStreamWaitEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaStreamWaitEvent(stream, event, flags);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17113,10 +17166,17 @@ int handle_cudaStreamSynchronize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
-  scuda_intercept_result = cudaStreamSynchronize(stream);
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
+  if (rpc_run_on_stream(conn, (const void *)stream, [=]() {
+        cudaError_t scuda_intercept_result = cudaStreamSynchronize(stream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+        if (rpc_merge_deferred_error(conn, request_id,
+                                     &scuda_intercept_result) < 0 ||
+            rpc_start_response(conn, request_id) < 0 ||
+            rpc_end_response(conn, &scuda_intercept_result) < 0)
+          return -1;
+        return 0;
+      }) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17134,6 +17194,7 @@ int handle_cudaStreamQuery(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamQuery(stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17157,6 +17218,7 @@ int handle_cudaStreamBeginCapture(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamBeginCapture(stream, mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17202,6 +17264,7 @@ int handle_cudaStreamEndCapture(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamEndCapture(stream, &pGraph);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17228,6 +17291,7 @@ int handle_cudaStreamIsCapturing(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamIsCapturing(stream, &pCaptureStatus);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17252,14 +17316,15 @@ int handle_cudaStreamGetCaptureInfo_v2(void *conn) {
   cudaError_t scuda_intercept_result;
   if (rpc_read(conn, &stream, sizeof(cudaStream_t)) < 0 || false)
     goto ERROR_0;
-  dependencies_out = (const cudaGraphNode_t **)malloc(
-      numDependencies_out * sizeof(const cudaGraphNode_t *));
+  dependencies_out = (const cudaGraphNode_t **)rpc_arena_alloc(
+      conn, numDependencies_out * sizeof(const cudaGraphNode_t *));
   if (false)
-    goto ERROR_1;
+    goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamGetCaptureInfo_v2(
       stream, &captureStatus_out, &id_out, &graph_out, dependencies_out,
       &numDependencies_out);
@@ -17273,11 +17338,9 @@ int handle_cudaStreamGetCaptureInfo_v2(void *conn) {
       rpc_write(conn, dependencies_out,
                 numDependencies_out * sizeof(const cudaGraphNode_t *)) < 0 ||
       rpc_end_response(conn, &scuda_intercept_result) < 0)
-    goto ERROR_1;
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  free((void *)dependencies_out);
 ERROR_0:
   return -1;
 }
@@ -17299,6 +17362,7 @@ int handle_cudaStreamUpdateCaptureDependencies(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaStreamUpdateCaptureDependencies(
       stream, dependencies, numDependencies, flags);
 
@@ -17314,18 +17378,20 @@ ERROR_0:
 int handle_cudaEventCreate(void *conn) {
   cudaEvent_t event;
   int request_id;
+  const void *scuda_virtual_handle;
   cudaError_t scuda_intercept_result;
-  if (false)
+  if (rpc_read(conn, &event, sizeof(cudaEvent_t)) < 0 || false)
     goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)event;
   scuda_intercept_result = cudaEventCreate(&event);
+  if (scuda_intercept_result == cudaSuccess)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)event);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &event, sizeof(cudaEvent_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17337,18 +17403,21 @@ int handle_cudaEventCreateWithFlags(void *conn) {
   cudaEvent_t event;
   unsigned int flags;
   int request_id;
+  const void *scuda_virtual_handle;
   cudaError_t scuda_intercept_result;
-  if (rpc_read(conn, &flags, sizeof(unsigned int)) < 0 || false)
+  if (rpc_read(conn, &event, sizeof(cudaEvent_t)) < 0 ||
+      rpc_read(conn, &flags, sizeof(unsigned int)) < 0 || false)
     goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)event;
   scuda_intercept_result = cudaEventCreateWithFlags(&event, flags);
+  if (scuda_intercept_result == cudaSuccess)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)event);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &event, sizeof(cudaEvent_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17368,10 +17437,11 @@ int handle_cudaEventRecord(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaEventRecord(event, stream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17393,10 +17463,11 @@ int handle_cudaEventRecordWithFlags(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaEventRecordWithFlags(event, stream, flags);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17414,6 +17485,7 @@ int handle_cudaEventQuery(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaEventQuery(event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17435,10 +17507,17 @@ int handle_cudaEventSynchronize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
-  scuda_intercept_result = cudaEventSynchronize(event);
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
+  if (rpc_run_on_stream(conn, (const void *)event, [=]() {
+        cudaError_t scuda_intercept_result = cudaEventSynchronize(event);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+        if (rpc_merge_deferred_error(conn, request_id,
+                                     &scuda_intercept_result) < 0 ||
+            rpc_start_response(conn, request_id) < 0 ||
+            rpc_end_response(conn, &scuda_intercept_result) < 0)
+          return -1;
+        return 0;
+      }) < 0)
     goto ERROR_0;
 
   return 0;
@@ -17456,6 +17535,7 @@ int handle_cudaEventDestroy(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_unmap_handle(conn, (const void *)event);
   scuda_intercept_result = cudaEventDestroy(event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17480,6 +17560,8 @@ int handle_cudaEventElapsedTime(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  start = (cudaEvent_t)rpc_real_handle(conn, (const void *)start);
+  end = (cudaEvent_t)rpc_real_handle(conn, (const void *)end);
   scuda_intercept_result = cudaEventElapsedTime(&ms, start, end);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -17617,6 +17699,7 @@ int handle_cudaSignalExternalSemaphoresAsync_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaSignalExternalSemaphoresAsync_v2(
       extSemArray, paramsArray, numExtSems, stream);
 
@@ -17647,6 +17730,7 @@ int handle_cudaWaitExternalSemaphoresAsync_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaWaitExternalSemaphoresAsync_v2(
       extSemArray, paramsArray, numExtSems, stream);
 
@@ -17726,6 +17810,7 @@ int handle_cudaLaunchCooperativeKernel(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaLaunchCooperativeKernel(
       func, gridDim, blockDim, &args, sharedMem, stream);
 
@@ -18412,6 +18497,7 @@ int handle_cudaMemcpy3DAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaMemcpy3DAsync(p, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -18435,6 +18521,7 @@ int handle_cudaMemcpy3DPeerAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaMemcpy3DPeerAsync(p, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -18542,6 +18629,7 @@ int handle_cudaArrayGetMemoryRequirements(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result =
       cudaArrayGetMemoryRequirements(&memoryRequirements, array, device);
 
@@ -18571,6 +18659,7 @@ int handle_cudaMipmappedArrayGetMemoryRequirements(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaMipmappedArrayGetMemoryRequirements(
       &memoryRequirements, mipmap, device);
 
@@ -18769,6 +18858,7 @@ int handle_cudaMemcpy2DToArrayAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaMemcpy2DToArrayAsync(
       dst, wOffset, hOffset, src, spitch, width, height, kind, stream);
 
@@ -18801,6 +18891,7 @@ int handle_cudaMemcpyToSymbolAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaMemcpyToSymbolAsync(symbol, src, count, offset, kind, stream);
 
@@ -18908,10 +18999,10 @@ int handle_cudaMemsetAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaMemsetAsync(devPtr, value, count, stream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -18939,11 +19030,11 @@ int handle_cudaMemset2DAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaMemset2DAsync(devPtr, pitch, value, width, height, stream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -18967,11 +19058,11 @@ int handle_cudaMemset3DAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaMemset3DAsync(pitchedDevPtr, value, extent, stream);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result) < 0)
     goto ERROR_0;
 
   return 0;
@@ -19043,6 +19134,8 @@ int handle_cudaMemPrefetchAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dstDevice = rpc_server_device(conn, dstDevice);
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaMemPrefetchAsync(devPtr, count, dstDevice, stream);
 
@@ -19071,6 +19164,7 @@ int handle_cudaMemAdvise(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaMemAdvise(devPtr, count, advice, device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19207,6 +19301,7 @@ int handle_cudaMemcpyToArrayAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaMemcpyToArrayAsync(dst, wOffset, hOffset, src, count, kind, stream);
 
@@ -19233,6 +19328,7 @@ int handle_cudaMallocAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  hStream = (cudaStream_t)rpc_real_handle(conn, (const void *)hStream);
   scuda_intercept_result = cudaMallocAsync(&devPtr, size, hStream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19382,6 +19478,7 @@ int handle_cudaMallocFromPoolAsync(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaMallocFromPoolAsync(&ptr, size, memPool, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19462,6 +19559,8 @@ int handle_cudaDeviceCanAccessPeer(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
+  peerDevice = rpc_server_device(conn, peerDevice);
   scuda_intercept_result =
       cudaDeviceCanAccessPeer(&canAccessPeer, device, peerDevice);
 
@@ -19487,6 +19586,7 @@ int handle_cudaDeviceEnablePeerAccess(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  peerDevice = rpc_server_device(conn, peerDevice);
   scuda_intercept_result = cudaDeviceEnablePeerAccess(peerDevice, flags);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19508,6 +19608,7 @@ int handle_cudaDeviceDisablePeerAccess(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  peerDevice = rpc_server_device(conn, peerDevice);
   scuda_intercept_result = cudaDeviceDisablePeerAccess(peerDevice);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19577,6 +19678,7 @@ int handle_cudaGraphicsMapResources(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaGraphicsMapResources(count, &resources, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -19603,6 +19705,7 @@ int handle_cudaGraphicsUnmapResources(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result =
       cudaGraphicsUnmapResources(count, &resources, stream);
 
@@ -20570,6 +20673,7 @@ int handle_cudaGraphAddEventRecordNode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaGraphAddEventRecordNode(
       &pGraphNode, graph, pDependencies, numDependencies, event);
 
@@ -20596,6 +20700,7 @@ int handle_cudaGraphEventRecordNodeGetEvent(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaGraphEventRecordNodeGetEvent(node, &event_out);
+  event_out = (cudaEvent_t)rpc_virtual_handle(conn, (const void *)event_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &event_out, sizeof(cudaEvent_t)) < 0 ||
@@ -20619,6 +20724,7 @@ int handle_cudaGraphEventRecordNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaGraphEventRecordNodeSetEvent(node, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -20648,6 +20754,7 @@ int handle_cudaGraphAddEventWaitNode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaGraphAddEventWaitNode(
       &pGraphNode, graph, pDependencies, numDependencies, event);
 
@@ -20674,6 +20781,7 @@ int handle_cudaGraphEventWaitNodeGetEvent(void *conn) {
   if (request_id < 0)
     goto ERROR_0;
   scuda_intercept_result = cudaGraphEventWaitNodeGetEvent(node, &event_out);
+  event_out = (cudaEvent_t)rpc_virtual_handle(conn, (const void *)event_out);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &event_out, sizeof(cudaEvent_t)) < 0 ||
@@ -20697,6 +20805,7 @@ int handle_cudaGraphEventWaitNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result = cudaGraphEventWaitNodeSetEvent(node, event);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -20954,6 +21063,7 @@ int handle_cudaDeviceGraphMemTrim(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  device = rpc_server_device(conn, device);
   scuda_intercept_result = cudaDeviceGraphMemTrim(device);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -21552,6 +21662,7 @@ int handle_cudaGraphExecEventRecordNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result =
       cudaGraphExecEventRecordNodeSetEvent(hGraphExec, hNode, event);
 
@@ -21578,6 +21689,7 @@ int handle_cudaGraphExecEventWaitNodeSetEvent(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  event = (cudaEvent_t)rpc_real_handle(conn, (const void *)event);
   scuda_intercept_result =
       cudaGraphExecEventWaitNodeSetEvent(hGraphExec, hNode, event);
 
@@ -21740,6 +21852,7 @@ int handle_cudaGraphUpload(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaGraphUpload(graphExec, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -21763,6 +21876,7 @@ int handle_cudaGraphLaunch(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
   scuda_intercept_result = cudaGraphLaunch(graphExec, stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22024,18 +22138,22 @@ ERROR_0:
 int handle_cublasCreate_v2(void *conn) {
   cublasHandle_t handle;
   int request_id;
+  const void *scuda_virtual_handle;
   cublasStatus_t scuda_intercept_result;
-  if (false)
+  if (rpc_read(conn, &handle, sizeof(cublasHandle_t)) < 0 || false)
     goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)handle;
   scuda_intercept_result = cublasCreate_v2(&handle);
+  if (scuda_intercept_result == CUBLAS_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)handle);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &handle, sizeof(cublasHandle_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUBLAS_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -22053,6 +22171,7 @@ int handle_cublasDestroy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_unmap_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDestroy_v2(handle);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22076,6 +22195,7 @@ int handle_cublasGetVersion_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetVersion_v2(handle, &version);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22124,6 +22244,8 @@ int handle_cublasSetStream_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
+  streamId = (cudaStream_t)rpc_real_handle(conn, (const void *)streamId);
   scuda_intercept_result = cublasSetStream_v2(handle, streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22147,7 +22269,9 @@ int handle_cublasGetStream_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetStream_v2(handle, &streamId);
+  streamId = (cudaStream_t)rpc_virtual_handle(conn, (const void *)streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &streamId, sizeof(cudaStream_t)) < 0 ||
@@ -22171,6 +22295,7 @@ int handle_cublasGetPointerMode_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetPointerMode_v2(handle, &mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22195,6 +22320,7 @@ int handle_cublasSetPointerMode_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSetPointerMode_v2(handle, mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22218,6 +22344,7 @@ int handle_cublasGetAtomicsMode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetAtomicsMode(handle, &mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22242,6 +22369,7 @@ int handle_cublasSetAtomicsMode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSetAtomicsMode(handle, mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22265,6 +22393,7 @@ int handle_cublasGetMathMode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetMathMode(handle, &mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22289,6 +22418,7 @@ int handle_cublasSetMathMode(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSetMathMode(handle, mode);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22312,6 +22442,7 @@ int handle_cublasGetSmCountTarget(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGetSmCountTarget(handle, &smCountTarget);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22336,6 +22467,7 @@ int handle_cublasSetSmCountTarget(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSetSmCountTarget(handle, smCountTarget);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22436,6 +22568,7 @@ int handle_cublasSnrm2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSnrm2_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22466,6 +22599,7 @@ int handle_cublasSnrm2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSnrm2_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22496,6 +22630,7 @@ int handle_cublasDnrm2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDnrm2_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22526,6 +22661,7 @@ int handle_cublasDnrm2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDnrm2_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22556,6 +22692,7 @@ int handle_cublasScnrm2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScnrm2_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22586,6 +22723,7 @@ int handle_cublasScnrm2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScnrm2_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22616,6 +22754,7 @@ int handle_cublasDznrm2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDznrm2_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22646,6 +22785,7 @@ int handle_cublasDznrm2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDznrm2_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22680,6 +22820,7 @@ int handle_cublasSdot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSdot_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22714,6 +22855,7 @@ int handle_cublasSdot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSdot_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -22749,6 +22891,7 @@ int handle_cublasDdot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDdot_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22783,6 +22926,7 @@ int handle_cublasDdot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDdot_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -22818,6 +22962,7 @@ int handle_cublasCdotu_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCdotu_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22852,6 +22997,7 @@ int handle_cublasCdotu_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCdotu_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -22887,6 +23033,7 @@ int handle_cublasCdotc_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCdotc_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22921,6 +23068,7 @@ int handle_cublasCdotc_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCdotc_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -22956,6 +23104,7 @@ int handle_cublasZdotu_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZdotu_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -22990,6 +23139,7 @@ int handle_cublasZdotu_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZdotu_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -23025,6 +23175,7 @@ int handle_cublasZdotc_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZdotc_v2(handle, n, x, incx, y, incy, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23059,6 +23210,7 @@ int handle_cublasZdotc_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZdotc_v2_64(handle, n, x, incx, y, incy, &result);
 
@@ -23090,6 +23242,7 @@ int handle_cublasSscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23120,6 +23273,7 @@ int handle_cublasSscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23150,6 +23304,7 @@ int handle_cublasDscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23180,6 +23335,7 @@ int handle_cublasDscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23210,6 +23366,7 @@ int handle_cublasCscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23240,6 +23397,7 @@ int handle_cublasCscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23270,6 +23428,7 @@ int handle_cublasCsscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23300,6 +23459,7 @@ int handle_cublasCsscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23330,6 +23490,7 @@ int handle_cublasZscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23360,6 +23521,7 @@ int handle_cublasZscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23390,6 +23552,7 @@ int handle_cublasZdscal_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZdscal_v2(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23420,6 +23583,7 @@ int handle_cublasZdscal_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZdscal_v2_64(handle, n, alpha, &x, incx);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23454,6 +23618,7 @@ int handle_cublasSaxpy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSaxpy_v2(handle, n, alpha, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23488,6 +23653,7 @@ int handle_cublasSaxpy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSaxpy_v2_64(handle, n, alpha, x, incx, &y, incy);
 
@@ -23523,6 +23689,7 @@ int handle_cublasDaxpy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDaxpy_v2(handle, n, alpha, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23557,6 +23724,7 @@ int handle_cublasDaxpy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDaxpy_v2_64(handle, n, alpha, x, incx, &y, incy);
 
@@ -23592,6 +23760,7 @@ int handle_cublasCaxpy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCaxpy_v2(handle, n, alpha, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23626,6 +23795,7 @@ int handle_cublasCaxpy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCaxpy_v2_64(handle, n, alpha, x, incx, &y, incy);
 
@@ -23661,6 +23831,7 @@ int handle_cublasZaxpy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZaxpy_v2(handle, n, alpha, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23695,6 +23866,7 @@ int handle_cublasZaxpy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZaxpy_v2_64(handle, n, alpha, x, incx, &y, incy);
 
@@ -23728,6 +23900,7 @@ int handle_cublasScopy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScopy_v2(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23760,6 +23933,7 @@ int handle_cublasScopy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScopy_v2_64(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23792,6 +23966,7 @@ int handle_cublasDcopy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDcopy_v2(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23824,6 +23999,7 @@ int handle_cublasDcopy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDcopy_v2_64(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23856,6 +24032,7 @@ int handle_cublasCcopy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCcopy_v2(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23888,6 +24065,7 @@ int handle_cublasCcopy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCcopy_v2_64(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23920,6 +24098,7 @@ int handle_cublasZcopy_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZcopy_v2(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23952,6 +24131,7 @@ int handle_cublasZcopy_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZcopy_v2_64(handle, n, x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -23984,6 +24164,7 @@ int handle_cublasSswap_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSswap_v2(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24017,6 +24198,7 @@ int handle_cublasSswap_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSswap_v2_64(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24050,6 +24232,7 @@ int handle_cublasDswap_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDswap_v2(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24083,6 +24266,7 @@ int handle_cublasDswap_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDswap_v2_64(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24116,6 +24300,7 @@ int handle_cublasCswap_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCswap_v2(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24149,6 +24334,7 @@ int handle_cublasCswap_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCswap_v2_64(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24182,6 +24368,7 @@ int handle_cublasZswap_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZswap_v2(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24215,6 +24402,7 @@ int handle_cublasZswap_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZswap_v2_64(handle, n, &x, incx, &y, incy);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24246,6 +24434,7 @@ int handle_cublasIsamax_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIsamax_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24276,6 +24465,7 @@ int handle_cublasIsamax_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIsamax_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24306,6 +24496,7 @@ int handle_cublasIdamax_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIdamax_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24336,6 +24527,7 @@ int handle_cublasIdamax_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIdamax_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24366,6 +24558,7 @@ int handle_cublasIcamax_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIcamax_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24396,6 +24589,7 @@ int handle_cublasIcamax_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIcamax_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24426,6 +24620,7 @@ int handle_cublasIzamax_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIzamax_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24456,6 +24651,7 @@ int handle_cublasIzamax_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIzamax_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24488,6 +24684,7 @@ int handle_cublasIamaxEx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIamaxEx(handle, n, x, xType, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24520,6 +24717,7 @@ int handle_cublasIamaxEx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIamaxEx_64(handle, n, x, xType, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24550,6 +24748,7 @@ int handle_cublasIsamin_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIsamin_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24580,6 +24779,7 @@ int handle_cublasIsamin_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIsamin_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24610,6 +24810,7 @@ int handle_cublasIdamin_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIdamin_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24640,6 +24841,7 @@ int handle_cublasIdamin_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIdamin_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24670,6 +24872,7 @@ int handle_cublasIcamin_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIcamin_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24700,6 +24903,7 @@ int handle_cublasIcamin_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIcamin_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24730,6 +24934,7 @@ int handle_cublasIzamin_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIzamin_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24760,6 +24965,7 @@ int handle_cublasIzamin_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIzamin_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24792,6 +24998,7 @@ int handle_cublasIaminEx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIaminEx(handle, n, x, xType, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24824,6 +25031,7 @@ int handle_cublasIaminEx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasIaminEx_64(handle, n, x, xType, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24854,6 +25062,7 @@ int handle_cublasSasum_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSasum_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24884,6 +25093,7 @@ int handle_cublasSasum_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSasum_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24914,6 +25124,7 @@ int handle_cublasDasum_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDasum_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24944,6 +25155,7 @@ int handle_cublasDasum_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDasum_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -24974,6 +25186,7 @@ int handle_cublasScasum_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScasum_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25004,6 +25217,7 @@ int handle_cublasScasum_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasScasum_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25034,6 +25248,7 @@ int handle_cublasDzasum_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDzasum_v2(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25064,6 +25279,7 @@ int handle_cublasDzasum_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDzasum_v2_64(handle, n, x, incx, &result);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25100,6 +25316,7 @@ int handle_cublasSrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25137,6 +25354,7 @@ int handle_cublasSrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25175,6 +25393,7 @@ int handle_cublasDrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25212,6 +25431,7 @@ int handle_cublasDrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25250,6 +25470,7 @@ int handle_cublasCrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25287,6 +25508,7 @@ int handle_cublasCrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25325,6 +25547,7 @@ int handle_cublasCsrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25362,6 +25585,7 @@ int handle_cublasCsrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25400,6 +25624,7 @@ int handle_cublasZrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25437,6 +25662,7 @@ int handle_cublasZrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25475,6 +25701,7 @@ int handle_cublasZdrot_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZdrot_v2(handle, n, &x, incx, &y, incy, c, s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25512,6 +25739,7 @@ int handle_cublasZdrot_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZdrot_v2_64(handle, n, &x, incx, &y, incy, c, s);
 
@@ -25544,6 +25772,7 @@ int handle_cublasSrotg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSrotg_v2(handle, &a, &b, &c, &s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25577,6 +25806,7 @@ int handle_cublasDrotg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDrotg_v2(handle, &a, &b, &c, &s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25610,6 +25840,7 @@ int handle_cublasCrotg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCrotg_v2(handle, &a, &b, &c, &s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25643,6 +25874,7 @@ int handle_cublasZrotg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZrotg_v2(handle, &a, &b, &c, &s);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25680,6 +25912,7 @@ int handle_cublasSrotm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSrotm_v2(handle, n, &x, incx, &y, incy, param);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25715,6 +25948,7 @@ int handle_cublasSrotm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSrotm_v2_64(handle, n, &x, incx, &y, incy, param);
 
@@ -25751,6 +25985,7 @@ int handle_cublasDrotm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDrotm_v2(handle, n, &x, incx, &y, incy, param);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25786,6 +26021,7 @@ int handle_cublasDrotm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDrotm_v2_64(handle, n, &x, incx, &y, incy, param);
 
@@ -25820,6 +26056,7 @@ int handle_cublasSrotmg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSrotmg_v2(handle, &d1, &d2, &x1, y1, &param);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25855,6 +26092,7 @@ int handle_cublasDrotmg_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDrotmg_v2(handle, &d1, &d2, &x1, y1, &param);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -25902,6 +26140,7 @@ int handle_cublasSgemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemv_v2(handle, trans, m, n, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -25947,6 +26186,7 @@ int handle_cublasSgemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemv_v2_64(handle, trans, m, n, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -25992,6 +26232,7 @@ int handle_cublasDgemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemv_v2(handle, trans, m, n, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -26037,6 +26278,7 @@ int handle_cublasDgemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemv_v2_64(handle, trans, m, n, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -26082,6 +26324,7 @@ int handle_cublasCgemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemv_v2(handle, trans, m, n, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -26127,6 +26370,7 @@ int handle_cublasCgemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemv_v2_64(handle, trans, m, n, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -26172,6 +26416,7 @@ int handle_cublasZgemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemv_v2(handle, trans, m, n, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -26217,6 +26462,7 @@ int handle_cublasZgemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemv_v2_64(handle, trans, m, n, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -26266,6 +26512,7 @@ int handle_cublasSgbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgbmv_v2(handle, trans, m, n, kl, ku, alpha, A,
                                           lda, x, incx, beta, &y, incy);
 
@@ -26315,6 +26562,7 @@ int handle_cublasSgbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgbmv_v2_64(handle, trans, m, n, kl, ku, alpha,
                                              A, lda, x, incx, beta, &y, incy);
 
@@ -26364,6 +26612,7 @@ int handle_cublasDgbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgbmv_v2(handle, trans, m, n, kl, ku, alpha, A,
                                           lda, x, incx, beta, &y, incy);
 
@@ -26413,6 +26662,7 @@ int handle_cublasDgbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgbmv_v2_64(handle, trans, m, n, kl, ku, alpha,
                                              A, lda, x, incx, beta, &y, incy);
 
@@ -26462,6 +26712,7 @@ int handle_cublasCgbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgbmv_v2(handle, trans, m, n, kl, ku, alpha, A,
                                           lda, x, incx, beta, &y, incy);
 
@@ -26511,6 +26762,7 @@ int handle_cublasCgbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgbmv_v2_64(handle, trans, m, n, kl, ku, alpha,
                                              A, lda, x, incx, beta, &y, incy);
 
@@ -26560,6 +26812,7 @@ int handle_cublasZgbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgbmv_v2(handle, trans, m, n, kl, ku, alpha, A,
                                           lda, x, incx, beta, &y, incy);
 
@@ -26609,6 +26862,7 @@ int handle_cublasZgbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgbmv_v2_64(handle, trans, m, n, kl, ku, alpha,
                                              A, lda, x, incx, beta, &y, incy);
 
@@ -26648,6 +26902,7 @@ int handle_cublasStrmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrmv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26687,6 +26942,7 @@ int handle_cublasStrmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrmv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26726,6 +26982,7 @@ int handle_cublasDtrmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrmv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26765,6 +27022,7 @@ int handle_cublasDtrmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrmv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26804,6 +27062,7 @@ int handle_cublasCtrmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrmv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26843,6 +27102,7 @@ int handle_cublasCtrmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrmv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26882,6 +27142,7 @@ int handle_cublasZtrmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrmv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26921,6 +27182,7 @@ int handle_cublasZtrmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrmv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -26962,6 +27224,7 @@ int handle_cublasStbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStbmv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27003,6 +27266,7 @@ int handle_cublasStbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStbmv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27044,6 +27308,7 @@ int handle_cublasDtbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtbmv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27085,6 +27350,7 @@ int handle_cublasDtbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtbmv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27126,6 +27392,7 @@ int handle_cublasCtbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtbmv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27167,6 +27434,7 @@ int handle_cublasCtbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtbmv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27208,6 +27476,7 @@ int handle_cublasZtbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtbmv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27249,6 +27518,7 @@ int handle_cublasZtbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtbmv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -27286,6 +27556,7 @@ int handle_cublasStpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStpmv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27323,6 +27594,7 @@ int handle_cublasStpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStpmv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27360,6 +27632,7 @@ int handle_cublasDtpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtpmv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27397,6 +27670,7 @@ int handle_cublasDtpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtpmv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27434,6 +27708,7 @@ int handle_cublasCtpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtpmv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27471,6 +27746,7 @@ int handle_cublasCtpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtpmv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27508,6 +27784,7 @@ int handle_cublasZtpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtpmv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27545,6 +27822,7 @@ int handle_cublasZtpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtpmv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27584,6 +27862,7 @@ int handle_cublasStrsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrsv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27623,6 +27902,7 @@ int handle_cublasStrsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrsv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27662,6 +27942,7 @@ int handle_cublasDtrsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrsv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27701,6 +27982,7 @@ int handle_cublasDtrsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrsv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27740,6 +28022,7 @@ int handle_cublasCtrsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrsv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27779,6 +28062,7 @@ int handle_cublasCtrsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrsv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27818,6 +28102,7 @@ int handle_cublasZtrsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrsv_v2(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27857,6 +28142,7 @@ int handle_cublasZtrsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrsv_v2_64(handle, uplo, trans, diag, n, A, lda, &x, incx);
 
@@ -27894,6 +28180,7 @@ int handle_cublasStpsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStpsv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27931,6 +28218,7 @@ int handle_cublasStpsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStpsv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -27968,6 +28256,7 @@ int handle_cublasDtpsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtpsv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28005,6 +28294,7 @@ int handle_cublasDtpsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtpsv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28042,6 +28332,7 @@ int handle_cublasCtpsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtpsv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28079,6 +28370,7 @@ int handle_cublasCtpsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtpsv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28116,6 +28408,7 @@ int handle_cublasZtpsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtpsv_v2(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28153,6 +28446,7 @@ int handle_cublasZtpsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtpsv_v2_64(handle, uplo, trans, diag, n, AP, &x, incx);
 
@@ -28194,6 +28488,7 @@ int handle_cublasStbsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStbsv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28235,6 +28530,7 @@ int handle_cublasStbsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStbsv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28276,6 +28572,7 @@ int handle_cublasDtbsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtbsv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28317,6 +28614,7 @@ int handle_cublasDtbsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtbsv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28358,6 +28656,7 @@ int handle_cublasCtbsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtbsv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28399,6 +28698,7 @@ int handle_cublasCtbsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtbsv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28440,6 +28740,7 @@ int handle_cublasZtbsv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtbsv_v2(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28481,6 +28782,7 @@ int handle_cublasZtbsv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtbsv_v2_64(handle, uplo, trans, diag, n, k, A, lda, &x, incx);
 
@@ -28524,6 +28826,7 @@ int handle_cublasSsymv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsymv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28567,6 +28870,7 @@ int handle_cublasSsymv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsymv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -28610,6 +28914,7 @@ int handle_cublasDsymv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsymv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28653,6 +28958,7 @@ int handle_cublasDsymv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsymv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -28696,6 +29002,7 @@ int handle_cublasCsymv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsymv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28739,6 +29046,7 @@ int handle_cublasCsymv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsymv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -28782,6 +29090,7 @@ int handle_cublasZsymv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsymv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28825,6 +29134,7 @@ int handle_cublasZsymv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsymv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -28868,6 +29178,7 @@ int handle_cublasChemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChemv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28911,6 +29222,7 @@ int handle_cublasChemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChemv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -28954,6 +29266,7 @@ int handle_cublasZhemv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhemv_v2(handle, uplo, n, alpha, A, lda, x, incx, beta, &y, incy);
 
@@ -28997,6 +29310,7 @@ int handle_cublasZhemv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhemv_v2_64(handle, uplo, n, alpha, A, lda, x,
                                              incx, beta, &y, incy);
 
@@ -29042,6 +29356,7 @@ int handle_cublasSsbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsbmv_v2(handle, uplo, n, k, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -29087,6 +29402,7 @@ int handle_cublasSsbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsbmv_v2_64(handle, uplo, n, k, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -29132,6 +29448,7 @@ int handle_cublasDsbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsbmv_v2(handle, uplo, n, k, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -29177,6 +29494,7 @@ int handle_cublasDsbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsbmv_v2_64(handle, uplo, n, k, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -29222,6 +29540,7 @@ int handle_cublasChbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChbmv_v2(handle, uplo, n, k, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -29267,6 +29586,7 @@ int handle_cublasChbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChbmv_v2_64(handle, uplo, n, k, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -29312,6 +29632,7 @@ int handle_cublasZhbmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhbmv_v2(handle, uplo, n, k, alpha, A, lda, x,
                                           incx, beta, &y, incy);
 
@@ -29357,6 +29678,7 @@ int handle_cublasZhbmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhbmv_v2_64(handle, uplo, n, k, alpha, A, lda,
                                              x, incx, beta, &y, incy);
 
@@ -29398,6 +29720,7 @@ int handle_cublasSspmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSspmv_v2(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29439,6 +29762,7 @@ int handle_cublasSspmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSspmv_v2_64(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29480,6 +29804,7 @@ int handle_cublasDspmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDspmv_v2(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29521,6 +29846,7 @@ int handle_cublasDspmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDspmv_v2_64(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29562,6 +29888,7 @@ int handle_cublasChpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChpmv_v2(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29603,6 +29930,7 @@ int handle_cublasChpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChpmv_v2_64(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29644,6 +29972,7 @@ int handle_cublasZhpmv_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhpmv_v2(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29685,6 +30014,7 @@ int handle_cublasZhpmv_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhpmv_v2_64(handle, uplo, n, alpha, AP, x, incx, beta, &y, incy);
 
@@ -29726,6 +30056,7 @@ int handle_cublasSger_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSger_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29767,6 +30098,7 @@ int handle_cublasSger_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSger_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29808,6 +30140,7 @@ int handle_cublasDger_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDger_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29849,6 +30182,7 @@ int handle_cublasDger_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDger_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29890,6 +30224,7 @@ int handle_cublasCgeru_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgeru_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29931,6 +30266,7 @@ int handle_cublasCgeru_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgeru_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -29972,6 +30308,7 @@ int handle_cublasCgerc_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgerc_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30013,6 +30350,7 @@ int handle_cublasCgerc_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgerc_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30054,6 +30392,7 @@ int handle_cublasZgeru_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgeru_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30095,6 +30434,7 @@ int handle_cublasZgeru_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgeru_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30136,6 +30476,7 @@ int handle_cublasZgerc_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgerc_v2(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30177,6 +30518,7 @@ int handle_cublasZgerc_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgerc_v2_64(handle, m, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30214,6 +30556,7 @@ int handle_cublasSsyr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsyr_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30251,6 +30594,7 @@ int handle_cublasSsyr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsyr_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30288,6 +30632,7 @@ int handle_cublasDsyr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsyr_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30325,6 +30670,7 @@ int handle_cublasDsyr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsyr_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30362,6 +30708,7 @@ int handle_cublasCsyr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsyr_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30399,6 +30746,7 @@ int handle_cublasCsyr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsyr_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30436,6 +30784,7 @@ int handle_cublasZsyr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsyr_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30473,6 +30822,7 @@ int handle_cublasZsyr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsyr_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30510,6 +30860,7 @@ int handle_cublasCher_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCher_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30547,6 +30898,7 @@ int handle_cublasCher_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCher_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30584,6 +30936,7 @@ int handle_cublasZher_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZher_v2(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30621,6 +30974,7 @@ int handle_cublasZher_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZher_v2_64(handle, uplo, n, alpha, x, incx, &A, lda);
 
@@ -30656,6 +31010,7 @@ int handle_cublasSspr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSspr_v2(handle, uplo, n, alpha, x, incx, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -30690,6 +31045,7 @@ int handle_cublasSspr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSspr_v2_64(handle, uplo, n, alpha, x, incx, &AP);
 
@@ -30725,6 +31081,7 @@ int handle_cublasDspr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDspr_v2(handle, uplo, n, alpha, x, incx, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -30759,6 +31116,7 @@ int handle_cublasDspr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDspr_v2_64(handle, uplo, n, alpha, x, incx, &AP);
 
@@ -30794,6 +31152,7 @@ int handle_cublasChpr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChpr_v2(handle, uplo, n, alpha, x, incx, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -30828,6 +31187,7 @@ int handle_cublasChpr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChpr_v2_64(handle, uplo, n, alpha, x, incx, &AP);
 
@@ -30863,6 +31223,7 @@ int handle_cublasZhpr_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhpr_v2(handle, uplo, n, alpha, x, incx, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -30897,6 +31258,7 @@ int handle_cublasZhpr_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhpr_v2_64(handle, uplo, n, alpha, x, incx, &AP);
 
@@ -30938,6 +31300,7 @@ int handle_cublasSsyr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsyr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -30979,6 +31342,7 @@ int handle_cublasSsyr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsyr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31020,6 +31384,7 @@ int handle_cublasDsyr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsyr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31061,6 +31426,7 @@ int handle_cublasDsyr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsyr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31102,6 +31468,7 @@ int handle_cublasCsyr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsyr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31143,6 +31510,7 @@ int handle_cublasCsyr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsyr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31184,6 +31552,7 @@ int handle_cublasZsyr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsyr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31225,6 +31594,7 @@ int handle_cublasZsyr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsyr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31266,6 +31636,7 @@ int handle_cublasCher2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCher2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31307,6 +31678,7 @@ int handle_cublasCher2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCher2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31348,6 +31720,7 @@ int handle_cublasZher2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZher2_v2(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31389,6 +31762,7 @@ int handle_cublasZher2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZher2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &A, lda);
 
@@ -31428,6 +31802,7 @@ int handle_cublasSspr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSspr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31467,6 +31842,7 @@ int handle_cublasSspr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSspr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31506,6 +31882,7 @@ int handle_cublasDspr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDspr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31545,6 +31922,7 @@ int handle_cublasDspr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDspr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31584,6 +31962,7 @@ int handle_cublasChpr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChpr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31623,6 +32002,7 @@ int handle_cublasChpr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasChpr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31662,6 +32042,7 @@ int handle_cublasZhpr2_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhpr2_v2(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31701,6 +32082,7 @@ int handle_cublasZhpr2_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZhpr2_v2_64(handle, uplo, n, alpha, x, incx, y, incy, &AP);
 
@@ -31748,6 +32130,7 @@ int handle_cublasSgemvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgemvBatched(handle, trans, m, n, alpha, Aarray, lda, xarray, incx,
                          beta, yarray, incy, batchCount);
@@ -31795,6 +32178,7 @@ int handle_cublasTSTgemvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasTSTgemvBatched(handle, trans, m, n, alpha, Aarray, lda, xarray,
                            incx, beta, yarray, incy, batchCount);
@@ -31848,6 +32232,7 @@ int handle_cublasSgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -31902,6 +32287,7 @@ int handle_cublasSgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -31956,6 +32342,7 @@ int handle_cublasDgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32010,6 +32397,7 @@ int handle_cublasDgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32064,6 +32452,7 @@ int handle_cublasCgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32118,6 +32507,7 @@ int handle_cublasCgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32172,6 +32562,7 @@ int handle_cublasZgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32226,6 +32617,7 @@ int handle_cublasZgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32280,6 +32672,7 @@ int handle_cublasHSHgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHSHgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32334,6 +32727,7 @@ int handle_cublasHSHgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHSHgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32388,6 +32782,7 @@ int handle_cublasHSSgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHSSgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32442,6 +32837,7 @@ int handle_cublasHSSgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHSSgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32496,6 +32892,7 @@ int handle_cublasTSTgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasTSTgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32550,6 +32947,7 @@ int handle_cublasTSTgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasTSTgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32604,6 +33002,7 @@ int handle_cublasTSSgemvStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasTSSgemvStridedBatched(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32658,6 +33057,7 @@ int handle_cublasTSSgemvStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasTSSgemvStridedBatched_64(
       handle, trans, m, n, alpha, A, lda, strideA, x, incx, stridex, beta, &y,
       incy, stridey, batchCount);
@@ -32712,11 +33112,13 @@ int handle_cublasSgemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemm_v2(
       handle, transa, transb, m, n, k, &alpha, A, lda, B, ldb, &beta, C, ldc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUBLAS_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -32760,6 +33162,7 @@ int handle_cublasSgemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemm_v2_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -32809,6 +33212,7 @@ int handle_cublasDgemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemm_v2(handle, transa, transb, m, n, k,
                                           alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -32858,6 +33262,7 @@ int handle_cublasDgemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemm_v2_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -32907,6 +33312,7 @@ int handle_cublasCgemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm_v2(handle, transa, transb, m, n, k,
                                           alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -32956,6 +33362,7 @@ int handle_cublasCgemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm_v2_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33005,6 +33412,7 @@ int handle_cublasCgemm3m(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm3m(handle, transa, transb, m, n, k, alpha,
                                          A, lda, B, ldb, beta, &C, ldc);
 
@@ -33054,6 +33462,7 @@ int handle_cublasCgemm3m_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm3m_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33103,6 +33512,7 @@ int handle_cublasZgemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemm_v2(handle, transa, transb, m, n, k,
                                           alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33152,6 +33562,7 @@ int handle_cublasZgemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemm_v2_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33201,6 +33612,7 @@ int handle_cublasZgemm3m(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemm3m(handle, transa, transb, m, n, k, alpha,
                                          A, lda, B, ldb, beta, &C, ldc);
 
@@ -33250,6 +33662,7 @@ int handle_cublasZgemm3m_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemm3m_64(
       handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33299,6 +33712,7 @@ int handle_cublasHgemm(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHgemm(handle, transa, transb, m, n, k, alpha,
                                        A, lda, B, ldb, beta, &C, ldc);
 
@@ -33348,6 +33762,7 @@ int handle_cublasHgemm_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHgemm_64(handle, transa, transb, m, n, k,
                                           alpha, A, lda, B, ldb, beta, &C, ldc);
 
@@ -33391,6 +33806,7 @@ int handle_cublasSsyrk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSsyrk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33434,6 +33850,7 @@ int handle_cublasSsyrk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsyrk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33477,6 +33894,7 @@ int handle_cublasDsyrk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDsyrk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33520,6 +33938,7 @@ int handle_cublasDsyrk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsyrk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33563,6 +33982,7 @@ int handle_cublasCsyrk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCsyrk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33606,6 +34026,7 @@ int handle_cublasCsyrk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsyrk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33649,6 +34070,7 @@ int handle_cublasZsyrk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZsyrk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33692,6 +34114,7 @@ int handle_cublasZsyrk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsyrk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33735,6 +34158,7 @@ int handle_cublasCherk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCherk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33778,6 +34202,7 @@ int handle_cublasCherk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCherk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33821,6 +34246,7 @@ int handle_cublasZherk_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZherk_v2(handle, uplo, trans, n, k, alpha, A, lda, beta, &C, ldc);
 
@@ -33864,6 +34290,7 @@ int handle_cublasZherk_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZherk_v2_64(handle, uplo, trans, n, k, alpha,
                                              A, lda, beta, &C, ldc);
 
@@ -33911,6 +34338,7 @@ int handle_cublasSsyr2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsyr2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -33958,6 +34386,7 @@ int handle_cublasSsyr2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsyr2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34005,6 +34434,7 @@ int handle_cublasDsyr2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsyr2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34052,6 +34482,7 @@ int handle_cublasDsyr2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsyr2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34099,6 +34530,7 @@ int handle_cublasCsyr2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsyr2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34146,6 +34578,7 @@ int handle_cublasCsyr2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsyr2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34193,6 +34626,7 @@ int handle_cublasZsyr2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsyr2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34240,6 +34674,7 @@ int handle_cublasZsyr2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsyr2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34287,6 +34722,7 @@ int handle_cublasCher2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCher2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34334,6 +34770,7 @@ int handle_cublasCher2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCher2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34381,6 +34818,7 @@ int handle_cublasZher2k_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZher2k_v2(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34428,6 +34866,7 @@ int handle_cublasZher2k_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZher2k_v2_64(handle, uplo, trans, n, k, alpha,
                                               A, lda, B, ldb, beta, &C, ldc);
 
@@ -34475,6 +34914,7 @@ int handle_cublasSsyrkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsyrkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34522,6 +34962,7 @@ int handle_cublasSsyrkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsyrkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34569,6 +35010,7 @@ int handle_cublasDsyrkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsyrkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34616,6 +35058,7 @@ int handle_cublasDsyrkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsyrkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34663,6 +35106,7 @@ int handle_cublasCsyrkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsyrkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34710,6 +35154,7 @@ int handle_cublasCsyrkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsyrkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34757,6 +35202,7 @@ int handle_cublasZsyrkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsyrkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34804,6 +35250,7 @@ int handle_cublasZsyrkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsyrkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34851,6 +35298,7 @@ int handle_cublasCherkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCherkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34898,6 +35346,7 @@ int handle_cublasCherkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCherkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -34945,6 +35394,7 @@ int handle_cublasZherkx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZherkx(handle, uplo, trans, n, k, alpha, A,
                                         lda, B, ldb, beta, &C, ldc);
 
@@ -34992,6 +35442,7 @@ int handle_cublasZherkx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZherkx_64(handle, uplo, trans, n, k, alpha, A,
                                            lda, B, ldb, beta, &C, ldc);
 
@@ -35039,6 +35490,7 @@ int handle_cublasSsymm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsymm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35086,6 +35538,7 @@ int handle_cublasSsymm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSsymm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35133,6 +35586,7 @@ int handle_cublasDsymm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsymm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35180,6 +35634,7 @@ int handle_cublasDsymm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDsymm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35227,6 +35682,7 @@ int handle_cublasCsymm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsymm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35274,6 +35730,7 @@ int handle_cublasCsymm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCsymm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35321,6 +35778,7 @@ int handle_cublasZsymm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsymm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35368,6 +35826,7 @@ int handle_cublasZsymm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZsymm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35415,6 +35874,7 @@ int handle_cublasChemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChemm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35462,6 +35922,7 @@ int handle_cublasChemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasChemm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35509,6 +35970,7 @@ int handle_cublasZhemm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhemm_v2(handle, side, uplo, m, n, alpha, A,
                                           lda, B, ldb, beta, &C, ldc);
 
@@ -35556,6 +36018,7 @@ int handle_cublasZhemm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZhemm_v2_64(handle, side, uplo, m, n, alpha, A,
                                              lda, B, ldb, beta, &C, ldc);
 
@@ -35601,6 +36064,7 @@ int handle_cublasStrsm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStrsm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, &B, ldb);
 
@@ -35646,6 +36110,7 @@ int handle_cublasStrsm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStrsm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, &B, ldb);
 
@@ -35691,6 +36156,7 @@ int handle_cublasDtrsm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtrsm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, &B, ldb);
 
@@ -35736,6 +36202,7 @@ int handle_cublasDtrsm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtrsm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, &B, ldb);
 
@@ -35781,6 +36248,7 @@ int handle_cublasCtrsm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtrsm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, &B, ldb);
 
@@ -35826,6 +36294,7 @@ int handle_cublasCtrsm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtrsm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, &B, ldb);
 
@@ -35871,6 +36340,7 @@ int handle_cublasZtrsm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtrsm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, &B, ldb);
 
@@ -35916,6 +36386,7 @@ int handle_cublasZtrsm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtrsm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, &B, ldb);
 
@@ -35965,6 +36436,7 @@ int handle_cublasStrmm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStrmm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36014,6 +36486,7 @@ int handle_cublasStrmm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStrmm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36063,6 +36536,7 @@ int handle_cublasDtrmm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtrmm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36112,6 +36586,7 @@ int handle_cublasDtrmm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtrmm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36161,6 +36636,7 @@ int handle_cublasCtrmm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtrmm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36210,6 +36686,7 @@ int handle_cublasCtrmm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtrmm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36259,6 +36736,7 @@ int handle_cublasZtrmm_v2(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtrmm_v2(handle, side, uplo, trans, diag, m, n,
                                           alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36308,6 +36786,7 @@ int handle_cublasZtrmm_v2_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtrmm_v2_64(handle, side, uplo, trans, diag, m,
                                              n, alpha, A, lda, B, ldb, &C, ldc);
 
@@ -36359,6 +36838,7 @@ int handle_cublasHgemmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasHgemmBatched(handle, transa, transb, m, n, k, alpha, Aarray, lda,
                          Barray, ldb, beta, Carray, ldc, batchCount);
@@ -36410,6 +36890,7 @@ int handle_cublasHgemmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasHgemmBatched_64(handle, transa, transb, m, n, k, alpha, Aarray, lda,
                             Barray, ldb, beta, Carray, ldc, batchCount);
@@ -36461,6 +36942,7 @@ int handle_cublasSgemmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgemmBatched(handle, transa, transb, m, n, k, alpha, Aarray, lda,
                          Barray, ldb, beta, Carray, ldc, batchCount);
@@ -36512,6 +36994,7 @@ int handle_cublasSgemmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgemmBatched_64(handle, transa, transb, m, n, k, alpha, Aarray, lda,
                             Barray, ldb, beta, Carray, ldc, batchCount);
@@ -36567,6 +37050,7 @@ int handle_cublasDgemmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDgemmBatched(handle, transa, transb, m, n, k, &alpha, Aarray, lda,
                          Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36622,6 +37106,7 @@ int handle_cublasDgemmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDgemmBatched_64(handle, transa, transb, m, n, k, &alpha, Aarray,
                             lda, Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36678,6 +37163,7 @@ int handle_cublasCgemmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgemmBatched(handle, transa, transb, m, n, k, &alpha, Aarray, lda,
                          Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36734,6 +37220,7 @@ int handle_cublasCgemmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgemmBatched_64(handle, transa, transb, m, n, k, &alpha, Aarray,
                             lda, Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36790,6 +37277,7 @@ int handle_cublasCgemm3mBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgemm3mBatched(handle, transa, transb, m, n, k, &alpha, Aarray, lda,
                            Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36846,6 +37334,7 @@ int handle_cublasCgemm3mBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgemm3mBatched_64(handle, transa, transb, m, n, k, &alpha, Aarray,
                               lda, Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36903,6 +37392,7 @@ int handle_cublasZgemmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgemmBatched(handle, transa, transb, m, n, k, &alpha, Aarray, lda,
                          Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -36960,6 +37450,7 @@ int handle_cublasZgemmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgemmBatched_64(handle, transa, transb, m, n, k, &alpha, Aarray,
                             lda, Barray, ldb, &beta, Carray, ldc, batchCount);
@@ -37021,6 +37512,7 @@ int handle_cublasHgemmStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHgemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37083,6 +37575,7 @@ int handle_cublasHgemmStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasHgemmStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37145,6 +37638,7 @@ int handle_cublasSgemmStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37207,6 +37701,7 @@ int handle_cublasSgemmStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgemmStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37269,6 +37764,7 @@ int handle_cublasDgemmStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37331,6 +37827,7 @@ int handle_cublasDgemmStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgemmStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37394,6 +37891,7 @@ int handle_cublasCgemmStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37457,6 +37955,7 @@ int handle_cublasCgemmStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemmStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37520,6 +38019,7 @@ int handle_cublasCgemm3mStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm3mStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37583,6 +38083,7 @@ int handle_cublasCgemm3mStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgemm3mStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37647,6 +38148,7 @@ int handle_cublasZgemmStridedBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37711,6 +38213,7 @@ int handle_cublasZgemmStridedBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgemmStridedBatched_64(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB,
       &beta, &C, ldc, strideC, batchCount);
@@ -37777,6 +38280,7 @@ int handle_cublasGemmBatchedEx_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasGemmBatchedEx_64(
       handle, transa, transb, m, n, k, &alpha, Aarray, Atype, lda, Barray,
       Btype, ldb, &beta, Carray, Ctype, ldc, batchCount, computeType, algo);
@@ -37828,6 +38332,7 @@ int handle_cublasSgeam(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgeam(handle, transa, transb, m, n, &alpha, A,
                                        lda, &beta, B, ldb, &C, ldc);
 
@@ -37879,6 +38384,7 @@ int handle_cublasSgeam_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgeam_64(handle, transa, transb, m, n, &alpha,
                                           A, lda, &beta, B, ldb, &C, ldc);
 
@@ -37930,6 +38436,7 @@ int handle_cublasDgeam(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgeam(handle, transa, transb, m, n, &alpha, A,
                                        lda, &beta, B, ldb, &C, ldc);
 
@@ -37981,6 +38488,7 @@ int handle_cublasDgeam_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgeam_64(handle, transa, transb, m, n, &alpha,
                                           A, lda, &beta, B, ldb, &C, ldc);
 
@@ -38033,6 +38541,7 @@ int handle_cublasCgeam(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgeam(handle, transa, transb, m, n, &alpha, A,
                                        lda, &beta, B, ldb, &C, ldc);
 
@@ -38085,6 +38594,7 @@ int handle_cublasCgeam_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgeam_64(handle, transa, transb, m, n, &alpha,
                                           A, lda, &beta, B, ldb, &C, ldc);
 
@@ -38138,6 +38648,7 @@ int handle_cublasZgeam(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgeam(handle, transa, transb, m, n, &alpha, A,
                                        lda, &beta, B, ldb, &C, ldc);
 
@@ -38191,6 +38702,7 @@ int handle_cublasZgeam_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgeam_64(handle, transa, transb, m, n, &alpha,
                                           A, lda, &beta, B, ldb, &C, ldc);
 
@@ -38240,6 +38752,7 @@ int handle_cublasStrsmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrsmBatched(handle, side, uplo, trans, diag, m, n, &alpha, A, lda,
                          B, ldb, batchCount);
@@ -38289,6 +38802,7 @@ int handle_cublasStrsmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasStrsmBatched_64(handle, side, uplo, trans, diag, m, n, &alpha, A,
                             lda, B, ldb, batchCount);
@@ -38338,6 +38852,7 @@ int handle_cublasDtrsmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrsmBatched(handle, side, uplo, trans, diag, m, n, &alpha, A, lda,
                          B, ldb, batchCount);
@@ -38387,6 +38902,7 @@ int handle_cublasDtrsmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDtrsmBatched_64(handle, side, uplo, trans, diag, m, n, &alpha, A,
                             lda, B, ldb, batchCount);
@@ -38437,6 +38953,7 @@ int handle_cublasCtrsmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrsmBatched(handle, side, uplo, trans, diag, m, n, &alpha, A, lda,
                          B, ldb, batchCount);
@@ -38487,6 +39004,7 @@ int handle_cublasCtrsmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCtrsmBatched_64(handle, side, uplo, trans, diag, m, n, &alpha, A,
                             lda, B, ldb, batchCount);
@@ -38537,6 +39055,7 @@ int handle_cublasZtrsmBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrsmBatched(handle, side, uplo, trans, diag, m, n, &alpha, A, lda,
                          B, ldb, batchCount);
@@ -38587,6 +39106,7 @@ int handle_cublasZtrsmBatched_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZtrsmBatched_64(handle, side, uplo, trans, diag, m, n, &alpha, A,
                             lda, B, ldb, batchCount);
@@ -38630,6 +39150,7 @@ int handle_cublasSdgmm(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSdgmm(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38673,6 +39194,7 @@ int handle_cublasSdgmm_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSdgmm_64(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38716,6 +39238,7 @@ int handle_cublasDdgmm(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDdgmm(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38759,6 +39282,7 @@ int handle_cublasDdgmm_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDdgmm_64(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38802,6 +39326,7 @@ int handle_cublasCdgmm(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCdgmm(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38845,6 +39370,7 @@ int handle_cublasCdgmm_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCdgmm_64(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38888,6 +39414,7 @@ int handle_cublasZdgmm(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZdgmm(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38931,6 +39458,7 @@ int handle_cublasZdgmm_64(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZdgmm_64(handle, mode, m, n, A, lda, &x, incx, &C, ldc);
 
@@ -38968,6 +39496,7 @@ int handle_cublasSmatinvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSmatinvBatched(handle, n, A, lda, Ainv, lda_inv, &info, batchSize);
 
@@ -39005,6 +39534,7 @@ int handle_cublasDmatinvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDmatinvBatched(handle, n, A, lda, Ainv, lda_inv, &info, batchSize);
 
@@ -39042,6 +39572,7 @@ int handle_cublasCmatinvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCmatinvBatched(handle, n, A, lda, Ainv, lda_inv, &info, batchSize);
 
@@ -39079,6 +39610,7 @@ int handle_cublasZmatinvBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZmatinvBatched(handle, n, A, lda, Ainv, lda_inv, &info, batchSize);
 
@@ -39116,6 +39648,7 @@ int handle_cublasSgeqrfBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasSgeqrfBatched(handle, m, n, Aarray, lda,
                                                TauArray, &info, batchSize);
 
@@ -39153,6 +39686,7 @@ int handle_cublasDgeqrfBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDgeqrfBatched(handle, m, n, Aarray, lda,
                                                TauArray, &info, batchSize);
 
@@ -39190,6 +39724,7 @@ int handle_cublasCgeqrfBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCgeqrfBatched(handle, m, n, Aarray, lda,
                                                TauArray, &info, batchSize);
 
@@ -39227,6 +39762,7 @@ int handle_cublasZgeqrfBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZgeqrfBatched(handle, m, n, Aarray, lda,
                                                TauArray, &info, batchSize);
 
@@ -39272,6 +39808,7 @@ int handle_cublasSgelsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgelsBatched(handle, trans, m, n, nrhs, Aarray, lda, Carray, ldc,
                          &info, &devInfoArray, batchSize);
@@ -39319,6 +39856,7 @@ int handle_cublasDgelsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDgelsBatched(handle, trans, m, n, nrhs, Aarray, lda, Carray, ldc,
                          &info, &devInfoArray, batchSize);
@@ -39366,6 +39904,7 @@ int handle_cublasCgelsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgelsBatched(handle, trans, m, n, nrhs, Aarray, lda, Carray, ldc,
                          &info, &devInfoArray, batchSize);
@@ -39413,6 +39952,7 @@ int handle_cublasZgelsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgelsBatched(handle, trans, m, n, nrhs, Aarray, lda, Carray, ldc,
                          &info, &devInfoArray, batchSize);
@@ -39450,6 +39990,7 @@ int handle_cublasStpttr(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStpttr(handle, uplo, n, &AP, &A, lda);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39484,6 +40025,7 @@ int handle_cublasDtpttr(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtpttr(handle, uplo, n, &AP, &A, lda);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39518,6 +40060,7 @@ int handle_cublasCtpttr(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtpttr(handle, uplo, n, &AP, &A, lda);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39553,6 +40096,7 @@ int handle_cublasZtpttr(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtpttr(handle, uplo, n, &AP, &A, lda);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39587,6 +40131,7 @@ int handle_cublasStrttp(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasStrttp(handle, uplo, n, &A, lda, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39621,6 +40166,7 @@ int handle_cublasDtrttp(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasDtrttp(handle, uplo, n, &A, lda, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39655,6 +40201,7 @@ int handle_cublasCtrttp(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasCtrttp(handle, uplo, n, &A, lda, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39689,6 +40236,7 @@ int handle_cublasZtrttp(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasZtrttp(handle, uplo, n, &A, lda, &AP);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -39729,6 +40277,7 @@ int handle_cublasSgetriBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgetriBatched(handle, n, A, lda, &P, C, ldc, &info, batchSize);
 
@@ -39770,6 +40319,7 @@ int handle_cublasDgetriBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDgetriBatched(handle, n, A, lda, &P, C, ldc, &info, batchSize);
 
@@ -39811,6 +40361,7 @@ int handle_cublasCgetriBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgetriBatched(handle, n, A, lda, &P, C, ldc, &info, batchSize);
 
@@ -39852,6 +40403,7 @@ int handle_cublasZgetriBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgetriBatched(handle, n, A, lda, &P, C, ldc, &info, batchSize);
 
@@ -39897,6 +40449,7 @@ int handle_cublasSgetrsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasSgetrsBatched(handle, trans, n, nrhs, Aarray, lda, &devIpiv, Barray,
                           ldb, &info, batchSize);
@@ -39943,6 +40496,7 @@ int handle_cublasDgetrsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasDgetrsBatched(handle, trans, n, nrhs, Aarray, lda, &devIpiv, Barray,
                           ldb, &info, batchSize);
@@ -39987,6 +40541,7 @@ int handle_cublasCgetrsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasCgetrsBatched(handle, trans, n, nrhs, Aarray, lda, devIpiv, Barray,
                           ldb, &info, batchSize);
@@ -40033,6 +40588,7 @@ int handle_cublasZgetrsBatched(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cublasZgetrsBatched(handle, trans, n, nrhs, Aarray, lda, &devIpiv, Barray,
                           ldb, &info, batchSize);
@@ -40091,6 +40647,7 @@ int handle_cublasUint8gemmBias(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cublasHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cublasUint8gemmBias(
       handle, transa, transb, transc, m, n, k, A, A_bias, lda, B, B_bias, ldb,
       &C, C_bias, ldc, C_mult, C_shift);
@@ -40132,18 +40689,22 @@ ERROR_0:
 int handle_cudnnCreate(void *conn) {
   cudnnHandle_t handle;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
-  if (false)
+  if (rpc_read(conn, &handle, sizeof(cudnnHandle_t)) < 0 || false)
     goto ERROR_0;
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)handle;
   scuda_intercept_result = cudnnCreate(&handle);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)handle);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &handle, sizeof(cudnnHandle_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -40161,6 +40722,7 @@ int handle_cudnnDestroy(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_unmap_handle(conn, (const void *)handle);
   scuda_intercept_result = cudnnDestroy(handle);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40184,6 +40746,8 @@ int handle_cudnnSetStream(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  streamId = (cudaStream_t)rpc_real_handle(conn, (const void *)streamId);
   scuda_intercept_result = cudnnSetStream(handle, streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40207,7 +40771,9 @@ int handle_cudnnGetStream(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cudnnGetStream(handle, &streamId);
+  streamId = (cudaStream_t)rpc_virtual_handle(conn, (const void *)streamId);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &streamId, sizeof(cudaStream_t)) < 0 ||
@@ -40405,6 +40971,7 @@ int handle_cudnnBackendExecute(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cudnnBackendExecute(handle, executionPlan, variantPack);
 
@@ -40433,6 +41000,7 @@ int handle_cudnnBackendPopulateCudaGraph(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cudnnBackendPopulateCudaGraph(handle, executionPlan, variantPack, graph);
 
@@ -40461,6 +41029,7 @@ int handle_cudnnBackendUpdateCudaGraph(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cudnnBackendUpdateCudaGraph(handle, executionPlan, variantPack, graph);
 
@@ -40476,6 +41045,7 @@ ERROR_0:
 int handle_cudnnCreateTensorDescriptor(void *conn) {
   cudnnTensorDescriptor_t tensorDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &tensorDesc, sizeof(cudnnTensorDescriptor_t)) < 0 || false)
     goto ERROR_0;
@@ -40483,11 +41053,14 @@ int handle_cudnnCreateTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)tensorDesc;
   scuda_intercept_result = cudnnCreateTensorDescriptor(&tensorDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)tensorDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &tensorDesc, sizeof(cudnnTensorDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -40517,6 +41090,8 @@ int handle_cudnnSetTensor4dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  tensorDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)tensorDesc);
   scuda_intercept_result =
       cudnnSetTensor4dDescriptor(tensorDesc, format, dataType, n, c, h, w);
 
@@ -40557,6 +41132,8 @@ int handle_cudnnSetTensor4dDescriptorEx(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  tensorDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)tensorDesc);
   scuda_intercept_result = cudnnSetTensor4dDescriptorEx(
       tensorDesc, dataType, n, c, h, w, nStride, cStride, hStride, wStride);
 
@@ -40597,6 +41174,8 @@ int handle_cudnnGetTensor4dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  tensorDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)tensorDesc);
   scuda_intercept_result =
       cudnnGetTensor4dDescriptor(tensorDesc, &dataType, &n, &c, &h, &w,
                                  &nStride, &cStride, &hStride, &wStride);
@@ -40631,6 +41210,8 @@ int handle_cudnnGetTensorSizeInBytes(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  tensorDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)tensorDesc);
   scuda_intercept_result = cudnnGetTensorSizeInBytes(tensorDesc, &size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40653,6 +41234,8 @@ int handle_cudnnDestroyTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  tensorDesc =
+      (cudnnTensorDescriptor_t)rpc_unmap_handle(conn, (const void *)tensorDesc);
   scuda_intercept_result = cudnnDestroyTensorDescriptor(tensorDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40681,6 +41264,12 @@ int handle_cudnnInitTransformDest(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  transformDesc = (cudnnTensorTransformDescriptor_t)rpc_real_handle(
+      conn, (const void *)transformDesc);
+  srcDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)srcDesc);
+  destDesc =
+      (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)destDesc);
   scuda_intercept_result = cudnnInitTransformDest(transformDesc, srcDesc,
                                                   destDesc, &destSizeInBytes);
 
@@ -40697,6 +41286,7 @@ ERROR_0:
 int handle_cudnnCreateTensorTransformDescriptor(void *conn) {
   cudnnTensorTransformDescriptor_t transformDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &transformDesc, sizeof(cudnnTensorTransformDescriptor_t)) <
           0 ||
@@ -40706,12 +41296,14 @@ int handle_cudnnCreateTensorTransformDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)transformDesc;
   scuda_intercept_result = cudnnCreateTensorTransformDescriptor(&transformDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)transformDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &transformDesc,
-                sizeof(cudnnTensorTransformDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -40731,6 +41323,8 @@ int handle_cudnnDestroyTensorTransformDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  transformDesc = (cudnnTensorTransformDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)transformDesc);
   scuda_intercept_result = cudnnDestroyTensorTransformDescriptor(transformDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40745,6 +41339,7 @@ ERROR_0:
 int handle_cudnnCreateOpTensorDescriptor(void *conn) {
   cudnnOpTensorDescriptor_t opTensorDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &opTensorDesc, sizeof(cudnnOpTensorDescriptor_t)) < 0 ||
       false)
@@ -40753,11 +41348,14 @@ int handle_cudnnCreateOpTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)opTensorDesc;
   scuda_intercept_result = cudnnCreateOpTensorDescriptor(&opTensorDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)opTensorDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &opTensorDesc, sizeof(cudnnOpTensorDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -40782,6 +41380,8 @@ int handle_cudnnSetOpTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  opTensorDesc = (cudnnOpTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)opTensorDesc);
   scuda_intercept_result = cudnnSetOpTensorDescriptor(
       opTensorDesc, opTensorOp, opTensorCompType, opTensorNanOpt);
 
@@ -40812,6 +41412,8 @@ int handle_cudnnGetOpTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  opTensorDesc = (cudnnOpTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)opTensorDesc);
   scuda_intercept_result = cudnnGetOpTensorDescriptor(
       opTensorDesc, &opTensorOp, &opTensorCompType, &opTensorNanOpt);
 
@@ -40838,6 +41440,8 @@ int handle_cudnnDestroyOpTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  opTensorDesc = (cudnnOpTensorDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)opTensorDesc);
   scuda_intercept_result = cudnnDestroyOpTensorDescriptor(opTensorDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40852,6 +41456,7 @@ ERROR_0:
 int handle_cudnnCreateReduceTensorDescriptor(void *conn) {
   cudnnReduceTensorDescriptor_t reduceTensorDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &reduceTensorDesc, sizeof(cudnnReduceTensorDescriptor_t)) <
           0 ||
@@ -40861,12 +41466,14 @@ int handle_cudnnCreateReduceTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)reduceTensorDesc;
   scuda_intercept_result = cudnnCreateReduceTensorDescriptor(&reduceTensorDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)reduceTensorDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &reduceTensorDesc,
-                sizeof(cudnnReduceTensorDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -40898,6 +41505,8 @@ int handle_cudnnSetReduceTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  reduceTensorDesc = (cudnnReduceTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)reduceTensorDesc);
   scuda_intercept_result = cudnnSetReduceTensorDescriptor(
       reduceTensorDesc, reduceTensorOp, reduceTensorCompType,
       reduceTensorNanOpt, reduceTensorIndices, reduceTensorIndicesType);
@@ -40935,6 +41544,8 @@ int handle_cudnnGetReduceTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  reduceTensorDesc = (cudnnReduceTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)reduceTensorDesc);
   scuda_intercept_result = cudnnGetReduceTensorDescriptor(
       reduceTensorDesc, &reduceTensorOp, &reduceTensorCompType,
       &reduceTensorNanOpt, &reduceTensorIndices, &reduceTensorIndicesType);
@@ -40967,6 +41578,8 @@ int handle_cudnnDestroyReduceTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  reduceTensorDesc = (cudnnReduceTensorDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)reduceTensorDesc);
   scuda_intercept_result = cudnnDestroyReduceTensorDescriptor(reduceTensorDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -40997,6 +41610,11 @@ int handle_cudnnGetReductionIndicesSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  reduceTensorDesc = (cudnnReduceTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)reduceTensorDesc);
+  aDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)aDesc);
+  cDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)cDesc);
   scuda_intercept_result = cudnnGetReductionIndicesSize(
       handle, reduceTensorDesc, aDesc, cDesc, &sizeInBytes);
 
@@ -41029,6 +41647,11 @@ int handle_cudnnGetReductionWorkspaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  reduceTensorDesc = (cudnnReduceTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)reduceTensorDesc);
+  aDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)aDesc);
+  cDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)cDesc);
   scuda_intercept_result = cudnnGetReductionWorkspaceSize(
       handle, reduceTensorDesc, aDesc, cDesc, &sizeInBytes);
 
@@ -41045,6 +41668,7 @@ ERROR_0:
 int handle_cudnnCreateFilterDescriptor(void *conn) {
   cudnnFilterDescriptor_t filterDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &filterDesc, sizeof(cudnnFilterDescriptor_t)) < 0 || false)
     goto ERROR_0;
@@ -41052,11 +41676,14 @@ int handle_cudnnCreateFilterDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)filterDesc;
   scuda_intercept_result = cudnnCreateFilterDescriptor(&filterDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)filterDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &filterDesc, sizeof(cudnnFilterDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41086,6 +41713,8 @@ int handle_cudnnSetFilter4dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  filterDesc =
+      (cudnnFilterDescriptor_t)rpc_real_handle(conn, (const void *)filterDesc);
   scuda_intercept_result =
       cudnnSetFilter4dDescriptor(filterDesc, dataType, format, k, c, h, w);
 
@@ -41120,6 +41749,8 @@ int handle_cudnnGetFilter4dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  filterDesc =
+      (cudnnFilterDescriptor_t)rpc_real_handle(conn, (const void *)filterDesc);
   scuda_intercept_result = cudnnGetFilter4dDescriptor(filterDesc, &dataType,
                                                       &format, &k, &c, &h, &w);
 
@@ -41150,6 +41781,8 @@ int handle_cudnnGetFilterSizeInBytes(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  filterDesc =
+      (cudnnFilterDescriptor_t)rpc_real_handle(conn, (const void *)filterDesc);
   scuda_intercept_result = cudnnGetFilterSizeInBytes(filterDesc, &size);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41172,6 +41805,8 @@ int handle_cudnnDestroyFilterDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  filterDesc =
+      (cudnnFilterDescriptor_t)rpc_unmap_handle(conn, (const void *)filterDesc);
   scuda_intercept_result = cudnnDestroyFilterDescriptor(filterDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41186,6 +41821,7 @@ ERROR_0:
 int handle_cudnnCreatePoolingDescriptor(void *conn) {
   cudnnPoolingDescriptor_t poolingDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &poolingDesc, sizeof(cudnnPoolingDescriptor_t)) < 0 ||
       false)
@@ -41194,11 +41830,14 @@ int handle_cudnnCreatePoolingDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)poolingDesc;
   scuda_intercept_result = cudnnCreatePoolingDescriptor(&poolingDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)poolingDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &poolingDesc, sizeof(cudnnPoolingDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41232,6 +41871,8 @@ int handle_cudnnSetPooling2dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  poolingDesc = (cudnnPoolingDescriptor_t)rpc_real_handle(
+      conn, (const void *)poolingDesc);
   scuda_intercept_result = cudnnSetPooling2dDescriptor(
       poolingDesc, mode, maxpoolingNanOpt, windowHeight, windowWidth,
       verticalPadding, horizontalPadding, verticalStride, horizontalStride);
@@ -41272,6 +41913,8 @@ int handle_cudnnGetPooling2dDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  poolingDesc = (cudnnPoolingDescriptor_t)rpc_real_handle(
+      conn, (const void *)poolingDesc);
   scuda_intercept_result = cudnnGetPooling2dDescriptor(
       poolingDesc, &mode, &maxpoolingNanOpt, &windowHeight, &windowWidth,
       &verticalPadding, &horizontalPadding, &verticalStride, &horizontalStride);
@@ -41315,6 +41958,10 @@ int handle_cudnnGetPooling2dForwardOutputDim(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  poolingDesc = (cudnnPoolingDescriptor_t)rpc_real_handle(
+      conn, (const void *)poolingDesc);
+  inputTensorDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)inputTensorDesc);
   scuda_intercept_result = cudnnGetPooling2dForwardOutputDim(
       poolingDesc, inputTensorDesc, &n, &c, &h, &w);
 
@@ -41342,6 +41989,8 @@ int handle_cudnnDestroyPoolingDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  poolingDesc = (cudnnPoolingDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)poolingDesc);
   scuda_intercept_result = cudnnDestroyPoolingDescriptor(poolingDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41356,6 +42005,7 @@ ERROR_0:
 int handle_cudnnCreateActivationDescriptor(void *conn) {
   cudnnActivationDescriptor_t activationDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &activationDesc, sizeof(cudnnActivationDescriptor_t)) <
           0 ||
@@ -41365,12 +42015,14 @@ int handle_cudnnCreateActivationDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)activationDesc;
   scuda_intercept_result = cudnnCreateActivationDescriptor(&activationDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)activationDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &activationDesc, sizeof(cudnnActivationDescriptor_t)) <
-          0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41395,6 +42047,8 @@ int handle_cudnnSetActivationDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result =
       cudnnSetActivationDescriptor(activationDesc, mode, reluNanOpt, coef);
 
@@ -41424,6 +42078,8 @@ int handle_cudnnGetActivationDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result =
       cudnnGetActivationDescriptor(activationDesc, &mode, &reluNanOpt, &coef);
 
@@ -41452,6 +42108,8 @@ int handle_cudnnSetActivationDescriptorSwishBeta(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result =
       cudnnSetActivationDescriptorSwishBeta(activationDesc, swish_beta);
 
@@ -41477,6 +42135,8 @@ int handle_cudnnGetActivationDescriptorSwishBeta(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result =
       cudnnGetActivationDescriptorSwishBeta(activationDesc, &swish_beta);
 
@@ -41502,6 +42162,8 @@ int handle_cudnnDestroyActivationDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  activationDesc = (cudnnActivationDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result = cudnnDestroyActivationDescriptor(activationDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41542,11 +42204,17 @@ int handle_cudnnActivationForward(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
+  yDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)yDesc);
   scuda_intercept_result = cudnnActivationForward(
       handle, activationDesc, &alpha, xDesc, x, &beta, yDesc, y);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41557,6 +42225,7 @@ ERROR_0:
 int handle_cudnnCreateLRNDescriptor(void *conn) {
   cudnnLRNDescriptor_t normDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &normDesc, sizeof(cudnnLRNDescriptor_t)) < 0 || false)
     goto ERROR_0;
@@ -41564,11 +42233,14 @@ int handle_cudnnCreateLRNDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)normDesc;
   scuda_intercept_result = cudnnCreateLRNDescriptor(&normDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)normDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &normDesc, sizeof(cudnnLRNDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41594,6 +42266,8 @@ int handle_cudnnSetLRNDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  normDesc =
+      (cudnnLRNDescriptor_t)rpc_real_handle(conn, (const void *)normDesc);
   scuda_intercept_result =
       cudnnSetLRNDescriptor(normDesc, lrnN, lrnAlpha, lrnBeta, lrnK);
 
@@ -41624,6 +42298,8 @@ int handle_cudnnGetLRNDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  normDesc =
+      (cudnnLRNDescriptor_t)rpc_real_handle(conn, (const void *)normDesc);
   scuda_intercept_result =
       cudnnGetLRNDescriptor(normDesc, &lrnN, &lrnAlpha, &lrnBeta, &lrnK);
 
@@ -41650,6 +42326,7 @@ int handle_cudnnDestroyLRNDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  lrnDesc = (cudnnLRNDescriptor_t)rpc_unmap_handle(conn, (const void *)lrnDesc);
   scuda_intercept_result = cudnnDestroyLRNDescriptor(lrnDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41675,6 +42352,9 @@ int handle_cudnnDeriveBNTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  derivedBnDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)derivedBnDesc);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
   scuda_intercept_result =
       cudnnDeriveBNTensorDescriptor(derivedBnDesc, xDesc, mode);
 
@@ -41707,6 +42387,11 @@ int handle_cudnnDeriveNormTensorDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  derivedNormScaleBiasDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)derivedNormScaleBiasDesc);
+  derivedNormMeanVarDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)derivedNormMeanVarDesc);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
   scuda_intercept_result = cudnnDeriveNormTensorDescriptor(
       derivedNormScaleBiasDesc, derivedNormMeanVarDesc, xDesc, mode, groupCnt);
 
@@ -41722,6 +42407,7 @@ ERROR_0:
 int handle_cudnnCreateSpatialTransformerDescriptor(void *conn) {
   cudnnSpatialTransformerDescriptor_t stDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &stDesc, sizeof(cudnnSpatialTransformerDescriptor_t)) <
           0 ||
@@ -41731,12 +42417,14 @@ int handle_cudnnCreateSpatialTransformerDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)stDesc;
   scuda_intercept_result = cudnnCreateSpatialTransformerDescriptor(&stDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)stDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &stDesc, sizeof(cudnnSpatialTransformerDescriptor_t)) <
-          0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41756,6 +42444,8 @@ int handle_cudnnDestroySpatialTransformerDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  stDesc = (cudnnSpatialTransformerDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)stDesc);
   scuda_intercept_result = cudnnDestroySpatialTransformerDescriptor(stDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41770,6 +42460,7 @@ ERROR_0:
 int handle_cudnnCreateDropoutDescriptor(void *conn) {
   cudnnDropoutDescriptor_t dropoutDesc;
   int request_id;
+  const void *scuda_virtual_handle;
   cudnnStatus_t scuda_intercept_result;
   if (rpc_read(conn, &dropoutDesc, sizeof(cudnnDropoutDescriptor_t)) < 0 ||
       false)
@@ -41778,11 +42469,14 @@ int handle_cudnnCreateDropoutDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  scuda_virtual_handle = (const void *)dropoutDesc;
   scuda_intercept_result = cudnnCreateDropoutDescriptor(&dropoutDesc);
+  if (scuda_intercept_result == CUDNN_STATUS_SUCCESS)
+    rpc_map_handle(conn, scuda_virtual_handle, (const void *)dropoutDesc);
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_write(conn, &dropoutDesc, sizeof(cudnnDropoutDescriptor_t)) < 0 ||
-      rpc_end_response(conn, &scuda_intercept_result) < 0)
+  if (rpc_defer_error(conn, scuda_intercept_result == CUDNN_STATUS_SUCCESS
+                                ? cudaSuccess
+                                : cudaErrorLaunchFailure) < 0)
     goto ERROR_0;
 
   return 0;
@@ -41801,6 +42495,8 @@ int handle_cudnnDestroyDropoutDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dropoutDesc = (cudnnDropoutDescriptor_t)rpc_unmap_handle(
+      conn, (const void *)dropoutDesc);
   scuda_intercept_result = cudnnDestroyDropoutDescriptor(dropoutDesc);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41824,6 +42520,7 @@ int handle_cudnnDropoutGetStatesSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result = cudnnDropoutGetStatesSize(handle, &sizeInBytes);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41848,6 +42545,7 @@ int handle_cudnnDropoutGetReserveSpaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  xdesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xdesc);
   scuda_intercept_result = cudnnDropoutGetReserveSpaceSize(xdesc, &sizeInBytes);
 
   if (rpc_start_response(conn, request_id) < 0 ||
@@ -41878,6 +42576,9 @@ int handle_cudnnGetDropoutDescriptor(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  dropoutDesc = (cudnnDropoutDescriptor_t)rpc_real_handle(
+      conn, (const void *)dropoutDesc);
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
   scuda_intercept_result =
       cudnnGetDropoutDescriptor(dropoutDesc, handle, &dropout, &states, &seed);
 
@@ -41989,6 +42690,16 @@ int handle_cudnnGetBatchNormalizationBackwardExWorkspaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
+  yDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)yDesc);
+  dyDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dyDesc);
+  dzDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dzDesc);
+  dxDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dxDesc);
+  dBnScaleBiasDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)dBnScaleBiasDesc);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
   scuda_intercept_result = cudnnGetBatchNormalizationBackwardExWorkspaceSize(
       handle, mode, bnOps, xDesc, yDesc, dyDesc, dzDesc, dxDesc,
       dBnScaleBiasDesc, activationDesc, &sizeInBytes);
@@ -42024,6 +42735,10 @@ int handle_cudnnGetBatchNormalizationTrainingExReserveSpaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
   scuda_intercept_result = cudnnGetBatchNormalizationTrainingExReserveSpaceSize(
       handle, mode, bnOps, activationDesc, xDesc, &sizeInBytes);
 
@@ -42072,6 +42787,16 @@ int handle_cudnnGetNormalizationForwardTrainingWorkspaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
+  zDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)zDesc);
+  yDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)yDesc);
+  normScaleBiasDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)normScaleBiasDesc);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
+  normMeanVarDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)normMeanVarDesc);
   scuda_intercept_result = cudnnGetNormalizationForwardTrainingWorkspaceSize(
       handle, mode, normOps, algo, xDesc, zDesc, yDesc, normScaleBiasDesc,
       activationDesc, normMeanVarDesc, &sizeInBytes, groupCnt);
@@ -42125,6 +42850,18 @@ int handle_cudnnGetNormalizationBackwardWorkspaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
+  yDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)yDesc);
+  dyDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dyDesc);
+  dzDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dzDesc);
+  dxDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)dxDesc);
+  dNormScaleBiasDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)dNormScaleBiasDesc);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
+  normMeanVarDesc = (cudnnTensorDescriptor_t)rpc_real_handle(
+      conn, (const void *)normMeanVarDesc);
   scuda_intercept_result = cudnnGetNormalizationBackwardWorkspaceSize(
       handle, mode, normOps, algo, xDesc, yDesc, dyDesc, dzDesc, dxDesc,
       dNormScaleBiasDesc, activationDesc, normMeanVarDesc, &sizeInBytes,
@@ -42165,6 +42902,10 @@ int handle_cudnnGetNormalizationTrainingReserveSpaceSize(void *conn) {
   request_id = rpc_end_request(conn);
   if (request_id < 0)
     goto ERROR_0;
+  handle = (cudnnHandle_t)rpc_real_handle(conn, (const void *)handle);
+  activationDesc = (cudnnActivationDescriptor_t)rpc_real_handle(
+      conn, (const void *)activationDesc);
+  xDesc = (cudnnTensorDescriptor_t)rpc_real_handle(conn, (const void *)xDesc);
   scuda_intercept_result = cudnnGetNormalizationTrainingReserveSpaceSize(
       handle, mode, normOps, algo, activationDesc, xDesc, &sizeInBytes,
       groupCnt);
@@ -43594,6 +44335,9 @@ static RequestHandler opHandlers[] = {
     handle_cudnnGetNormalizationForwardTrainingWorkspaceSize,
     handle_cudnnGetNormalizationBackwardWorkspaceSize,
     handle_cudnnGetNormalizationTrainingReserveSpaceSize,
+    handle___scudaGetDeviceSnapshot,
+    handle___scudaSetThreadState,
+    handle___scudaFreeBatch,
 };
 
 RequestHandler get_handler(const int op) {
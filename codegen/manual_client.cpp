@@ -6,12 +6,15 @@
 #include <iostream>
 #include <nvml.h>
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "dedup.h"
 #include "gen_api.h"
+#include "snapshot.h"
 #include "ptx_fatbin.hpp"
 
 size_t decompress(const uint8_t *input, size_t input_size, uint8_t *output,
@@ -25,11 +28,47 @@ extern int rpc_wait_for_response(const int index);
 extern int rpc_read(const int index, void *data, const std::size_t size);
 extern int rpc_end_response(const int index, void *return_value);
 extern int rpc_close();
+extern int rpc_write_compressed(const int index, const void *data,
+                                const std::size_t size);
+extern int rpc_read_compressed(const int index, void *data,
+                               const std::size_t size);
+extern int rpc_start_stripes(const int index, const std::size_t size);
+extern int rpc_write_stripes(const int index, const void *data,
+                             const std::size_t size, const int stripes);
+extern int rpc_read_stripes(const int index, void *data,
+                            const std::size_t size, const int stripes);
+extern int rpc_end_stripes(const int index, const int stripes);
+extern int rpc_start_dedup(const int index, const std::size_t size);
+extern int rpc_end_dedup(const int index);
 extern cudaError_t cuda_memcpy_unified_ptrs(const int index,
-                                            cudaMemcpyKind kind);
+                                            cudaMemcpyKind kind,
+                                            cudaStream_t stream);
 extern void *maybe_free_unified_mem(const int index, void *ptr);
-extern void allocate_unified_mem_pointer(const int index, void *dev_ptr,
-                                         size_t size);
+extern std::size_t unified_allocation_size(const std::size_t size);
+extern void *allocate_unified_mem_pointer(const int index, void *allocation,
+                                          size_t size);
+extern int unified_prepare(const void *ptr, const std::size_t size,
+                           const bool write);
+extern int rpc_device_count();
+extern int rpc_get_device();
+extern void rpc_set_device(const int device);
+extern int rpc_current_conn();
+extern int rpc_device_conn(int *device);
+extern int rpc_handle_conn(const void *handle);
+extern void rpc_unregister_handle(const int index, const void *handle);
+extern cudaError_t rpc_cached_malloc(void **devPtr, const std::size_t size);
+extern bool rpc_cached_free(const int index, const void *devPtr);
+extern int rpc_device_properties(const int device, cudaDeviceProp *prop,
+                                 cudaError_t *result);
+extern int rpc_device_attribute(const int device, const int attr, int *value,
+                                cudaError_t *result);
+extern int rpc_cu_device_attribute(const int device, const int attr,
+                                   int *value, CUresult *result);
+extern int rpc_server_snapshot(snapshot_t *snapshot);
+extern int rpc_exchange_capture_mode(const int mode);
+extern void rpc_record_error(const cudaError_t error);
+extern cudaError_t rpc_last_error(const bool clear);
+extern bool rpc_capturing();
 
 #define MAX_FUNCTION_NAME 1024
 #define MAX_ARGS 128
@@ -161,40 +200,166 @@ struct Function {
 
 std::vector<Function> functions;
 
+// upload only the chunks of src the server doesn't already hold. see dedup.h
+// for the two requests this takes.
+static cudaError_t cuda_memcpy_dedup(const int index, void *dst,
+                                     const void *src, size_t count) {
+  cudaError_t return_value;
+  enum cudaMemcpyKind kind = cudaMemcpyHostToDevice;
+  int stripes = 0;
+  int dedup = DEDUP_QUERY;
+  size_t chunks = (count + DEDUP_CHUNK - 1) / DEDUP_CHUNK;
+  std::vector<dedup_hash_t> hashes(chunks);
+  std::vector<char> missing(chunks);
+
+  for (size_t i = 0; i < chunks; i++)
+    hashes[i] = dedup_hash((char *)src + i * DEDUP_CHUNK,
+                           std::min((size_t)DEDUP_CHUNK,
+                                    count - i * DEDUP_CHUNK));
+
+  if (rpc_start_request(index, RPC_cudaMemcpy) < 0 ||
+      rpc_write(index, &kind, sizeof(enum cudaMemcpyKind)) < 0 ||
+      rpc_write(index, &dst, sizeof(void *)) < 0 ||
+      rpc_write(index, &count, sizeof(size_t)) < 0 ||
+      rpc_write(index, &stripes, sizeof(int)) < 0 ||
+      rpc_write(index, &dedup, sizeof(int)) < 0 ||
+      rpc_write(index, &chunks, sizeof(size_t)) < 0 ||
+      rpc_write(index, hashes.data(), chunks * sizeof(dedup_hash_t)) < 0 ||
+      rpc_wait_for_response(index) < 0 ||
+      rpc_read(index, missing.data(), chunks) < 0 ||
+      rpc_end_response(index, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+
+  // the server has already copied the chunks it held.
+  size_t sent = std::count(missing.begin(), missing.end(), 1);
+  if (return_value == cudaSuccess)
+    std::cout << "Deduplicated copy sent " << sent << " of " << chunks
+              << " chunks" << std::endl;
+  if (return_value != cudaSuccess || sent == 0)
+    return return_value;
+
+  dedup = DEDUP_MISSING;
+  if (rpc_start_request(index, RPC_cudaMemcpy) < 0 ||
+      rpc_write(index, &kind, sizeof(enum cudaMemcpyKind)) < 0 ||
+      rpc_write(index, &dst, sizeof(void *)) < 0 ||
+      rpc_write(index, &count, sizeof(size_t)) < 0 ||
+      rpc_write(index, &stripes, sizeof(int)) < 0 ||
+      rpc_write(index, &dedup, sizeof(int)) < 0)
+    return cudaErrorDevicesUnavailable;
+
+  // runs of missing chunks go out as one piece each.
+  for (size_t i = 0; i < chunks; i++) {
+    if (!missing[i])
+      continue;
+    size_t end = i;
+    while (end < chunks && missing[end])
+      end++;
+    size_t offset = i * DEDUP_CHUNK;
+    if (rpc_write(index, (char *)src + offset,
+                  std::min(end * DEDUP_CHUNK, count) - offset) < 0)
+      return cudaErrorDevicesUnavailable;
+    i = end;
+  }
+
+  if (rpc_wait_for_response(index) < 0 ||
+      rpc_end_response(index, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+  return return_value;
+}
+
 cudaError_t cudaMemcpy(void *dst, const void *src, size_t count,
                        enum cudaMemcpyKind kind) {
   cudaError_t return_value;
+  int dedup = DEDUP_NONE;
+
+  // copies go to the server holding the device memory. a device to device
+  // copy between two servers goes through the host.
+  const int scuda_conn =
+      rpc_handle_conn(kind == cudaMemcpyDeviceToHost ? src : dst);
+  if (scuda_conn < 0) {
+    rpc_record_error(cudaErrorInvalidValue);
+    return cudaErrorInvalidValue;
+  }
+  if (kind == cudaMemcpyDeviceToDevice && rpc_handle_conn(src) != scuda_conn) {
+    std::vector<char> staging(count);
+    return_value =
+        cudaMemcpy(staging.data(), src, count, cudaMemcpyDeviceToHost);
+    if (return_value != cudaSuccess)
+      return return_value;
+    return cudaMemcpy(dst, staging.data(), count, cudaMemcpyHostToDevice);
+  }
+
+  // the host side may be managed memory, which the request reads or writes
+  // while it holds the connection.
+  if ((kind == cudaMemcpyHostToDevice &&
+       unified_prepare(src, count, false) < 0) ||
+      (kind == cudaMemcpyDeviceToHost && unified_prepare(dst, count, true) < 0))
+    return cudaErrorUnknown;
+
+  if (kind == cudaMemcpyHostToDevice && rpc_start_dedup(scuda_conn, count)) {
+    return_value = cuda_memcpy_dedup(scuda_conn, dst, src, count);
+    if (rpc_end_dedup(scuda_conn) < 0)
+      return cudaErrorDevicesUnavailable;
+    return return_value;
+  }
+
+  // large host transfers are striped across the data connections, if any.
+  // the stripes are taken before the request so that concurrent copies use
+  // the data connections in the same order the server handles them.
+  int stripes = kind == cudaMemcpyDeviceToDevice
+                    ? 0
+                    : rpc_start_stripes(scuda_conn, count);
 
-  int request_id = rpc_start_request(0, RPC_cudaMemcpy);
-  if (request_id < 0 || rpc_write(0, &kind, sizeof(enum cudaMemcpyKind)) < 0)
+  int request_id = rpc_start_request(scuda_conn, RPC_cudaMemcpy);
+  if (request_id < 0 ||
+      rpc_write(scuda_conn, &kind, sizeof(enum cudaMemcpyKind)) < 0) {
+    rpc_end_stripes(scuda_conn, stripes);
     return cudaErrorDevicesUnavailable;
+  }
 
   // we need to swap device directions in this case
   switch (kind) {
   case cudaMemcpyDeviceToHost:
-    if (rpc_write(0, &src, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_wait_for_response(0) < 0 || rpc_read(0, dst, count) < 0)
+    if (rpc_write(scuda_conn, &src, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_write(scuda_conn, &stripes, sizeof(int)) < 0 ||
+        rpc_wait_for_response(scuda_conn) < 0 ||
+        (stripes == 0 && rpc_read_compressed(scuda_conn, dst, count) < 0) ||
+        rpc_end_response(scuda_conn, &return_value) < 0 ||
+        (stripes > 0 && return_value == cudaSuccess &&
+         rpc_read_stripes(scuda_conn, dst, count, stripes) < 0)) {
+      rpc_end_stripes(scuda_conn, stripes);
       return cudaErrorDevicesUnavailable;
+    }
     break;
   case cudaMemcpyHostToDevice:
-    if (rpc_write(0, &dst, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_write(0, src, count) < 0 || rpc_wait_for_response(0) < 0)
+    if (rpc_write(scuda_conn, &dst, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_write(scuda_conn, &stripes, sizeof(int)) < 0 ||
+        rpc_write(scuda_conn, &dedup, sizeof(int)) < 0 ||
+        (stripes == 0 && rpc_write_compressed(scuda_conn, src, count) < 0) ||
+        (stripes > 0 &&
+         rpc_write_stripes(scuda_conn, src, count, stripes) < 0) ||
+        rpc_wait_for_response(scuda_conn) < 0 ||
+        rpc_end_response(scuda_conn, &return_value) < 0) {
+      rpc_end_stripes(scuda_conn, stripes);
       return cudaErrorDevicesUnavailable;
+    }
     break;
   case cudaMemcpyDeviceToDevice:
-    if (rpc_write(0, &dst, sizeof(void *)) < 0 ||
-        rpc_write(0, &src, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_wait_for_response(0) < 0)
+    if (rpc_write(scuda_conn, &dst, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &src, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_wait_for_response(scuda_conn) < 0 ||
+        rpc_end_response(scuda_conn, &return_value) < 0)
       return cudaErrorDevicesUnavailable;
     break;
   }
 
-  if (rpc_end_response(0, &return_value) < 0)
+  if (rpc_end_stripes(scuda_conn, stripes) < 0)
     return cudaErrorDevicesUnavailable;
 
+  rpc_record_error(return_value);
   return return_value;
 }
 
@@ -202,40 +367,60 @@ cudaError_t cudaMemcpyAsync(void *dst, const void *src, size_t count,
                             enum cudaMemcpyKind kind, cudaStream_t stream) {
   cudaError_t return_value;
 
-  int request_id = rpc_start_request(0, RPC_cudaMemcpyAsync);
+  const int scuda_conn =
+      rpc_handle_conn(kind == cudaMemcpyDeviceToHost ? src : dst);
+  if (scuda_conn < 0) {
+    rpc_record_error(cudaErrorInvalidValue);
+    return cudaErrorInvalidValue;
+  }
+  if (kind == cudaMemcpyDeviceToDevice && rpc_handle_conn(src) != scuda_conn)
+    return cudaMemcpy(dst, src, count, kind);
+
+  if ((kind == cudaMemcpyHostToDevice &&
+       unified_prepare(src, count, false) < 0) ||
+      (kind == cudaMemcpyDeviceToHost && unified_prepare(dst, count, true) < 0))
+    return cudaErrorUnknown;
+
+  int request_id = rpc_start_request(scuda_conn, RPC_cudaMemcpyAsync);
   int stream_null_check = stream == 0 ? 1 : 0;
-  if (request_id < 0 || rpc_write(0, &kind, sizeof(enum cudaMemcpyKind)) < 0 ||
-      rpc_write(0, &stream_null_check, sizeof(int)) < 0 ||
+  if (request_id < 0 ||
+      rpc_write(scuda_conn, &kind, sizeof(enum cudaMemcpyKind)) < 0 ||
+      rpc_write(scuda_conn, &stream_null_check, sizeof(int)) < 0 ||
       (stream_null_check == 0 &&
-       rpc_write(0, &stream, sizeof(cudaStream_t)) < 0))
+       rpc_write(scuda_conn, &stream, sizeof(cudaStream_t)) < 0))
     return cudaErrorDevicesUnavailable;
 
-  // we need to swap device directions in this case
+  // we need to swap device directions in this case. only device to host
+  // copies wait for a response; the others are fire-and-forget and the server
+  // reports any error at the next sync point.
   switch (kind) {
   case cudaMemcpyDeviceToHost:
-    if (rpc_write(0, &src, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_wait_for_response(0) < 0 || rpc_read(0, dst, count) < 0)
+    if (rpc_write(scuda_conn, &src, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_wait_for_response(scuda_conn) < 0 ||
+        rpc_read_compressed(scuda_conn, dst, count) < 0)
       return cudaErrorDevicesUnavailable;
     break;
   case cudaMemcpyHostToDevice:
-    if (rpc_write(0, &dst, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_write(0, src, count) < 0 || rpc_wait_for_response(0) < 0)
+    if (rpc_write(scuda_conn, &dst, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_write_compressed(scuda_conn, src, count) < 0 ||
+        rpc_end_request(scuda_conn) < 0)
       return cudaErrorDevicesUnavailable;
-    break;
+    return cudaSuccess;
   case cudaMemcpyDeviceToDevice:
-    if (rpc_write(0, &dst, sizeof(void *)) < 0 ||
-        rpc_write(0, &src, sizeof(void *)) < 0 ||
-        rpc_write(0, &count, sizeof(size_t)) < 0 ||
-        rpc_wait_for_response(0) < 0)
+    if (rpc_write(scuda_conn, &dst, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &src, sizeof(void *)) < 0 ||
+        rpc_write(scuda_conn, &count, sizeof(size_t)) < 0 ||
+        rpc_end_request(scuda_conn) < 0)
       return cudaErrorDevicesUnavailable;
-    break;
+    return cudaSuccess;
   }
 
-  if (rpc_end_response(0, &return_value) < 0)
+  if (rpc_end_response(scuda_conn, &return_value) < 0)
     return cudaErrorDevicesUnavailable;
 
+  rpc_record_error(return_value);
   return return_value;
 }
 
@@ -328,45 +513,56 @@ const char *cudaGetErrorString(cudaError_t error) {
 cudaError_t cudaLaunchKernel(const void *func, dim3 gridDim, dim3 blockDim,
                              void **args, size_t sharedMem,
                              cudaStream_t stream) {
-  cudaError_t return_value;
   cudaError_t memcpy_return;
+  const int scuda_conn = rpc_handle_conn((const void *)stream);
+  if (scuda_conn < 0) {
+    rpc_record_error(cudaErrorInvalidValue);
+    return cudaErrorInvalidValue;
+  }
 
-  memcpy_return = cuda_memcpy_unified_ptrs(0, cudaMemcpyHostToDevice);
-  if (memcpy_return != cudaSuccess)
-    return memcpy_return;
-
-  // Start the RPC request
-  int request_id = rpc_start_request(0, RPC_cudaLaunchKernel);
-  if (request_id < 0 || rpc_write(0, &func, sizeof(const void *)) < 0 ||
-      rpc_write(0, &gridDim, sizeof(dim3)) < 0 ||
-      rpc_write(0, &blockDim, sizeof(dim3)) < 0 ||
-      rpc_write(0, &sharedMem, sizeof(size_t)) < 0 ||
-      rpc_write(0, &stream, sizeof(cudaStream_t)) < 0)
-    return cudaErrorDevicesUnavailable;
-
+  // look the kernel up before the request is started: once it is, write_mutex
+  // is held until the request ends. a failed rpc_write has already released
+  // it, so every error path below leaves the connection usable.
   Function *f = nullptr;
   for (auto &function : functions)
     if (function.host_func == func)
       f = &function;
+  if (f == nullptr)
+    return cudaErrorInvalidDeviceFunction;
+
+  memcpy_return =
+      cuda_memcpy_unified_ptrs(scuda_conn, cudaMemcpyHostToDevice, stream);
+  if (memcpy_return != cudaSuccess)
+    return memcpy_return;
 
-  if (f == nullptr || rpc_write(0, &f->arg_count, sizeof(int)) < 0)
+  // Start the RPC request
+  int request_id = rpc_start_request(scuda_conn, RPC_cudaLaunchKernel);
+  if (request_id < 0 ||
+      rpc_write(scuda_conn, &func, sizeof(const void *)) < 0 ||
+      rpc_write(scuda_conn, &gridDim, sizeof(dim3)) < 0 ||
+      rpc_write(scuda_conn, &blockDim, sizeof(dim3)) < 0 ||
+      rpc_write(scuda_conn, &sharedMem, sizeof(size_t)) < 0 ||
+      rpc_write(scuda_conn, &stream, sizeof(cudaStream_t)) < 0 ||
+      rpc_write(scuda_conn, &f->arg_count, sizeof(int)) < 0)
     return cudaErrorDevicesUnavailable;
 
   for (int i = 0; i < f->arg_count; ++i) {
-    if (rpc_write(0, &f->arg_sizes[i], sizeof(int)) < 0 ||
-        rpc_write(0, args[i], f->arg_sizes[i]) < 0)
+    if (rpc_write(scuda_conn, &f->arg_sizes[i], sizeof(int)) < 0 ||
+        rpc_write(scuda_conn, args[i], f->arg_sizes[i]) < 0)
       return cudaErrorDevicesUnavailable;
   }
 
-  if (rpc_wait_for_response(0) < 0 || rpc_end_response(0, &return_value) < 0) {
+  // launches don't wait for the server; launch errors are reported by the
+  // next sync point instead.
+  if (rpc_end_request(scuda_conn) < 0)
     return cudaErrorDevicesUnavailable;
-  }
 
-  memcpy_return = cuda_memcpy_unified_ptrs(0, cudaMemcpyDeviceToHost);
+  memcpy_return =
+      cuda_memcpy_unified_ptrs(scuda_conn, cudaMemcpyDeviceToHost, stream);
   if (memcpy_return != cudaSuccess)
     return memcpy_return;
 
-  return return_value;
+  return cudaSuccess;
 }
 
 // Function to calculate byte size based on PTX data type
@@ -481,27 +677,27 @@ void parse_ptx_string(void *fatCubin, const char *ptx_string,
   }
 }
 
-extern "C" void **__cudaRegisterFatBinary(void *fatCubin) {
-  void **p;
-  int return_value;
-
-  if (rpc_start_request(0, RPC___cudaRegisterFatBinary) < 0)
-    return nullptr;
-
-  if (*(unsigned *)fatCubin == __cudaFatMAGIC2) {
-    __cudaFatCudaBinary2 *binary = (__cudaFatCudaBinary2 *)fatCubin;
+// every server registers the binary and hands back its own handle. the
+// application gets the first server's, which maps to all of them.
+static std::unordered_map<void **, std::vector<void **>> fat_binary_handles;
 
-    if (rpc_write(0, binary, sizeof(__cudaFatCudaBinary2)) < 0)
-      return nullptr;
-
-    __cudaFatCudaBinary2Header *header =
-        (__cudaFatCudaBinary2Header *)binary->text;
+static void **fat_binary_handle(void **fatCubinHandle, const int index) {
+  auto it = fat_binary_handles.find(fatCubinHandle);
+  if (it == fat_binary_handles.end() || index >= (int)it->second.size())
+    return fatCubinHandle;
+  return it->second[index];
+}
 
-    unsigned long long size = sizeof(__cudaFatCudaBinary2Header) + header->size;
+extern "C" void **__cudaRegisterFatBinary(void *fatCubin) {
+  std::vector<void **> handles;
+  __cudaFatCudaBinary2 *binary = (__cudaFatCudaBinary2 *)fatCubin;
+  __cudaFatCudaBinary2Header *header = nullptr;
+  unsigned long long size = 0;
+  bool fat = *(unsigned *)fatCubin == __cudaFatMAGIC2;
 
-    if (rpc_write(0, &size, sizeof(unsigned long long)) < 0 ||
-        rpc_write(0, header, size) < 0)
-      return nullptr;
+  if (fat) {
+    header = (__cudaFatCudaBinary2Header *)binary->text;
+    size = sizeof(__cudaFatCudaBinary2Header) + header->size;
 
     // also parse the ptx file from the fatbin to store the parameter sizes for
     // the assorted functions
@@ -552,21 +748,33 @@ extern "C" void **__cudaRegisterFatBinary(void *fatCubin) {
     }
   }
 
-  if (rpc_wait_for_response(0) < 0 || rpc_read(0, &p, sizeof(void **)) < 0 ||
-      rpc_end_response(0, &return_value) < 0)
-    return nullptr;
+  for (int i = 0; i < rpc_size(); i++) {
+    void **p;
+    int return_value;
+    if (rpc_start_request(i, RPC___cudaRegisterFatBinary) < 0 ||
+        (fat && (rpc_write(i, binary, sizeof(__cudaFatCudaBinary2)) < 0 ||
+                 rpc_write(i, &size, sizeof(unsigned long long)) < 0 ||
+                 rpc_write_compressed(i, header, size) < 0)) ||
+        rpc_wait_for_response(i) < 0 || rpc_read(i, &p, sizeof(void **)) < 0 ||
+        rpc_end_response(i, &return_value) < 0)
+      return nullptr;
+    handles.push_back(p);
+  }
 
-  return p;
+  if (handles.empty())
+    return nullptr;
+  fat_binary_handles[handles[0]] = handles;
+  return handles[0];
 }
 
 extern "C" void __cudaRegisterFatBinaryEnd(void **fatCubinHandle) {
-  void *return_value;
-
-  int request_id = rpc_start_request(0, RPC___cudaRegisterFatBinaryEnd);
-  if (request_id < 0 ||
-      rpc_write(0, &fatCubinHandle, sizeof(const void *)) < 0 ||
-      rpc_end_request(0) < 0)
-    return;
+  for (int i = 0; i < rpc_size(); i++) {
+    void **handle = fat_binary_handle(fatCubinHandle, i);
+    if (rpc_start_request(i, RPC___cudaRegisterFatBinaryEnd) < 0 ||
+        rpc_write(i, &handle, sizeof(const void *)) < 0 ||
+        rpc_end_request(i) < 0)
+      return;
+  }
 }
 
 extern "C" void __cudaInitModule(void **fatCubinHandle) {
@@ -577,36 +785,40 @@ extern "C" void __cudaUnregisterFatBinary(void **fatCubinHandle) {
   //   std::cout << "__cudaUnregisterFatBinary writing data..." << std::endl;
 }
 
+struct CallConfiguration {
+  dim3 gridDim;
+  dim3 blockDim;
+  size_t sharedMem;
+  cudaStream_t stream;
+};
+
+// the host stub that nvcc generates for a <<<>>> launch pops the configuration
+// right before calling cudaLaunchKernel, which carries the full configuration
+// to the server anyway. keeping the stack local saves two round trips per
+// launch.
+static thread_local std::vector<CallConfiguration> call_configurations;
+
 extern "C" cudaError_t __cudaPushCallConfiguration(dim3 gridDim, dim3 blockDim,
                                                    size_t sharedMem,
                                                    cudaStream_t stream) {
-  cudaError_t res;
-
-  if (rpc_start_request(0, RPC___cudaPushCallConfiguration) < 0 ||
-      rpc_write(0, &gridDim, sizeof(dim3)) < 0 ||
-      rpc_write(0, &blockDim, sizeof(dim3)) < 0 ||
-      rpc_write(0, &sharedMem, sizeof(size_t)) < 0 ||
-      rpc_write(0, &stream, sizeof(cudaStream_t)) < 0 ||
-      rpc_wait_for_response(0) < 0 || rpc_end_response(0, &res) < 0)
-    return cudaErrorDevicesUnavailable;
-
-  return res;
+  call_configurations.push_back({gridDim, blockDim, sharedMem, stream});
+  return cudaSuccess;
 }
 
 extern "C" cudaError_t __cudaPopCallConfiguration(dim3 *gridDim, dim3 *blockDim,
                                                   size_t *sharedMem,
                                                   cudaStream_t *stream) {
-  cudaError_t res;
-
-  if (rpc_start_request(0, RPC___cudaPopCallConfiguration) < 0 ||
-      rpc_wait_for_response(0) < 0 || rpc_read(0, gridDim, sizeof(dim3)) < 0 ||
-      rpc_read(0, blockDim, sizeof(dim3)) < 0 ||
-      rpc_read(0, sharedMem, sizeof(size_t)) < 0 ||
-      rpc_read(0, stream, sizeof(cudaStream_t)) < 0 ||
-      rpc_end_response(0, &res) < 0)
-    return cudaErrorDevicesUnavailable;
+  if (call_configurations.empty())
+    return cudaErrorMissingConfiguration;
+
+  const CallConfiguration &config = call_configurations.back();
+  *gridDim = config.gridDim;
+  *blockDim = config.blockDim;
+  *sharedMem = config.sharedMem;
+  *stream = config.stream;
+  call_configurations.pop_back();
 
-  return res;
+  return cudaSuccess;
 }
 
 extern "C" void __cudaRegisterFunction(void **fatCubinHandle,
@@ -631,22 +843,25 @@ extern "C" void __cudaRegisterFunction(void **fatCubinHandle,
   if (wSize != nullptr)
     mask |= 1 << 4;
 
-  if (rpc_start_request(0, RPC___cudaRegisterFunction) < 0 ||
-      rpc_write(0, &fatCubinHandle, sizeof(void **)) < 0 ||
-      rpc_write(0, &hostFun, sizeof(const char *)) < 0 ||
-      rpc_write(0, &deviceFunLen, sizeof(size_t)) < 0 ||
-      rpc_write(0, deviceFun, deviceFunLen) < 0 ||
-      rpc_write(0, &deviceNameLen, sizeof(size_t)) < 0 ||
-      rpc_write(0, deviceName, deviceNameLen) < 0 ||
-      rpc_write(0, &thread_limit, sizeof(int)) < 0 ||
-      rpc_write(0, &mask, sizeof(uint8_t)) < 0 ||
-      (tid != nullptr && rpc_write(0, tid, sizeof(uint3)) < 0) ||
-      (bid != nullptr && rpc_write(0, bid, sizeof(uint3)) < 0) ||
-      (bDim != nullptr && rpc_write(0, bDim, sizeof(dim3)) < 0) ||
-      (gDim != nullptr && rpc_write(0, gDim, sizeof(dim3)) < 0) ||
-      (wSize != nullptr && rpc_write(0, wSize, sizeof(int)) < 0) ||
-      rpc_end_request(0) < 0)
-    return;
+  for (int i = 0; i < rpc_size(); i++) {
+    void **handle = fat_binary_handle(fatCubinHandle, i);
+    if (rpc_start_request(i, RPC___cudaRegisterFunction) < 0 ||
+        rpc_write(i, &handle, sizeof(void **)) < 0 ||
+        rpc_write(i, &hostFun, sizeof(const char *)) < 0 ||
+        rpc_write(i, &deviceFunLen, sizeof(size_t)) < 0 ||
+        rpc_write(i, deviceFun, deviceFunLen) < 0 ||
+        rpc_write(i, &deviceNameLen, sizeof(size_t)) < 0 ||
+        rpc_write(i, deviceName, deviceNameLen) < 0 ||
+        rpc_write(i, &thread_limit, sizeof(int)) < 0 ||
+        rpc_write(i, &mask, sizeof(uint8_t)) < 0 ||
+        (tid != nullptr && rpc_write(i, tid, sizeof(uint3)) < 0) ||
+        (bid != nullptr && rpc_write(i, bid, sizeof(uint3)) < 0) ||
+        (bDim != nullptr && rpc_write(i, bDim, sizeof(dim3)) < 0) ||
+        (gDim != nullptr && rpc_write(i, gDim, sizeof(dim3)) < 0) ||
+        (wSize != nullptr && rpc_write(i, wSize, sizeof(int)) < 0) ||
+        rpc_end_request(i) < 0)
+      return;
+  }
 
   // also memorize the host pointer function
   for (auto &function : functions)
@@ -662,107 +877,403 @@ extern "C" void __cudaRegisterVar(void **fatCubinHandle, char *hostVar,
 
   std::cout << "calling __cudaRegisterVar" << std::endl;
 
-  // Start the RPC request
-  int request_id = rpc_start_request(0, RPC___cudaRegisterVar);
-  if (request_id < 0) {
-    std::cerr << "Failed to start RPC request" << std::endl;
-    return;
-  }
+  for (int i = 0; i < rpc_size(); i++) {
+    // Start the RPC request
+    void **handle = fat_binary_handle(fatCubinHandle, i);
+    int request_id = rpc_start_request(i, RPC___cudaRegisterVar);
+    if (request_id < 0) {
+      std::cerr << "Failed to start RPC request" << std::endl;
+      return;
+    }
 
-  // Write fatCubinHandle
-  if (rpc_write(0, &fatCubinHandle, sizeof(void *)) < 0) {
-    std::cerr << "Failed writing fatCubinHandle" << std::endl;
-    return;
-  }
+    // Write fatCubinHandle
+    if (rpc_write(i, &handle, sizeof(void *)) < 0) {
+      std::cerr << "Failed writing fatCubinHandle" << std::endl;
+      return;
+    }
 
-  // Send hostVar length and data
-  size_t hostVarLen = strlen(hostVar) + 1;
-  if (rpc_write(0, &hostVarLen, sizeof(size_t)) < 0) {
-    std::cerr << "Failed to send hostVar length" << std::endl;
-    return;
-  }
-  if (rpc_write(0, hostVar, hostVarLen) < 0) {
-    std::cerr << "Failed writing hostVar" << std::endl;
-    return;
-  }
+    // Send hostVar length and data
+    size_t hostVarLen = strlen(hostVar) + 1;
+    if (rpc_write(i, &hostVarLen, sizeof(size_t)) < 0) {
+      std::cerr << "Failed to send hostVar length" << std::endl;
+      return;
+    }
+    if (rpc_write(i, hostVar, hostVarLen) < 0) {
+      std::cerr << "Failed writing hostVar" << std::endl;
+      return;
+    }
 
-  // Send deviceAddress length and data
-  size_t deviceAddressLen = strlen(deviceAddress) + 1;
-  if (rpc_write(0, &deviceAddressLen, sizeof(size_t)) < 0) {
-    std::cerr << "Failed to send deviceAddress length" << std::endl;
-    return;
-  }
-  if (rpc_write(0, deviceAddress, deviceAddressLen) < 0) {
-    std::cerr << "Failed writing deviceAddress" << std::endl;
-    return;
-  }
+    // Send deviceAddress length and data
+    size_t deviceAddressLen = strlen(deviceAddress) + 1;
+    if (rpc_write(i, &deviceAddressLen, sizeof(size_t)) < 0) {
+      std::cerr << "Failed to send deviceAddress length" << std::endl;
+      return;
+    }
+    if (rpc_write(i, deviceAddress, deviceAddressLen) < 0) {
+      std::cerr << "Failed writing deviceAddress" << std::endl;
+      return;
+    }
 
-  // Send deviceName length and data
-  size_t deviceNameLen = strlen(deviceName) + 1;
-  if (rpc_write(0, &deviceNameLen, sizeof(size_t)) < 0) {
-    std::cerr << "Failed to send deviceName length" << std::endl;
-    return;
-  }
-  if (rpc_write(0, deviceName, deviceNameLen) < 0) {
-    std::cerr << "Failed writing deviceName" << std::endl;
-    return;
-  }
+    // Send deviceName length and data
+    size_t deviceNameLen = strlen(deviceName) + 1;
+    if (rpc_write(i, &deviceNameLen, sizeof(size_t)) < 0) {
+      std::cerr << "Failed to send deviceName length" << std::endl;
+      return;
+    }
+    if (rpc_write(i, deviceName, deviceNameLen) < 0) {
+      std::cerr << "Failed writing deviceName" << std::endl;
+      return;
+    }
 
-  // Write the rest of the arguments
-  if (rpc_write(0, &ext, sizeof(int)) < 0) {
-    std::cerr << "Failed writing ext" << std::endl;
-    return;
-  }
+    // Write the rest of the arguments
+    if (rpc_write(i, &ext, sizeof(int)) < 0) {
+      std::cerr << "Failed writing ext" << std::endl;
+      return;
+    }
 
-  if (rpc_write(0, &size, sizeof(size_t)) < 0) {
-    std::cerr << "Failed writing size" << std::endl;
-    return;
-  }
+    if (rpc_write(i, &size, sizeof(size_t)) < 0) {
+      std::cerr << "Failed writing size" << std::endl;
+      return;
+    }
 
-  if (rpc_write(0, &constant, sizeof(int)) < 0) {
-    std::cerr << "Failed writing constant" << std::endl;
-    return;
-  }
+    if (rpc_write(i, &constant, sizeof(int)) < 0) {
+      std::cerr << "Failed writing constant" << std::endl;
+      return;
+    }
 
-  if (rpc_write(0, &global, sizeof(int)) < 0) {
-    std::cerr << "Failed writing global" << std::endl;
-    return;
-  }
+    if (rpc_write(i, &global, sizeof(int)) < 0) {
+      std::cerr << "Failed writing global" << std::endl;
+      return;
+    }
 
-  // Wait for a response from the server
-  if (rpc_end_request(0) < 0) {
-    std::cerr << "Failed waiting for response" << std::endl;
-    return;
+    // Wait for a response from the server
+    if (rpc_end_request(i) < 0) {
+      std::cerr << "Failed waiting for response" << std::endl;
+      return;
+    }
   }
 }
 
 cudaError_t cudaFree(void *devPtr) {
   cudaError_t return_value;
-  maybe_free_unified_mem(0, devPtr);
-
-  if (rpc_start_request(0, RPC_cudaFree) < 0 ||
-      rpc_write(0, &devPtr, sizeof(void *)) < 0 ||
-      rpc_wait_for_response(0) < 0 || rpc_end_response(0, &return_value) < 0)
+  const int scuda_conn = rpc_handle_conn(devPtr);
+  if (scuda_conn < 0) {
+    rpc_record_error(cudaErrorInvalidValue);
+    return cudaErrorInvalidValue;
+  }
+  // a managed allocation's mirror starts a little way into its device
+  // memory.
+  devPtr = maybe_free_unified_mem(scuda_conn, devPtr);
+
+  // blocks of the client's slabs stay on the client. unlike cudaFree, this
+  // doesn't wait for work queued on the device.
+  if (rpc_cached_free(scuda_conn, devPtr))
+    return cudaSuccess;
+
+  if (rpc_start_request(scuda_conn, RPC_cudaFree) < 0 ||
+      rpc_write(scuda_conn, &devPtr, sizeof(void *)) < 0 ||
+      rpc_wait_for_response(scuda_conn) < 0 ||
+      rpc_end_response(scuda_conn, &return_value) < 0)
     return cudaErrorDevicesUnavailable;
 
+  if (return_value == cudaSuccess)
+    rpc_unregister_handle(scuda_conn, devPtr);
+
+  rpc_record_error(return_value);
   return return_value;
 }
 
 cudaError_t cudaMallocManaged(void **devPtr, size_t size, unsigned int flags) {
   void *d_mem;
 
-  cudaError_t err = cudaMalloc((void **)&d_mem, size);
+  cudaError_t err = cudaMalloc((void **)&d_mem, unified_allocation_size(size));
   if (err != cudaSuccess) {
     std::cerr << "cudaMalloc failed: " << cudaGetErrorString(err) << std::endl;
     return err;
   }
 
-  std::cout << "allocated unified device mem " << d_mem << " size: " << size
+  void *ptr = allocate_unified_mem_pointer(rpc_current_conn(), d_mem, size);
+  if (ptr == nullptr) {
+    std::cerr << "mapping unified memory at " << d_mem << " failed"
+              << std::endl;
+    cudaFree(d_mem);
+    return cudaErrorMemoryAllocation;
+  }
+
+  std::cout << "allocated unified device mem " << ptr << " size: " << size
             << std::endl;
 
-  allocate_unified_mem_pointer(0, d_mem, size);
+  *devPtr = ptr;
+
+  return cudaSuccess;
+}
+
+cudaError_t cudaMalloc(void **devPtr, size_t size) {
+  cudaError_t return_value = rpc_cached_malloc(devPtr, size);
+  rpc_record_error(return_value);
+  return return_value;
+}
+
+// the devices of all servers are numbered one after the other, in
+// SCUDA_SERVER order; see rpc_device_conn for how calls naming one are routed.
+cudaError_t cudaGetDeviceCount(int *count) {
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return cudaErrorDevicesUnavailable;
+
+  *count = devices;
+  return devices > 0 ? cudaSuccess : cudaErrorNoDevice;
+}
+
+cudaError_t cudaGetDevice(int *device) {
+  *device = rpc_get_device();
+  return cudaSuccess;
+}
+
+// the server switches too, for calls like cudaMalloc that don't name a
+// device, but only once this thread sends it the next request.
+cudaError_t cudaSetDevice(int device) {
+  if (device < 0 || device >= rpc_device_count()) {
+    rpc_record_error(cudaErrorInvalidDevice);
+    return cudaErrorInvalidDevice;
+  }
+
+  rpc_set_device(device);
+  return cudaSuccess;
+}
+
+cudaError_t cudaGetLastError() { return rpc_last_error(true); }
 
-  *devPtr = d_mem;
+cudaError_t cudaPeekAtLastError() { return rpc_last_error(false); }
 
+cudaError_t
+cudaThreadExchangeStreamCaptureMode(enum cudaStreamCaptureMode *mode) {
+  *mode = (enum cudaStreamCaptureMode)rpc_exchange_capture_mode(*mode);
   return cudaSuccess;
 }
+
+CUresult cuThreadExchangeStreamCaptureMode(CUstreamCaptureMode *mode) {
+  *mode = (CUstreamCaptureMode)rpc_exchange_capture_mode(*mode);
+  return CUDA_SUCCESS;
+}
+
+// no stream can be capturing while no capture was started, which is nearly
+// always. otherwise the server knows, including whether a capture was
+// invalidated or a legacy stream call would be implicitly captured.
+cudaError_t
+cudaStreamIsCapturing(cudaStream_t stream,
+                      enum cudaStreamCaptureStatus *pCaptureStatus) {
+  cudaError_t return_value;
+
+  if (!rpc_capturing()) {
+    *pCaptureStatus = cudaStreamCaptureStatusNone;
+    return cudaSuccess;
+  }
+
+  const int scuda_conn = rpc_handle_conn((const void *)stream);
+  if (scuda_conn < 0) {
+    rpc_record_error(cudaErrorInvalidValue);
+    return cudaErrorInvalidValue;
+  }
+  if (rpc_start_request(scuda_conn, RPC_cudaStreamIsCapturing) < 0 ||
+      rpc_write(scuda_conn, &stream, sizeof(cudaStream_t)) < 0 ||
+      rpc_write(scuda_conn, pCaptureStatus,
+                sizeof(enum cudaStreamCaptureStatus)) < 0 ||
+      rpc_wait_for_response(scuda_conn) < 0 ||
+      rpc_read(scuda_conn, pCaptureStatus,
+               sizeof(enum cudaStreamCaptureStatus)) < 0 ||
+      rpc_end_response(scuda_conn, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+
+  rpc_record_error(return_value);
+  return return_value;
+}
+
+CUresult cuStreamIsCapturing(CUstream hStream,
+                             CUstreamCaptureStatus *captureStatus) {
+  CUresult return_value;
+
+  if (!rpc_capturing()) {
+    *captureStatus = CU_STREAM_CAPTURE_STATUS_NONE;
+    return CUDA_SUCCESS;
+  }
+
+  const int scuda_conn = rpc_handle_conn((const void *)hStream);
+  if (scuda_conn < 0)
+    return CUDA_ERROR_INVALID_VALUE;
+  if (rpc_start_request(scuda_conn, RPC_cuStreamIsCapturing) < 0 ||
+      rpc_write(scuda_conn, &hStream, sizeof(CUstream)) < 0 ||
+      rpc_write(scuda_conn, captureStatus, sizeof(CUstreamCaptureStatus)) < 0 ||
+      rpc_wait_for_response(scuda_conn) < 0 ||
+      rpc_read(scuda_conn, captureStatus, sizeof(CUstreamCaptureStatus)) < 0 ||
+      rpc_end_response(scuda_conn, &return_value) < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+
+  return return_value;
+}
+
+CUresult cuDeviceGetCount(int *count) {
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+
+  *count = devices;
+  return CUDA_SUCCESS;
+}
+
+// a CUdevice is its ordinal, which the calls taking one translate like any
+// other.
+CUresult cuDeviceGet(CUdevice *device, int ordinal) {
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+  if (ordinal < 0 || ordinal >= devices)
+    return CUDA_ERROR_INVALID_DEVICE;
+
+  *device = ordinal;
+  return CUDA_SUCCESS;
+}
+
+// versions, properties and attributes don't change while the application
+// runs, so they come from the snapshot each server sends once rather than a
+// request each.
+cudaError_t cudaGetDeviceProperties_v2(struct cudaDeviceProp *prop,
+                                       int device) {
+  cudaError_t return_value;
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return cudaErrorDevicesUnavailable;
+  if (device < 0 || device >= devices)
+    return cudaErrorInvalidDevice;
+
+  if (rpc_device_properties(device, prop, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+  rpc_record_error(return_value);
+  return return_value;
+}
+
+cudaError_t cudaDeviceGetAttribute(int *value, enum cudaDeviceAttr attr,
+                                   int device) {
+  cudaError_t return_value;
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return cudaErrorDevicesUnavailable;
+  if (device < 0 || device >= devices)
+    return cudaErrorInvalidDevice;
+  if ((int)attr < 0 || (int)attr >= SNAPSHOT_ATTRIBUTES)
+    return cudaErrorInvalidValue;
+
+  if (rpc_device_attribute(device, attr, value, &return_value) < 0)
+    return cudaErrorDevicesUnavailable;
+  rpc_record_error(return_value);
+  return return_value;
+}
+
+CUresult cuDeviceGetAttribute(int *pi, CUdevice_attribute attrib,
+                              CUdevice dev) {
+  CUresult return_value;
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+  if (dev < 0 || dev >= devices)
+    return CUDA_ERROR_INVALID_DEVICE;
+  if ((int)attrib < 0 || (int)attrib >= SNAPSHOT_ATTRIBUTES)
+    return CUDA_ERROR_INVALID_VALUE;
+
+  if (rpc_cu_device_attribute(dev, attrib, pi, &return_value) < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+  return return_value;
+}
+
+cudaError_t cudaDriverGetVersion(int *driverVersion) {
+  snapshot_t snapshot;
+  if (rpc_server_snapshot(&snapshot) < 0)
+    return cudaErrorDevicesUnavailable;
+  if (snapshot.driver_result == cudaSuccess)
+    *driverVersion = snapshot.driver_version;
+  return snapshot.driver_result;
+}
+
+cudaError_t cudaRuntimeGetVersion(int *runtimeVersion) {
+  snapshot_t snapshot;
+  if (rpc_server_snapshot(&snapshot) < 0)
+    return cudaErrorDevicesUnavailable;
+  if (snapshot.runtime_result == cudaSuccess)
+    *runtimeVersion = snapshot.runtime_version;
+  return snapshot.runtime_result;
+}
+
+CUresult cuDriverGetVersion(int *driverVersion) {
+  snapshot_t snapshot;
+  if (rpc_server_snapshot(&snapshot) < 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+  if (snapshot.cu_driver_result == CUDA_SUCCESS)
+    *driverVersion = snapshot.cu_driver_version;
+  return snapshot.cu_driver_result;
+}
+
+nvmlReturn_t nvmlDeviceGetCount_v2(unsigned int *deviceCount) {
+  int devices = rpc_device_count();
+  if (devices < 0)
+    return NVML_ERROR_GPU_IS_LOST;
+
+  *deviceCount = devices;
+  return NVML_SUCCESS;
+}
+
+// the library initializers run on every server. the first error wins.
+CUresult cuInit(unsigned int Flags) {
+  CUresult return_value = CUDA_SUCCESS;
+  int servers = rpc_size();
+  if (servers == 0)
+    return CUDA_ERROR_DEVICE_UNAVAILABLE;
+
+  for (int i = 0; i < servers; i++) {
+    CUresult result;
+    if (rpc_start_request(i, RPC_cuInit) < 0 ||
+        rpc_write(i, &Flags, sizeof(unsigned int)) < 0 ||
+        rpc_wait_for_response(i) < 0 || rpc_end_response(i, &result) < 0)
+      return CUDA_ERROR_DEVICE_UNAVAILABLE;
+    if (return_value == CUDA_SUCCESS)
+      return_value = result;
+  }
+
+  return return_value;
+}
+
+nvmlReturn_t nvmlInit_v2() {
+  nvmlReturn_t return_value = NVML_SUCCESS;
+  int servers = rpc_size();
+  if (servers == 0)
+    return NVML_ERROR_GPU_IS_LOST;
+
+  for (int i = 0; i < servers; i++) {
+    nvmlReturn_t result;
+    if (rpc_start_request(i, RPC_nvmlInit_v2) < 0 ||
+        rpc_wait_for_response(i) < 0 || rpc_end_response(i, &result) < 0)
+      return NVML_ERROR_GPU_IS_LOST;
+    if (return_value == NVML_SUCCESS)
+      return_value = result;
+  }
+
+  return return_value;
+}
+
+nvmlReturn_t nvmlInitWithFlags(unsigned int flags) {
+  nvmlReturn_t return_value = NVML_SUCCESS;
+  int servers = rpc_size();
+  if (servers == 0)
+    return NVML_ERROR_GPU_IS_LOST;
+
+  for (int i = 0; i < servers; i++) {
+    nvmlReturn_t result;
+    if (rpc_start_request(i, RPC_nvmlInitWithFlags) < 0 ||
+        rpc_write(i, &flags, sizeof(unsigned int)) < 0 ||
+        rpc_wait_for_response(i) < 0 || rpc_end_response(i, &result) < 0)
+      return NVML_ERROR_GPU_IS_LOST;
+    if (return_value == NVML_SUCCESS)
+      return_value = result;
+  }
+
+  return return_value;
+}
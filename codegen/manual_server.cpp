@@ -6,14 +6,22 @@
 #include <iostream>
 #include <nvml.h>
 
+#include <atomic>
 #include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <pthread.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "dedup.h"
 #include "gen_api.h"
 
 #include "gen_server.h"
 #include "ptx_fatbin.hpp"
+#include "snapshot.h"
 
 extern int rpc_read(const void *conn, void *data, const std::size_t size);
 extern int rpc_end_request(const void *conn);
@@ -21,17 +29,578 @@ extern int rpc_start_response(const void *conn, const int request_id);
 extern int rpc_write(const void *conn, const void *data,
                      const std::size_t size);
 extern int rpc_end_response(const void *conn, void *return_value);
+extern int rpc_defer_error(const void *conn, const int error);
+extern int rpc_merge_deferred_error(const void *conn, const int request_id,
+                                    void *return_value);
+extern void *rpc_arena_alloc(const void *conn, const std::size_t size);
+extern int rpc_peek(const void *conn, void **data, const std::size_t size);
+extern int rpc_consume(const void *conn, const std::size_t size);
+extern int rpc_compressed(const void *conn, const std::size_t size);
+extern int rpc_read_compressed(const void *conn, void *data,
+                               const std::size_t size);
+extern int rpc_write_compressed(const void *conn, const void *data,
+                                const std::size_t size);
+extern int rpc_start_payload_read(const void *conn, const std::size_t size);
+extern int rpc_read_payload(const void *conn, void *data,
+                            const std::size_t size);
+extern int rpc_start_payload_write(const void *conn, const std::size_t size);
+extern int rpc_write_payload(const void *conn, const void *data,
+                             const std::size_t size);
+extern uint32_t rpc_zerocopy_ticket(const void *conn);
+extern int rpc_zerocopy_release(const void *conn, const uint32_t ticket);
+extern int rpc_read_stripes(const void *conn, void *data,
+                            const std::size_t size, const int stripes);
+extern int rpc_write_stripes(const void *conn, const void *data,
+                             const std::size_t size, const int stripes);
+extern int rpc_run_on_stream(const void *conn, const void *stream,
+                             std::function<int()> job);
+extern int rpc_server_device(const void *conn, const int device);
+extern int rpc_client_device_count(const void *conn, const int count);
+extern const void *rpc_real_handle(const void *conn, const void *handle);
+extern const void *rpc_virtual_handle(const void *conn, const void *real);
 
 FILE *__cudart_trace_output_stream = stdout;
 
+// a host buffer that copies are staged through. pinned unless the pool was out
+// of room, in which case it is pageable and freed as soon as it's released.
+struct staging_buffer_t {
+  void *data;
+  std::size_t size;
+  bool pinned;
+  cudaEvent_t event;
+  // the connection it was last sent on, if any, and the ticket taken then; the
+  // kernel may still be sending it with MSG_ZEROCOPY. see staging_unsend.
+  const void *conn;
+  uint32_t ticket;
+};
+
+// copies on the primary connection move through a ring of pinned buffers, so
+// receiving or sending one chunk overlaps the device copying another and host
+// memory stays bounded whatever the size of the copy. a chunk is a whole
+// number of compression chunks, as rpc_write_payload requires.
+#define STAGING_CHUNK (4 * 1024 * 1024)
+#define STAGING_BUFFERS 2
+
+// other copies take a buffer from a pool of page-locked buffers in
+// power-of-two size classes, starting at this size, and give it back when the
+// copy is done.
+#define STAGING_MIN_SIZE (64 * 1024)
+
+// each thread that serves clients has its own pool. a client with a thread of
+// its own frees it with staging_shutdown once it is gone; a worker's pool is
+// shared by its clients and kept. all pools together pin at most
+// SCUDA_PINNED_POOL bytes (default 1 GiB).
+struct staging_pool_t {
+  std::unordered_map<std::size_t, std::vector<staging_buffer_t *>> idle;
+  // released behind a stream; reusable once their event completes.
+  std::vector<staging_buffer_t *> in_flight;
+  staging_buffer_t *ring[STAGING_BUFFERS] = {};
+  // given back by the client's executors; see staging_return.
+  pthread_mutex_t returned_mutex = PTHREAD_MUTEX_INITIALIZER;
+  std::vector<staging_buffer_t *> returned;
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+};
+
+static thread_local staging_pool_t staging;
+std::atomic<std::size_t> pinned_bytes(0);
+std::atomic<std::size_t> pinned_peak(0);
+
+static std::size_t pinned_capacity() {
+  static std::size_t capacity = []() -> std::size_t {
+    char *p = getenv("SCUDA_PINNED_POOL");
+    return p != NULL ? strtoul(p, NULL, 10) : 1024 * 1024 * 1024;
+  }();
+  return capacity;
+}
+
+// note that buffer went out in a response on conn.
+static void staging_sent(const void *conn, staging_buffer_t *buffer) {
+  buffer->conn = conn;
+  buffer->ticket = rpc_zerocopy_ticket(conn);
+}
+
+// wait until the kernel is done sending buffer, before it is filled again or
+// freed. usually it was done long ago, so this just reaps the notification.
+static void staging_unsend(staging_buffer_t *buffer) {
+  if (buffer->conn != NULL)
+    rpc_zerocopy_release(buffer->conn, buffer->ticket);
+  buffer->conn = NULL;
+}
+
+// forget that buffers in this thread's pool were sent on conn, which is going
+// away. whatever the kernel still sends from them only goes to that client.
+void staging_forget(const void *conn) {
+  auto forget = [conn](staging_buffer_t *buffer) {
+    if (buffer != NULL && buffer->conn == conn)
+      buffer->conn = NULL;
+  };
+  pthread_mutex_lock(&staging.returned_mutex);
+  for (staging_buffer_t *buffer : staging.returned)
+    forget(buffer);
+  pthread_mutex_unlock(&staging.returned_mutex);
+  for (staging_buffer_t *buffer : staging.in_flight)
+    forget(buffer);
+  for (auto &size_class : staging.idle)
+    for (staging_buffer_t *buffer : size_class.second)
+      forget(buffer);
+  for (int i = 0; i < STAGING_BUFFERS; i++)
+    forget(staging.ring[i]);
+}
+
+static void staging_destroy(staging_buffer_t *buffer) {
+  staging_unsend(buffer);
+  if (buffer->event != NULL)
+    cudaEventDestroy(buffer->event);
+  if (buffer->pinned) {
+    cudaFreeHost(buffer->data);
+    pinned_bytes -= buffer->size;
+  } else {
+    free(buffer->data);
+  }
+  delete buffer;
+}
+
+// free this thread's pool. called by the handler thread after its client's
+// executors have stopped, while the runtime is still up, rather than from a
+// thread_local destructor that could run after it is unloaded.
+void staging_shutdown() {
+  for (staging_buffer_t *buffer : staging.returned)
+    staging_destroy(buffer);
+  for (staging_buffer_t *buffer : staging.in_flight) {
+    cudaEventSynchronize(buffer->event);
+    staging_destroy(buffer);
+  }
+  for (auto &size_class : staging.idle)
+    for (staging_buffer_t *buffer : size_class.second)
+      staging_destroy(buffer);
+  for (int i = 0; i < STAGING_BUFFERS; i++)
+    if (staging.ring[i] != NULL)
+      staging_destroy(staging.ring[i]);
+
+#ifdef VERBOSE
+  if (staging.hits + staging.misses > 0)
+    printf("staging pool: %zu hits, %zu misses (%.1f%% hit rate), peak "
+           "%zu MiB pinned\n",
+           staging.hits, staging.misses,
+           100.0 * staging.hits / (staging.hits + staging.misses),
+           pinned_peak.load() / (1024 * 1024));
+#endif
+
+  staging.returned.clear();
+  staging.in_flight.clear();
+  staging.idle.clear();
+  for (int i = 0; i < STAGING_BUFFERS; i++)
+    staging.ring[i] = NULL;
+  staging.hits = 0;
+  staging.misses = 0;
+}
+
+static void staging_release(staging_buffer_t *buffer) {
+  if (buffer == NULL)
+    return;
+  if (!buffer->pinned)
+    staging_destroy(buffer);
+  else
+    staging.idle[buffer->size].push_back(buffer);
+}
+
+// give a buffer back to the pool of the handler thread that acquired it, from
+// one of that client's executors. it becomes reusable on that thread's next
+// staging_acquire.
+static void staging_return(staging_pool_t *pool, staging_buffer_t *buffer) {
+  pthread_mutex_lock(&pool->returned_mutex);
+  pool->returned.push_back(buffer);
+  pthread_mutex_unlock(&pool->returned_mutex);
+}
+
+// give back a buffer that copies queued on stream are still using.
+static void staging_release_after(staging_buffer_t *buffer,
+                                  cudaStream_t stream) {
+  if ((buffer->event == NULL &&
+       cudaEventCreateWithFlags(&buffer->event, cudaEventDisableTiming) !=
+           cudaSuccess) ||
+      cudaEventRecord(buffer->event, stream) != cudaSuccess) {
+    cudaStreamSynchronize(stream);
+    staging_release(buffer);
+    return;
+  }
+  staging.in_flight.push_back(buffer);
+}
+
+static staging_buffer_t *staging_acquire(std::size_t size) {
+  std::size_t size_class = STAGING_MIN_SIZE;
+  while (size_class < size)
+    size_class *= 2;
+
+  pthread_mutex_lock(&staging.returned_mutex);
+  for (staging_buffer_t *buffer : staging.returned)
+    staging_release(buffer);
+  staging.returned.clear();
+  pthread_mutex_unlock(&staging.returned_mutex);
+
+  for (auto it = staging.in_flight.begin(); it != staging.in_flight.end();) {
+    if (cudaEventQuery((*it)->event) == cudaErrorNotReady) {
+      ++it;
+      continue;
+    }
+    staging_release(*it);
+    it = staging.in_flight.erase(it);
+  }
+
+  std::vector<staging_buffer_t *> &idle = staging.idle[size_class];
+  if (!idle.empty()) {
+    staging.hits++;
+    staging_buffer_t *buffer = idle.back();
+    idle.pop_back();
+    staging_unsend(buffer);
+    return buffer;
+  }
+  staging.misses++;
+
+  // make room under the cap by dropping idle buffers of other sizes.
+  if (pinned_bytes + size_class > pinned_capacity()) {
+    for (auto &other : staging.idle) {
+      for (staging_buffer_t *buffer : other.second)
+        staging_destroy(buffer);
+      other.second.clear();
+    }
+  }
+
+  staging_buffer_t *buffer = new staging_buffer_t{NULL, size_class, false,
+                                                  NULL};
+  if (pinned_bytes.fetch_add(size_class) + size_class <= pinned_capacity() &&
+      cudaHostAlloc(&buffer->data, size_class, cudaHostAllocDefault) ==
+          cudaSuccess) {
+    buffer->pinned = true;
+    std::size_t now = pinned_bytes, peak = pinned_peak;
+    while (now > peak && !pinned_peak.compare_exchange_weak(peak, now))
+      ;
+    return buffer;
+  }
+
+  pinned_bytes -= size_class;
+  buffer->data = malloc(size);
+  if (buffer->data == NULL) {
+    delete buffer;
+    return NULL;
+  }
+  return buffer;
+}
+
+// take this thread's ring from the pool on first use.
+static int staging_init() {
+  for (int i = 0; i < STAGING_BUFFERS; i++) {
+    if (staging.ring[i] == NULL)
+      staging.ring[i] = staging_acquire(STAGING_CHUNK);
+    if (staging.ring[i] == NULL ||
+        (staging.ring[i]->event == NULL &&
+         cudaEventCreateWithFlags(&staging.ring[i]->event,
+                                  cudaEventDisableTiming) != cudaSuccess))
+      return -1;
+  }
+  return 0;
+}
+
+struct dedup_key_t {
+  dedup_hash_t hash;
+  std::size_t size;
+
+  bool operator==(const dedup_key_t &other) const {
+    return hash.lo == other.hash.lo && hash.hi == other.hash.hi &&
+           size == other.size;
+  }
+};
+
+struct dedup_key_hash {
+  std::size_t operator()(const dedup_key_t &key) const { return key.hash.lo; }
+};
+
+struct dedup_entry_t {
+  void *device;
+  std::list<dedup_key_t>::iterator lru;
+};
+
+// an upload whose missing chunks the client is about to send.
+struct dedup_upload_t {
+  void *dst;
+  std::size_t count;
+  std::vector<std::pair<std::size_t, dedup_key_t>> missing;
+};
+
+// chunks of recent uploads to one device, kept in that device's memory and
+// shared by all clients using it. each device's cache holds at most
+// SCUDA_DEDUP_CACHE bytes (default 256 MiB), evicts the least recently used
+// chunk first and has its own lock, so copies to different devices don't wait
+// on each other.
+struct dedup_cache_t {
+  pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+  std::unordered_map<dedup_key_t, dedup_entry_t, dedup_key_hash> chunks;
+  std::list<dedup_key_t> lru;
+  std::size_t bytes = 0;
+};
+
+// dedup_caches_mutex only guards finding a device's cache; std::map keeps the
+// caches in place as others are added.
+pthread_mutex_t dedup_caches_mutex = PTHREAD_MUTEX_INITIALIZER;
+std::map<int, dedup_cache_t> dedup_caches;
+
+// uploads waiting on their missing chunks, by connection.
+pthread_mutex_t dedup_uploads_mutex = PTHREAD_MUTEX_INITIALIZER;
+std::unordered_map<const void *, dedup_upload_t> dedup_uploads;
+
+static std::size_t dedup_cache_capacity() {
+  static std::size_t capacity = []() -> std::size_t {
+    char *p = getenv("SCUDA_DEDUP_CACHE");
+    return p != NULL ? strtoul(p, NULL, 10) : 256 * 1024 * 1024;
+  }();
+  return capacity;
+}
+
+// the cache of the device this thread is on, which is where a deduplicated
+// copy's chunks are cached and read back from.
+static dedup_cache_t *dedup_device_cache() {
+  int device;
+  if (cudaGetDevice(&device) != cudaSuccess)
+    return NULL;
+  pthread_mutex_lock(&dedup_caches_mutex);
+  dedup_cache_t *cache = &dedup_caches[device];
+  pthread_mutex_unlock(&dedup_caches_mutex);
+  return cache;
+}
+
+// copy a cached chunk to dst. returns false if the chunk isn't cached.
+static bool dedup_lookup(dedup_cache_t *cache, const dedup_key_t &key,
+                         void *dst, cudaError_t *result) {
+  pthread_mutex_lock(&cache->mutex);
+  auto found = cache->chunks.find(key);
+  if (found == cache->chunks.end()) {
+    pthread_mutex_unlock(&cache->mutex);
+    return false;
+  }
+  cache->lru.splice(cache->lru.begin(), cache->lru, found->second.lru);
+  cudaError_t err = cudaMemcpy(dst, found->second.device, key.size,
+                               cudaMemcpyDeviceToDevice);
+  if (*result == cudaSuccess)
+    *result = err;
+  pthread_mutex_unlock(&cache->mutex);
+  return true;
+}
+
+// keep a copy of a chunk that was just uploaded to src. if the device is out
+// of memory the chunk just isn't cached.
+static void dedup_insert(dedup_cache_t *cache, const dedup_key_t &key,
+                         const void *src) {
+  if (key.size > dedup_cache_capacity())
+    return;
+
+  pthread_mutex_lock(&cache->mutex);
+  if (cache->chunks.count(key) == 0) {
+    while (cache->bytes + key.size > dedup_cache_capacity()) {
+      auto evicted = cache->chunks.find(cache->lru.back());
+      cudaFree(evicted->second.device);
+      cache->bytes -= evicted->first.size;
+      cache->chunks.erase(evicted);
+      cache->lru.pop_back();
+    }
+
+    void *device;
+    if (cudaMalloc(&device, key.size) == cudaSuccess) {
+      if (cudaMemcpy(device, src, key.size, cudaMemcpyDeviceToDevice) ==
+          cudaSuccess) {
+        cache->lru.push_front(key);
+        cache->chunks[key] = {device, cache->lru.begin()};
+        cache->bytes += key.size;
+      } else {
+        cudaFree(device);
+      }
+    }
+  }
+  pthread_mutex_unlock(&cache->mutex);
+}
+
+// the two halves of a deduplicated host to device cudaMemcpy; see dedup.h.
+static int handle_cudaMemcpy_dedup(void *conn, void *dst, std::size_t count,
+                                   int dedup) {
+  int request_id;
+  cudaError_t result = cudaSuccess;
+  std::size_t chunks = (count + DEDUP_CHUNK - 1) / DEDUP_CHUNK;
+  std::vector<char> missing;
+  dedup_upload_t upload;
+  staging_buffer_t *host_data = NULL;
+  dedup_cache_t *cache = dedup_device_cache();
+
+  if (dedup == DEDUP_QUERY) {
+    std::size_t sent_chunks;
+    std::vector<dedup_hash_t> hashes(chunks);
+    if (rpc_read(conn, &sent_chunks, sizeof(std::size_t)) < 0 ||
+        sent_chunks != chunks ||
+        rpc_read(conn, hashes.data(), chunks * sizeof(dedup_hash_t)) < 0)
+      return -1;
+
+    request_id = rpc_end_request(conn);
+    if (request_id < 0)
+      return -1;
+
+    missing.assign(chunks, 0);
+    upload = {dst, count, {}};
+    for (std::size_t i = 0; i < chunks; i++) {
+      std::size_t offset = i * DEDUP_CHUNK;
+      dedup_key_t key = {hashes[i], std::min(count - offset,
+                                             (std::size_t)DEDUP_CHUNK)};
+      if (cache == NULL || !dedup_lookup(cache, key, (char *)dst + offset,
+                                         &result)) {
+        missing[i] = 1;
+        upload.missing.push_back({offset, key});
+      }
+    }
+
+    // the client only follows up if there's something left to send.
+    if (result == cudaSuccess && !upload.missing.empty()) {
+      pthread_mutex_lock(&dedup_uploads_mutex);
+      dedup_uploads[conn] = upload;
+      pthread_mutex_unlock(&dedup_uploads_mutex);
+    }
+  } else if (dedup == DEDUP_MISSING) {
+    pthread_mutex_lock(&dedup_uploads_mutex);
+    auto found = dedup_uploads.find(conn);
+    bool valid = found != dedup_uploads.end() && found->second.dst == dst &&
+                 found->second.count == count;
+    if (valid) {
+      upload = found->second;
+      dedup_uploads.erase(found);
+    }
+    pthread_mutex_unlock(&dedup_uploads_mutex);
+    if (!valid)
+      return -1;
+
+    host_data = staging_acquire(DEDUP_CHUNK);
+    if (host_data == NULL)
+      return -1;
+
+    // each chunk is copied and cached as soon as it arrives.
+    for (const auto &chunk : upload.missing) {
+      char *chunk_dst = (char *)dst + chunk.first;
+      if (rpc_read(conn, host_data->data, chunk.second.size) < 0) {
+        staging_release(host_data);
+        return -1;
+      }
+      if (result != cudaSuccess)
+        continue;
+      result = cudaMemcpy(chunk_dst, host_data->data, chunk.second.size,
+                          cudaMemcpyHostToDevice);
+      if (result == cudaSuccess && cache != NULL)
+        dedup_insert(cache, chunk.second, chunk_dst);
+    }
+    staging_release(host_data);
+
+    request_id = rpc_end_request(conn);
+    if (request_id < 0)
+      return -1;
+  } else {
+    return -1;
+  }
+
+  // the query's result is only final if nothing was missing.
+  bool done = dedup == DEDUP_MISSING || result != cudaSuccess ||
+               upload.missing.empty();
+  if ((done && rpc_merge_deferred_error(conn, request_id, &result) < 0) ||
+      rpc_start_response(conn, request_id) < 0 ||
+      (dedup == DEDUP_QUERY && rpc_write(conn, missing.data(), chunks) < 0) ||
+      rpc_end_response(conn, &result) < 0)
+    return -1;
+  return 0;
+}
+
+// receive count bytes for dst through the ring: chunk n + 1 is read off the
+// connection while chunk n is copied to the device. the copies go on the
+// legacy default stream so they are ordered like cudaMemcpy's. returns -1 if
+// the connection failed; the result of the copy goes in *result.
+static int staged_upload(void *conn, void *dst, std::size_t count,
+                         cudaError_t *result) {
+  *result = cudaSuccess;
+  if (staging_init() < 0 || rpc_start_payload_read(conn, count) < 0)
+    return -1;
+
+  for (std::size_t offset = 0; offset < count; offset += STAGING_CHUNK) {
+    std::size_t n = std::min(count - offset, (std::size_t)STAGING_CHUNK);
+    int b = offset / STAGING_CHUNK % STAGING_BUFFERS;
+
+    // the device may still be copying out of this buffer, or the kernel
+    // sending it.
+    cudaError_t err = cudaEventSynchronize(staging.ring[b]->event);
+    staging_unsend(staging.ring[b]);
+    if (rpc_read_payload(conn, staging.ring[b]->data, n) < 0)
+      return -1;
+    if (*result == cudaSuccess)
+      *result = err;
+    if (*result == cudaSuccess)
+      *result = cudaMemcpyAsync((char *)dst + offset, staging.ring[b]->data, n,
+                                cudaMemcpyHostToDevice, 0);
+    if (*result == cudaSuccess)
+      *result = cudaEventRecord(staging.ring[b]->event, 0);
+  }
+
+  // like cudaMemcpy, return once the data is on the device.
+  for (int b = 0; b < STAGING_BUFFERS; b++) {
+    cudaError_t err = cudaEventSynchronize(staging.ring[b]->event);
+    if (*result == cudaSuccess)
+      *result = err;
+  }
+  return 0;
+}
+
+// send count bytes from src into the response through the ring: the device
+// fills the next buffer while the last one is sent.
+static int staged_download(void *conn, const void *src, std::size_t count,
+                           cudaError_t *result) {
+  *result = cudaSuccess;
+  if (staging_init() < 0 || rpc_start_payload_write(conn, count) < 0)
+    return -1;
+
+  std::size_t chunks = (count + STAGING_CHUNK - 1) / STAGING_CHUNK;
+  for (std::size_t i = 0; i <= chunks; i++) {
+    if (i < chunks && *result == cudaSuccess) {
+      std::size_t offset = i * STAGING_CHUNK;
+      int b = i % STAGING_BUFFERS;
+      staging_unsend(staging.ring[b]);
+      *result = cudaMemcpyAsync(
+          staging.ring[b]->data, (char *)src + offset,
+          std::min(count - offset, (std::size_t)STAGING_CHUNK),
+          cudaMemcpyDeviceToHost, 0);
+      if (*result == cudaSuccess)
+        *result = cudaEventRecord(staging.ring[b]->event, 0);
+    }
+
+    // the client expects count bytes even if a copy failed.
+    if (i > 0) {
+      std::size_t offset = (i - 1) * STAGING_CHUNK;
+      int b = (i - 1) % STAGING_BUFFERS;
+      cudaError_t err = cudaEventSynchronize(staging.ring[b]->event);
+      if (*result == cudaSuccess)
+        *result = err;
+      if (rpc_write_payload(
+              conn, staging.ring[b]->data,
+              std::min(count - offset, (std::size_t)STAGING_CHUNK)) < 0)
+        return -1;
+      staging_sent(conn, staging.ring[b]);
+    }
+  }
+  return 0;
+}
+
 int handle_cudaMemcpy(void *conn) {
   int request_id;
   cudaError_t result;
   void *src;
   void *dst;
-  void *host_data;
+  staging_buffer_t *host_data = NULL;
+  void *span;
+  int span_size = 0;
   std::size_t count;
   enum cudaMemcpyKind kind;
+  int stripes = 0;
+  int dedup = DEDUP_NONE;
   int ret = -1;
 
   if (rpc_read(conn, &kind, sizeof(enum cudaMemcpyKind)) < 0 ||
@@ -39,12 +608,28 @@ int handle_cudaMemcpy(void *conn) {
        rpc_read(conn, &src, sizeof(void *)) < 0) ||
       (kind != cudaMemcpyDeviceToHost &&
        rpc_read(conn, &dst, sizeof(void *)) < 0) ||
-      rpc_read(conn, &count, sizeof(size_t)) < 0)
+      rpc_read(conn, &count, sizeof(size_t)) < 0 ||
+      (kind != cudaMemcpyDeviceToDevice &&
+       rpc_read(conn, &stripes, sizeof(int)) < 0) ||
+      (kind == cudaMemcpyHostToDevice &&
+       rpc_read(conn, &dedup, sizeof(int)) < 0))
     goto ERROR_0;
 
+  if (dedup != DEDUP_NONE)
+    return handle_cudaMemcpy_dedup(conn, dst, count, dedup);
+
   switch (kind) {
   case cudaMemcpyDeviceToHost:
-    host_data = malloc(count);
+    // inline copies are staged while the response is written, below.
+    if (stripes == 0) {
+      request_id = rpc_end_request(conn);
+      if (request_id < 0)
+        goto ERROR_0;
+      break;
+    }
+
+    // striped copies need the whole payload on the host.
+    host_data = staging_acquire(count);
     if (host_data == NULL)
       goto ERROR_0;
 
@@ -52,21 +637,59 @@ int handle_cudaMemcpy(void *conn) {
     if (request_id < 0)
       goto ERROR_1;
 
-    result = cudaMemcpy(host_data, src, count, kind);
+    result = cudaMemcpy(host_data->data, src, count, kind);
     break;
   case cudaMemcpyHostToDevice:
-    host_data = malloc(count);
+    // copy from memory the transport already holds (a batch frame or a
+    // shared-memory ring) without staging it in host_data first. compressed
+    // payloads have to be decompressed into host_data.
+    if (stripes == 0 && count > 0 && !rpc_compressed(conn, count))
+      span_size = rpc_peek(conn, &span, count);
+    if (span_size < 0)
+      goto ERROR_0;
+    if (span_size > 0) {
+      result = cudaSuccess;
+      for (std::size_t offset = 0; offset < count; offset += span_size) {
+        if (offset > 0)
+          span_size = rpc_peek(conn, &span, count - offset);
+        if (span_size <= 0)
+          goto ERROR_0;
+        if (result == cudaSuccess)
+          result = cudaMemcpy((char *)dst + offset, span, span_size, kind);
+        if (rpc_consume(conn, span_size) < 0)
+          goto ERROR_0;
+      }
+
+      request_id = rpc_end_request(conn);
+      if (request_id < 0)
+        goto ERROR_0;
+      break;
+    }
+
+    if (stripes == 0) {
+      if (staged_upload(conn, dst, count, &result) < 0)
+        goto ERROR_0;
+
+      request_id = rpc_end_request(conn);
+      if (request_id < 0)
+        goto ERROR_0;
+      break;
+    }
+
+    // large payloads arrive striped across the client's data connections,
+    // all at once.
+    host_data = staging_acquire(count);
     if (host_data == NULL)
       goto ERROR_0;
 
-    if (rpc_read(conn, host_data, count) < 0)
+    if (rpc_read_stripes(conn, host_data->data, count, stripes) < 0)
       goto ERROR_1;
 
     request_id = rpc_end_request(conn);
     if (request_id < 0)
       goto ERROR_1;
 
-    result = cudaMemcpy(dst, host_data, count, kind);
+    result = cudaMemcpy(dst, host_data->data, count, kind);
     break;
   case cudaMemcpyDeviceToDevice:
     request_id = rpc_end_request(conn);
@@ -77,16 +700,20 @@ int handle_cudaMemcpy(void *conn) {
     break;
   }
 
+  // striped device to host data follows the response, and only on success.
   if (rpc_start_response(conn, request_id) < 0 ||
-      (kind == cudaMemcpyDeviceToHost &&
-       rpc_write(conn, host_data, count) < 0) ||
-      rpc_end_response(conn, &result) < 0)
+      (kind == cudaMemcpyDeviceToHost && stripes == 0 &&
+       staged_download(conn, src, count, &result) < 0) ||
+      rpc_merge_deferred_error(conn, request_id, &result) < 0 ||
+      rpc_end_response(conn, &result) < 0 ||
+      (kind == cudaMemcpyDeviceToHost && stripes > 0 &&
+       result == cudaSuccess &&
+       rpc_write_stripes(conn, host_data->data, count, stripes) < 0))
     goto ERROR_1;
 
   ret = 0;
 ERROR_1:
-  if (host_data != NULL)
-    free((void *)host_data);
+  staging_release(host_data);
 ERROR_0:
   return ret;
 }
@@ -96,7 +723,7 @@ int handle_cudaMemcpyAsync(void *conn) {
   cudaError_t result;
   void *src;
   void *dst;
-  void *host_data;
+  staging_buffer_t *host_data = NULL;
   std::size_t count;
   enum cudaMemcpyKind kind;
   int stream_null_check;
@@ -113,32 +740,37 @@ int handle_cudaMemcpyAsync(void *conn) {
        rpc_read(conn, &dst, sizeof(void *)) < 0) ||
       rpc_read(conn, &count, sizeof(size_t)) < 0)
     goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
 
   switch (kind) {
   case cudaMemcpyDeviceToHost:
-    host_data = malloc(count);
+    host_data = staging_acquire(count);
     if (host_data == NULL)
       goto ERROR_0;
 
     request_id = rpc_end_request(conn);
     if (request_id < 0)
-      goto ERROR_0;
+      goto ERROR_1;
 
-    result = cudaMemcpyAsync(host_data, src, count, kind, stream);
+    result = cudaMemcpyAsync(host_data->data, src, count, kind, stream);
     break;
   case cudaMemcpyHostToDevice:
-    host_data = malloc(count);
+    host_data = staging_acquire(count);
     if (host_data == NULL)
       goto ERROR_0;
 
-    if (rpc_read(conn, host_data, count) < 0)
-      goto ERROR_0;
+    if (rpc_read_compressed(conn, host_data->data, count) < 0)
+      goto ERROR_1;
 
     request_id = rpc_end_request(conn);
     if (request_id < 0)
-      goto ERROR_0;
+      goto ERROR_1;
+
+    result = cudaMemcpyAsync(dst, host_data->data, count, kind, stream);
 
-    result = cudaMemcpyAsync(dst, host_data, count, kind, stream);
+    // the buffer goes back to the pool once the stream is done with it.
+    staging_release_after(host_data, stream);
+    host_data = NULL;
     break;
   case cudaMemcpyDeviceToDevice:
     request_id = rpc_end_request(conn);
@@ -149,18 +781,38 @@ int handle_cudaMemcpyAsync(void *conn) {
     break;
   }
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      (kind == cudaMemcpyDeviceToHost &&
-       rpc_write(conn, host_data, count) < 0) ||
-      rpc_end_response(conn, &result) < 0 ||
-      (host_data != NULL && cudaStreamAddCallback(
-                                stream,
-                                [](cudaStream_t stream, cudaError_t status,
-                                   void *ptr) { free(ptr); },
-                                host_data, 0) != cudaSuccess))
-    goto ERROR_0;
+  // only device to host copies have anything to send back; the client doesn't
+  // wait on the others, so their errors are reported at the next sync point.
+  if (kind != cudaMemcpyDeviceToHost) {
+    if (rpc_defer_error(conn, result) < 0)
+      goto ERROR_1;
+  } else {
+    // into pinned memory the copy really is asynchronous. the stream's
+    // executor waits for it and sends the data back, so requests for other
+    // streams go on in the meantime.
+    staging_pool_t *pool = &staging;
+    staging_buffer_t *buffer = host_data;
+    host_data = NULL;
+    if (rpc_run_on_stream(conn, (const void *)stream, [=]() {
+          cudaError_t copied = result;
+          int sent = 0;
+          if (copied == cudaSuccess)
+            copied = cudaStreamSynchronize(stream);
+          if (rpc_merge_deferred_error(conn, request_id, &copied) < 0 ||
+              rpc_start_response(conn, request_id) < 0 ||
+              rpc_write_compressed(conn, buffer->data, count) < 0 ||
+              rpc_end_response(conn, &copied) < 0)
+            sent = -1;
+          staging_sent(conn, buffer);
+          staging_return(pool, buffer);
+          return sent;
+        }) < 0)
+      goto ERROR_1;
+  }
 
   ret = 0;
+ERROR_1:
+  staging_release(host_data);
 ERROR_0:
   return ret;
 }
@@ -184,43 +836,36 @@ int handle_cudaLaunchKernel(void *conn) {
       rpc_read(conn, &num_args, sizeof(int)) < 0)
     goto ERROR_0;
 
-  // Allocate memory for the arguments
-  args = (void **)malloc(num_args * sizeof(void *));
+  // the arguments only need to live until cudaLaunchKernel has copied them,
+  // so they come from the request arena.
+  args = (void **)rpc_arena_alloc(conn, num_args * sizeof(void *));
   if (args == NULL)
     goto ERROR_0;
 
   for (int i = 0; i < num_args; ++i) {
     if (rpc_read(conn, &arg_size, sizeof(int)) < 0)
-      goto ERROR_1;
-
-    // Allocate memory for the argument
-    args[i] = malloc(arg_size);
-    if (args[i] == NULL)
-      goto ERROR_1;
+      goto ERROR_0;
 
-    // Read the actual argument data from the client
-    if (rpc_read(conn, args[i], arg_size) < 0)
-      goto ERROR_1;
+    args[i] = rpc_arena_alloc(conn, arg_size);
+    if (args[i] == NULL || rpc_read(conn, args[i], arg_size) < 0)
+      goto ERROR_0;
   }
 
   request_id = rpc_end_request(conn);
   if (request_id < 0)
-    goto ERROR_1;
+    goto ERROR_0;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
 
   result = cudaLaunchKernel(func, gridDim, blockDim, args, sharedMem, stream);
 
   std::cout << "Launch kern result: " << result << std::endl;
 
-  if (rpc_start_response(conn, request_id) < 0 ||
-      rpc_end_response(conn, &result) < 0)
-    goto ERROR_1;
+  // launches are fire-and-forget; the client picks up any error at the next
+  // sync point.
+  if (rpc_defer_error(conn, result) < 0)
+    goto ERROR_0;
 
   return 0;
-ERROR_1:
-  for (int i = 0; i < num_args; ++i)
-    if (args[i] != NULL)
-      free(args[i]);
-  free(args);
 ERROR_0:
   return -1;
 }
@@ -239,7 +884,7 @@ int handle___cudaRegisterFatBinary(void *conn) {
     return -1;
 
   void *cubin = malloc(size);
-  if (rpc_read(conn, cubin, size) < 0)
+  if (rpc_read_compressed(conn, cubin, size) < 0)
     return -1;
 
   fatCubin->text = (uint64_t)cubin;
@@ -387,6 +1032,7 @@ int handle___cudaPushCallConfiguration(void *conn) {
   int request_id = rpc_end_request(conn);
   if (request_id < 0)
     return -1;
+  stream = (cudaStream_t)rpc_real_handle(conn, (const void *)stream);
 
   unsigned int result =
       __cudaPushCallConfiguration(gridDim, blockDim, sharedMem, stream);
@@ -415,6 +1061,7 @@ int handle___cudaPopCallConfiguration(void *conn) {
 
   cudaError_t result =
       __cudaPopCallConfiguration(&gridDim, &blockDim, &sharedMem, &stream);
+  stream = (cudaStream_t)rpc_virtual_handle(conn, (const void *)stream);
 
   if (rpc_start_response(conn, request_id) < 0 ||
       rpc_write(conn, &gridDim, sizeof(dim3)) < 0 ||
@@ -573,3 +1220,111 @@ int handle_cudaMallocManaged(void *conn) {
 ERROR_0:
   return -1;
 }
+
+// everything the client answers version, property and attribute queries
+// from, for the devices this client was given. see snapshot.h.
+int handle___scudaGetDeviceSnapshot(void *conn) {
+  snapshot_t snapshot;
+  int count = 0;
+  if (cudaGetDeviceCount(&count) != cudaSuccess)
+    count = 0;
+  count = rpc_client_device_count(conn, count);
+  std::vector<device_snapshot_t> devices(count);
+  int result = 0;
+
+  int request_id = rpc_end_request(conn);
+  if (request_id < 0)
+    return -1;
+
+  // the attribute ids that don't exist fail, which would otherwise show up
+  // in the client's next cudaGetLastError.
+  bool clear_error = cudaPeekAtLastError() == cudaSuccess;
+
+  snapshot.driver_result = cudaDriverGetVersion(&snapshot.driver_version);
+  snapshot.runtime_result = cudaRuntimeGetVersion(&snapshot.runtime_version);
+  snapshot.cu_driver_result = cuDriverGetVersion(&snapshot.cu_driver_version);
+
+  for (int i = 0; i < count; i++) {
+    device_snapshot_t *device = &devices[i];
+    int ordinal = rpc_server_device(conn, i);
+
+    device->prop_result = cudaGetDeviceProperties(&device->prop, ordinal);
+
+    // the runtime calls above initialized the driver.
+    CUdevice cu_device;
+    CUresult cu_result = cuDeviceGet(&cu_device, ordinal);
+
+    for (int attr = 0; attr < SNAPSHOT_ATTRIBUTES; attr++) {
+      device->attribute_results[attr] = cudaDeviceGetAttribute(
+          &device->attributes[attr], (cudaDeviceAttr)attr, ordinal);
+      device->cu_attribute_results[attr] =
+          cu_result != CUDA_SUCCESS
+              ? cu_result
+              : cuDeviceGetAttribute(&device->cu_attributes[attr],
+                                     (CUdevice_attribute)attr, cu_device);
+    }
+  }
+
+  if (clear_error)
+    cudaGetLastError();
+
+  if (rpc_start_response(conn, request_id) < 0 ||
+      rpc_write(conn, &snapshot, sizeof(snapshot_t)) < 0 ||
+      rpc_write(conn, &count, sizeof(int)) < 0 ||
+      rpc_write(conn, devices.data(), count * sizeof(device_snapshot_t)) < 0 ||
+      rpc_end_response(conn, &result) < 0)
+    return -1;
+
+  return 0;
+}
+
+// sent ahead of a client thread's request when that thread is on another
+// device or capture mode than the one before it. it has no response, so an
+// error waits for the next sync point like an async call's.
+int handle___scudaSetThreadState(void *conn) {
+  int device, mode;
+  cudaError_t result;
+
+  if (rpc_read(conn, &device, sizeof(int)) < 0 ||
+      rpc_read(conn, &mode, sizeof(int)) < 0 || rpc_end_request(conn) < 0)
+    return -1;
+
+  // -1 leaves the device alone; this server isn't the thread's current one.
+  if (device >= 0) {
+    result = cudaSetDevice(rpc_server_device(conn, device));
+    if (result != cudaSuccess && rpc_defer_error(conn, result) < 0)
+      return -1;
+  }
+
+  cudaStreamCaptureMode capture_mode = (cudaStreamCaptureMode)mode;
+  result = cudaThreadExchangeStreamCaptureMode(&capture_mode);
+  if (result != cudaSuccess && rpc_defer_error(conn, result) < 0)
+    return -1;
+
+  return 0;
+}
+
+// slabs the client's allocator no longer needs, freed together. the client
+// doesn't wait, so the first error waits for the next sync point.
+int handle___scudaFreeBatch(void *conn) {
+  int count;
+  void **ptrs;
+  cudaError_t result = cudaSuccess;
+
+  if (rpc_read(conn, &count, sizeof(int)) < 0)
+    return -1;
+  ptrs = (void **)rpc_arena_alloc(conn, count * sizeof(void *));
+  if (ptrs == NULL || rpc_read(conn, ptrs, count * sizeof(void *)) < 0 ||
+      rpc_end_request(conn) < 0)
+    return -1;
+
+  for (int i = 0; i < count; i++) {
+    cudaError_t error = cudaFree(ptrs[i]);
+    if (result == cudaSuccess)
+      result = error;
+  }
+  if (result != cudaSuccess && rpc_defer_error(conn, result) < 0)
+    return -1;
+
+  return 0;
+}
@@ -13,3 +13,9 @@ int handle___cudaRegisterFatBinary(void *conn);
 int handle___cudaRegisterFatBinaryEnd(void *conn);
 int handle___cudaPushCallConfiguration(void *conn);
 int handle___cudaPopCallConfiguration(void *conn);
+int handle___scudaGetDeviceSnapshot(void *conn);
+int handle___scudaSetThreadState(void *conn);
+int handle___scudaFreeBatch(void *conn);
+
+void staging_shutdown();
+void staging_forget(const void *conn);
@@ -0,0 +1,186 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+// codecs a client can ask for at connect time. there is only one for now; the
+// id leaves room for others.
+#define COMPRESS_NONE 0
+#define COMPRESS_LZ4 1
+
+// compressed payloads are split into chunks of this many bytes, so the sender
+// can put one on the wire while it compresses the next and the receiver can
+// decompress one while the next arrives.
+#define COMPRESS_CHUNK (256 * 1024)
+
+// each chunk is sent as [uint32 compressed length][lz4 block]. this length
+// instead means the rest of the payload follows uncompressed, which the
+// sender switches to as soon as a chunk doesn't compress well.
+#define COMPRESS_STORED 0xffffffffu
+
+#define COMPRESS_HASH_BITS 14
+
+static inline uint32_t compress_read32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(uint32_t));
+  return v;
+}
+
+static inline uint8_t *compress_put_length(uint8_t *op, size_t length) {
+  for (; length >= 255; length -= 255)
+    *op++ = 255;
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// compress src into dst as an lz4 block. returns the compressed size, or 0 if
+// it doesn't fit in capacity bytes, so passing a capacity below size both
+// bounds the output and rejects data that doesn't compress well enough.
+static inline size_t compress_lz4(const void *src, const size_t size, void *dst,
+                                  const size_t capacity) {
+  const uint8_t *base = (const uint8_t *)src;
+  const uint8_t *end = base + size;
+  const uint8_t *ip = base, *anchor = base;
+  uint8_t *op = (uint8_t *)dst;
+  uint8_t *oend = op + capacity;
+
+  // the format wants the last 5 bytes as literals and no match starting in
+  // the last 12.
+  if (size > 12) {
+    const uint8_t *match_limit = end - 5;
+    const uint8_t *start_limit = end - 12;
+    uint32_t table[1 << COMPRESS_HASH_BITS] = {};
+    unsigned misses = 0;
+
+    while (ip < start_limit) {
+      uint32_t sequence = compress_read32(ip);
+      uint32_t hash = (sequence * 2654435761u) >> (32 - COMPRESS_HASH_BITS);
+      const uint8_t *ref = base + table[hash];
+      table[hash] = ip - base;
+
+      if (ref >= ip || ip - ref > 65535 || compress_read32(ref) != sequence) {
+        // skip ahead faster through data that doesn't match.
+        ip += 1 + (misses++ >> 6);
+        if ((size_t)(ip - anchor) >= (size_t)(oend - op))
+          return 0;
+        continue;
+      }
+      misses = 0;
+
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        ip--;
+        ref--;
+      }
+      const uint8_t *match_end = ip + 4;
+      while (match_end < match_limit && *match_end == ref[match_end - ip])
+        match_end++;
+
+      size_t literals = ip - anchor;
+      size_t match = match_end - ip - 4;
+      if (1 + literals / 255 + 1 + literals + 2 + match / 255 + 1 >
+          (size_t)(oend - op))
+        return 0;
+
+      uint8_t *token = op++;
+      *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+      if (literals >= 15)
+        op = compress_put_length(op, literals - 15);
+      if (literals > 0)
+        memcpy(op, anchor, literals);
+      op += literals;
+
+      size_t offset = ip - ref;
+      *op++ = (uint8_t)offset;
+      *op++ = (uint8_t)(offset >> 8);
+      *token |= (uint8_t)(match >= 15 ? 15 : match);
+      if (match >= 15)
+        op = compress_put_length(op, match - 15);
+
+      ip = anchor = match_end;
+    }
+  }
+
+  // an empty src may be null, so the copies skip empty literal runs.
+  size_t literals = end - anchor;
+  if (1 + literals / 255 + 1 + literals > (size_t)(oend - op))
+    return 0;
+  uint8_t *token = op++;
+  *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+  if (literals >= 15)
+    op = compress_put_length(op, literals - 15);
+  if (literals > 0)
+    memcpy(op, anchor, literals);
+  op += literals;
+  return op - (uint8_t *)dst;
+}
+
+// decompress an lz4 block. returns the decompressed size, or -1 if the block
+// is malformed or doesn't fit in capacity bytes.
+static inline ssize_t decompress_lz4(const void *src, const size_t size,
+                                     void *dst, const size_t capacity) {
+  const uint8_t *ip = (const uint8_t *)src;
+  const uint8_t *iend = ip + size;
+  uint8_t *base = (uint8_t *)dst;
+  uint8_t *op = base;
+  uint8_t *oend = base + capacity;
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+
+    size_t literals = token >> 4;
+    if (literals == 15) {
+      uint8_t b;
+      do {
+        if (ip == iend)
+          return -1;
+        b = *ip++;
+        literals += b;
+      } while (b == 255);
+    }
+    if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op))
+      return -1;
+    if (literals > 0)
+      memcpy(op, ip, literals);
+    ip += literals;
+    op += literals;
+
+    // the last sequence is literals only.
+    if (ip == iend)
+      break;
+
+    if (iend - ip < 2)
+      return -1;
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - base))
+      return -1;
+
+    size_t match = (token & 15) + 4;
+    if ((token & 15) == 15) {
+      uint8_t b;
+      do {
+        if (ip == iend)
+          return -1;
+        b = *ip++;
+        match += b;
+      } while (b == 255);
+    }
+    if (match > (size_t)(oend - op))
+      return -1;
+
+    // matches may overlap their own output, e.g. a run of one byte. the
+    // repeating pattern doubles in length with every copy.
+    const uint8_t *ref = op - offset;
+    while (match > 0) {
+      size_t n = match < (size_t)(op - ref) ? match : op - ref;
+      memcpy(op, ref, n);
+      op += n;
+      match -= n;
+    }
+  }
+  return op - base;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stdint.h>
+#include <string.h>
+
+// large host to device copies are split into chunks of this many bytes. the
+// client sends the hash of each chunk first and only the chunks the server
+// doesn't already hold travel.
+#define DEDUP_CHUNK (1024 * 1024)
+
+// what follows the stripes field of a host to device cudaMemcpy.
+// DEDUP_QUERY is followed by [size_t chunks][dedup_hash_t hashes...] and
+// answered with [char missing[chunks]][result]; the server copies the chunks
+// it holds right away. unless nothing was missing, the client then sends
+// DEDUP_MISSING followed by the missing chunks, in order.
+#define DEDUP_NONE 0
+#define DEDUP_QUERY 1
+#define DEDUP_MISSING 2
+
+// two 64-bit xxh64 hashes with different seeds. a chunk is identified by its
+// hash and size, so a collision would need both halves to match.
+typedef struct {
+  uint64_t lo, hi;
+} dedup_hash_t;
+
+#define DEDUP_PRIME1 0x9e3779b185ebca87ULL
+#define DEDUP_PRIME2 0xc2b2ae3d27d4eb4fULL
+#define DEDUP_PRIME3 0x165667b19e3779f9ULL
+#define DEDUP_PRIME4 0x85ebca77c2b2ae63ULL
+#define DEDUP_PRIME5 0x27d4eb2f165667c5ULL
+
+static inline uint64_t dedup_rotl(const uint64_t x, const int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t dedup_round(uint64_t acc, const uint64_t input) {
+  acc += input * DEDUP_PRIME2;
+  return dedup_rotl(acc, 31) * DEDUP_PRIME1;
+}
+
+static inline uint64_t dedup_merge(uint64_t acc, const uint64_t v) {
+  acc ^= dedup_round(0, v);
+  return acc * DEDUP_PRIME1 + DEDUP_PRIME4;
+}
+
+static inline uint64_t dedup_read64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(uint64_t));
+  return v;
+}
+
+// xxh64. the four independent lanes keep the multipliers busy, so this runs
+// at close to memory bandwidth.
+static inline uint64_t dedup_xxh64(const void *data, const size_t size,
+                                   const uint64_t seed) {
+  const uint8_t *p = (const uint8_t *)data;
+  const uint8_t *end = p + size;
+  uint64_t h;
+
+  if (size >= 32) {
+    uint64_t v1 = seed + DEDUP_PRIME1 + DEDUP_PRIME2;
+    uint64_t v2 = seed + DEDUP_PRIME2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - DEDUP_PRIME1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = dedup_round(v1, dedup_read64(p));
+      v2 = dedup_round(v2, dedup_read64(p + 8));
+      v3 = dedup_round(v3, dedup_read64(p + 16));
+      v4 = dedup_round(v4, dedup_read64(p + 24));
+    }
+    h = dedup_rotl(v1, 1) + dedup_rotl(v2, 7) + dedup_rotl(v3, 12) +
+        dedup_rotl(v4, 18);
+    h = dedup_merge(h, v1);
+    h = dedup_merge(h, v2);
+    h = dedup_merge(h, v3);
+    h = dedup_merge(h, v4);
+  } else {
+    h = seed + DEDUP_PRIME5;
+  }
+
+  h += size;
+  for (; p + 8 <= end; p += 8) {
+    h ^= dedup_round(0, dedup_read64(p));
+    h = dedup_rotl(h, 27) * DEDUP_PRIME1 + DEDUP_PRIME4;
+  }
+  if (p + 4 <= end) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(uint32_t));
+    h ^= (uint64_t)v * DEDUP_PRIME1;
+    h = dedup_rotl(h, 23) * DEDUP_PRIME2 + DEDUP_PRIME3;
+    p += 4;
+  }
+  for (; p < end; p++) {
+    h ^= *p * DEDUP_PRIME5;
+    h = dedup_rotl(h, 11) * DEDUP_PRIME1;
+  }
+
+  h ^= h >> 33;
+  h *= DEDUP_PRIME2;
+  h ^= h >> 29;
+  h *= DEDUP_PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+static inline dedup_hash_t dedup_hash(const void *data, const size_t size) {
+  return {dedup_xxh64(data, size, 0), dedup_xxh64(data, size, DEDUP_PRIME5)};
+}
+
+#endif
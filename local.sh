@@ -128,6 +128,146 @@ test_unified_mem() {
   fi
 }
 
+test_shm_ring() {
+  output=$(./shm_ring.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "shm_ring failed. Got [$output]."
+    return 1
+  fi
+}
+
+test_allocator() {
+  output=$(./allocator.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "allocator failed. Got [$output]."
+    return 1
+  fi
+}
+
+test_compress_lz4() {
+  output=$(./compress_lz4.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "compress_lz4 failed. Got [$output]."
+    return 1
+  fi
+}
+
+# deduplication only runs over tcp, hence SCUDA_SHM_SIZE=0.
+test_dedup() {
+  output=$(SCUDA_SHM_SIZE=0 SCUDA_DEDUP_SIZE=1048576 LD_PRELOAD="$libscuda_path" ./dedup.o)
+  sent=$(echo "$output" | grep "^Deduplicated copy sent" | tr '\n' ';')
+  expected="Deduplicated copy sent 5 of 5 chunks;Deduplicated copy sent 0 of 5 chunks;Deduplicated copy sent 2 of 5 chunks;Deduplicated copy sent 0 of 5 chunks;"
+
+  if [[ "$(echo "$output" | tail -n 1)" == "PASSED" && "$sent" == "$expected" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "dedup failed. Got [$sent] [$(echo "$output" | tail -n 1)]."
+    return 1
+  fi
+}
+
+# lists the local server twice, so its devices show up once per connection,
+# and stripes the copies across data connections.
+test_sharding() {
+  output=$(SCUDA_SHM_SIZE=0 SCUDA_SERVER="0.0.0.0,0.0.0.0" SCUDA_DATA_CONNECTIONS=2 SCUDA_STRIPE_SIZE=1048576 LD_PRELOAD="$libscuda_path" ./sharding.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "sharding failed. Got [$output]."
+    return 1
+  fi
+}
+
+test_stream_order() {
+  output=$(LD_PRELOAD="$libscuda_path" ./stream_order.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "stream_order failed. Got [$output]."
+    return 1
+  fi
+}
+
+test_last_error() {
+  output=$(LD_PRELOAD="$libscuda_path" ./last_error.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "last_error failed. Got [$output]."
+    return 1
+  fi
+}
+
+test_virtual_handles() {
+  output=$(LD_PRELOAD="$libscuda_path" ./virtual_handles.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "virtual_handles failed. Got [$output]."
+    return 1
+  fi
+}
+
+# needs the server listening on the socket; ./local.sh server does that.
+# the client logs each upload and download of managed memory. copies only go
+# over tcp with data connections, where the large copy is received straight
+# into the managed mirror.
+test_unified() {
+  output=$(SCUDA_SHM_SIZE=0 SCUDA_DATA_CONNECTIONS=2 SCUDA_STRIPE_SIZE=1048576 LD_PRELOAD="$libscuda_path" ./unified.o)
+  # mirrors come back in address order, so only the totals are compared: the
+  # pages of a, the large copy and the file go up once each, and every mirror
+  # allocated so far comes back after each of the six launches.
+  copied=$(echo "$output" | awk '/^Uploaded/ {up += $2} /^Downloaded/ {down += $2} END {print up + 0 ";" down + 0}')
+  expected="$((4096 + 16777216 + 1048576));$((4096 * 18 + 16777216 * 2 + 1048576))"
+
+  if [[ "$(echo "$output" | tail -n 1)" == "PASSED" && "$copied" == "$expected" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "unified failed. Got [$copied] [$(echo "$output" | tail -n 1)]."
+    return 1
+  fi
+}
+
+# the pointer arrays and the matrices the host wrote go up before the call;
+# afterwards the call may have written any of them, so all nine come back at
+# the sync that follows it.
+test_cublas_unified() {
+  output=$(LD_PRELOAD="$libscuda_path" ./cublas_unified.o)
+  copied=$(echo "$output" | grep "^Uploaded\|^Downloaded" | tr '\n' ';')
+  expected="$(printf 'Uploaded 4096 bytes of managed memory;%.0s' {1..7})$(printf 'Downloaded 4096 bytes of managed memory;%.0s' {1..9})"
+
+  if [[ "$(echo "$output" | tail -n 1)" == "PASSED" && "$copied" == "$expected" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "cublas_unified failed. Got [$copied] [$(echo "$output" | tail -n 1)]."
+    return 1
+  fi
+}
+
+test_unix_socket() {
+  output=$(SCUDA_SHM_SIZE=0 SCUDA_SERVER="unix:///tmp/scuda.sock" LD_PRELOAD="$libscuda_path" ./transport_roundtrip.o | tail -n 1)
+
+  if [[ "$output" == "PASSED" ]]; then
+    ansi_format "pass" "$pass_message"
+  else
+    ansi_format "fail" "transport_roundtrip over a unix socket failed. Got [$output]."
+    return 1
+  fi
+}
+
 #---- declare test cases ----#
 declare -A test_cuda_avail=(
   ["function"]="test_cuda_available"
@@ -164,8 +304,63 @@ declare -A test_unified_mem=(
   ["pass"]="Unified memory works as expected."
 )
 
+declare -A test_shm_ring=(
+  ["function"]="test_shm_ring"
+  ["pass"]="Shared-memory rings carry bytes in order and notice a hangup."
+)
+
+declare -A test_allocator=(
+  ["function"]="test_allocator"
+  ["pass"]="Slab blocks split, merge and trim correctly."
+)
+
+declare -A test_compress_lz4=(
+  ["function"]="test_compress_lz4"
+  ["pass"]="LZ4 blocks round-trip and malformed ones are rejected."
+)
+
+declare -A test_dedup=(
+  ["function"]="test_dedup"
+  ["pass"]="Deduplicated uploads send only the chunks the server lacks."
+)
+
+declare -A test_sharding=(
+  ["function"]="test_sharding"
+  ["pass"]="Devices of several servers are numbered and routed to correctly."
+)
+
+declare -A test_stream_order=(
+  ["function"]="test_stream_order"
+  ["pass"]="Stream executors keep cuda's ordering and error reporting."
+)
+
+declare -A test_last_error=(
+  ["function"]="test_last_error"
+  ["pass"]="cudaGetLastError reports errors from launches."
+)
+
+declare -A test_virtual_handles=(
+  ["function"]="test_virtual_handles"
+  ["pass"]="Handles named by the client act on the server's objects."
+)
+
+declare -A test_unified=(
+  ["function"]="test_unified"
+  ["pass"]="Managed memory moves only the pages the host and device touch."
+)
+
+declare -A test_cublas_unified=(
+  ["function"]="test_cublas_unified"
+  ["pass"]="Batched cublas works on managed memory via test/cublas_unified.cu."
+)
+
+declare -A test_unix_socket=(
+  ["function"]="test_unix_socket"
+  ["pass"]="Copies and launches round-trip over a unix socket."
+)
+
 #---- assign them to our associative array ----#
-tests=("test_cuda_avail" "test_tensor_to_cuda" "test_tensor_to_cuda_to_cpu" "test_vector_add" "test_cudnn" "test_cublas_batched" "test_unified_mem")
+tests=("test_cuda_avail" "test_tensor_to_cuda" "test_tensor_to_cuda_to_cpu" "test_vector_add" "test_cudnn" "test_cublas_batched" "test_unified_mem" "test_shm_ring" "test_allocator" "test_compress_lz4" "test_dedup" "test_sharding" "test_stream_order" "test_last_error" "test_virtual_handles" "test_unified" "test_cublas_unified" "test_unix_socket")
 
 test() {
   set_paths
@@ -381,6 +576,17 @@ build_tests() {
   nvcc --cudart=shared -lnvidia-ml -lcuda -lcudnn -lcublas ./test/unified_linked.cu -o unified_linked.o
   nvcc --cudart=shared -lnvidia-ml -lcuda -lcudnn -lcublas ./test/cublas_unified.cu -o cublas_unified.o
   nvcc --cudart=shared -lnvidia-ml -lcuda -lcudnn -lcublas ./test/cudnn_managed.cu -o cudnn_managed.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda -lcublas ./test/virtual_handles.cu -o virtual_handles.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/transport_roundtrip.cu -o transport_roundtrip.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/dedup.cu -o dedup.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/sharding.cu -o sharding.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/stream_order.cu -o stream_order.o
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/last_error.cu -o last_error.o
+
+  # these only exercise host code, so they run without a server or a GPU.
+  g++ -std=c++17 -I. ./test/shm_ring.cpp -o shm_ring.o -lpthread
+  g++ -std=c++17 -I. ./test/allocator.cpp -o allocator.o
+  g++ -std=c++17 -fsanitize=address,undefined -fno-sanitize-recover=all -I. ./test/compress_lz4.cpp -o compress_lz4.o
 }
 
 set_paths() {
@@ -434,7 +640,41 @@ test_ci() {
 
 server() {
   set_paths
-  $server_out_path
+  # the unix socket test and the benchmark connect here.
+  SCUDA_LISTEN="${SCUDA_LISTEN:-unix:///tmp/scuda.sock}" $server_out_path
+}
+
+# compares small-rpc latency across transports. start the server with
+# ./local.sh server first.
+benchmark() {
+  set_paths
+
+  nvcc --cudart=shared -lnvidia-ml -lcuda ./test/rpc_latency.cu -o rpc_latency.o
+
+  echo -e "\n\033[1mRunning latency benchmark...\033[0m"
+
+  for endpoint in "0.0.0.0" "unix:///tmp/scuda.sock" "shm:///tmp/scuda-14833.sock"; do
+    # SCUDA_SHM_SIZE=0 keeps the tcp run from switching to shared memory
+    output=$(SCUDA_SHM_SIZE=0 SCUDA_SERVER="$endpoint" LD_PRELOAD="$libscuda_path" ./rpc_latency.o | tail -n 1)
+    echo "$endpoint: $output"
+  done
+
+  # per-request latency over tcp as the number of clients grows. each client
+  # is a process of its own, since the threads of one process share its
+  # connection. restart the server with SCUDA_REACTOR_THREADS=0 to compare
+  # against a thread per client.
+  results=$(mktemp -d)
+  for clients in 1 10 100 500; do
+    for i in $(seq "$clients"); do
+      SCUDA_SHM_SIZE=0 SCUDA_SERVER="0.0.0.0" LD_PRELOAD="$libscuda_path" ./rpc_latency.o 1000 | tail -n 1 > "$results/$i" &
+    done
+    wait
+    cat "$results"/* | awk -v clients="$clients" '
+      { avg += $5; p50 += $8; if ($11 > p99) p99 = $11 }
+      END { printf "%d clients: avg %.2f us, mean p50 %.2f us, worst p99 %.2f us\n", clients, avg / NR, p50 / NR, p99 }'
+    rm -f "$results"/*
+  done
+  rmdir "$results"
 }
 
 # Main script logic using a switch case
@@ -454,8 +694,11 @@ case "$1" in
   test)
     test
     ;;
+  benchmark)
+    benchmark
+    ;;
   *)
-    echo "Usage: $0 {build|run|server}"
+    echo "Usage: $0 {build|run|server|benchmark}"
     exit 1
     ;;
 esac
@@ -0,0 +1,622 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <nvml.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include "codegen/gen_api.h"
+
+#define DEFAULT_PORT 14833
+#define MAX_CLIENTS 10
+
+// request ids the router looks at before it starts proxying a connection. see
+// rpc_connect_data and rpc_negotiate_compression in client.cpp.
+#define SESSION_REQUEST_ID -2
+#define DATA_REQUEST_ID -3
+#define COMPRESS_REQUEST_ID -4
+
+// sent first on a probe connection so the server doesn't give it devices of
+// its own. see PROBE_REQUEST_ID in server.cu.
+#define PROBE_REQUEST_ID -5
+
+// how often each backend's gpus are polled, overridable with
+// SCUDA_ROUTER_POLL_MSEC.
+int poll_msec = 1000;
+
+// load added to a backend for each session placed on it since its last poll,
+// so a burst of clients doesn't all land on the backend that looked idlest.
+#define PLACEMENT_PENALTY 10.0
+
+// bytes in flight in each direction of a proxied connection.
+#define PIPE_SIZE (1024 * 1024)
+
+// how long a data connection waits for its primary connection to be placed.
+#define DATA_WAIT_SEC 10
+
+typedef struct {
+  // host:port as given in SCUDA_BACKENDS, which is also how the control
+  // socket names it.
+  std::string name;
+  std::string host;
+  std::string port;
+
+  // guarded by backends_mutex.
+  bool up;
+  bool draining;
+  int sessions;
+  // sessions placed since the last poll, which the poll can't see yet.
+  int placed;
+  unsigned int devices;
+  unsigned long long memory_total, memory_used;
+  unsigned int utilization;
+  double load;
+
+  // used only by the backend's poll thread.
+  int probe_fd;
+  int probe_request_id;
+  std::vector<nvmlDevice_t> handles;
+} backend_t;
+
+std::vector<backend_t> backends;
+pthread_mutex_t backends_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// the backend each primary connection went to, by session id, so its data
+// connections follow it there.
+std::unordered_map<uint64_t, int> sessions;
+pthread_mutex_t sessions_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t sessions_cond = PTHREAD_COND_INITIALIZER;
+
+int backend_connect(const backend_t *backend) {
+  struct addrinfo hints, *res;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(backend->host.c_str(), backend->port.c_str(), &hints,
+                  &res) != 0)
+    return -1;
+
+  int flag = 1;
+  int sockfd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (sockfd < 0 ||
+      setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, (char *)&flag,
+                 sizeof(int)) < 0 ||
+      connect(sockfd, res->ai_addr, res->ai_addrlen) < 0) {
+    if (sockfd >= 0)
+      close(sockfd);
+    freeaddrinfo(res);
+    return -1;
+  }
+  freeaddrinfo(res);
+  return sockfd;
+}
+
+// make one call on a backend's probe connection, the same way the client
+// does: [request id][op][args] answered with [request id][response][result].
+int probe_call(backend_t *backend, const unsigned int op, const void *args,
+               const size_t args_size, void *response,
+               const size_t response_size) {
+  int request_id = backend->probe_request_id++;
+  int response_id;
+  nvmlReturn_t result;
+  struct iovec request[3] = {{&request_id, sizeof(int)},
+                             {(void *)&op, sizeof(unsigned int)},
+                             {(void *)args, args_size}};
+
+  if (writev(backend->probe_fd, request, 3) < 0 ||
+      recv(backend->probe_fd, &response_id, sizeof(int), MSG_WAITALL) !=
+          sizeof(int) ||
+      response_id != request_id ||
+      recv(backend->probe_fd, response, response_size, MSG_WAITALL) !=
+          (ssize_t)response_size ||
+      recv(backend->probe_fd, &result, sizeof(nvmlReturn_t), MSG_WAITALL) !=
+          sizeof(nvmlReturn_t) ||
+      result != NVML_SUCCESS)
+    return -1;
+  return 0;
+}
+
+// (re)connect the probe connection and look up the backend's gpus.
+int probe_open(backend_t *backend) {
+  unsigned int count;
+
+  int probe_request_id = PROBE_REQUEST_ID;
+  backend->probe_fd = backend_connect(backend);
+  if (backend->probe_fd < 0 ||
+      send(backend->probe_fd, &probe_request_id, sizeof(int), MSG_NOSIGNAL) !=
+          sizeof(int) ||
+      probe_call(backend, RPC_nvmlInit_v2, NULL, 0, NULL, 0) < 0 ||
+      probe_call(backend, RPC_nvmlDeviceGetCount_v2, NULL, 0, &count,
+                 sizeof(unsigned int)) < 0)
+    return -1;
+
+  backend->handles.resize(count);
+  for (unsigned int i = 0; i < count; i++)
+    if (probe_call(backend, RPC_nvmlDeviceGetHandleByIndex_v2, &i,
+                   sizeof(unsigned int), &backend->handles[i],
+                   sizeof(nvmlDevice_t)) < 0)
+      return -1;
+  return 0;
+}
+
+// ask the backend how busy its gpus are. its load is the average gpu
+// utilization plus the share of gpu memory in use, both in percent.
+int probe_backend(backend_t *backend) {
+  unsigned long long memory_total = 0, memory_used = 0;
+  unsigned int utilization = 0;
+
+  if (backend->probe_fd < 0 && probe_open(backend) < 0)
+    return -1;
+
+  for (nvmlDevice_t handle : backend->handles) {
+    nvmlMemory_t memory;
+    nvmlUtilization_t rates;
+    if (probe_call(backend, RPC_nvmlDeviceGetMemoryInfo, &handle,
+                   sizeof(nvmlDevice_t), &memory, sizeof(nvmlMemory_t)) < 0 ||
+        probe_call(backend, RPC_nvmlDeviceGetUtilizationRates, &handle,
+                   sizeof(nvmlDevice_t), &rates,
+                   sizeof(nvmlUtilization_t)) < 0)
+      return -1;
+    memory_total += memory.total;
+    memory_used += memory.used;
+    utilization += rates.gpu;
+  }
+
+  pthread_mutex_lock(&backends_mutex);
+  if (!backend->up)
+    printf("Backend %s is up with %zu devices.\n", backend->name.c_str(),
+           backend->handles.size());
+  backend->up = true;
+  backend->placed = 0;
+  backend->devices = backend->handles.size();
+  backend->memory_total = memory_total;
+  backend->memory_used = memory_used;
+  backend->utilization =
+      backend->handles.empty() ? 0 : utilization / backend->handles.size();
+  backend->load = backend->utilization;
+  if (memory_total > 0)
+    backend->load += 100.0 * memory_used / memory_total;
+  pthread_mutex_unlock(&backends_mutex);
+  return 0;
+}
+
+void poll_loop(const int index) {
+  backend_t *backend = &backends[index];
+  struct timespec interval = {poll_msec / 1000,
+                              (poll_msec % 1000) * 1000 * 1000};
+
+  while (1) {
+    if (probe_backend(backend) < 0) {
+      if (backend->probe_fd >= 0)
+        close(backend->probe_fd);
+      backend->probe_fd = -1;
+
+      pthread_mutex_lock(&backends_mutex);
+      if (backend->up)
+        std::cerr << "Backend " << backend->name << " is down." << std::endl;
+      backend->up = false;
+      pthread_mutex_unlock(&backends_mutex);
+    }
+    nanosleep(&interval, NULL);
+  }
+}
+
+// pick the least-loaded backend that is up and not draining, counting the
+// session against it. returns -1 if there is none.
+int place_session() {
+  int best = -1;
+  double best_load = 0;
+
+  pthread_mutex_lock(&backends_mutex);
+  for (int i = 0; i < (int)backends.size(); i++) {
+    const backend_t *backend = &backends[i];
+    if (!backend->up || backend->draining)
+      continue;
+
+    double load = backend->load + PLACEMENT_PENALTY * backend->placed;
+    if (best < 0 || load < best_load ||
+        (load == best_load && backend->sessions < backends[best].sessions)) {
+      best = i;
+      best_load = load;
+    }
+  }
+  if (best >= 0) {
+    backends[best].sessions++;
+    backends[best].placed++;
+  }
+  pthread_mutex_unlock(&backends_mutex);
+  return best;
+}
+
+void end_session(const int index) {
+  pthread_mutex_lock(&backends_mutex);
+  backends[index].sessions--;
+  pthread_mutex_unlock(&backends_mutex);
+}
+
+// read size bytes from one side and pass them on to the other.
+int forward(const int from, const int to, void *data, const size_t size) {
+  if (recv(from, data, size, MSG_WAITALL) != (ssize_t)size ||
+      send(to, data, size, MSG_NOSIGNAL) != (ssize_t)size)
+    return -1;
+  return 0;
+}
+
+// move bytes from in to out until in hits eof. they go through a pipe with
+// splice, so the router never copies them into user space.
+void splice_loop(const int in, const int out) {
+  int pipefd[2];
+  ssize_t n = -1;
+
+  if (pipe2(pipefd, O_CLOEXEC) < 0)
+    goto ERROR_0;
+  // a bigger pipe lets one splice carry a whole large copy. if it can't be
+  // resized the default still works, a page at a time.
+  fcntl(pipefd[1], F_SETPIPE_SZ, PIPE_SIZE);
+
+  while (1) {
+    n = splice(in, NULL, pipefd[1], NULL, PIPE_SIZE, SPLICE_F_MOVE);
+    if (n <= 0)
+      break;
+    while (n > 0) {
+      ssize_t written = splice(pipefd[0], NULL, out, NULL, n, SPLICE_F_MOVE);
+      if (written <= 0)
+        goto ERROR_1;
+      n -= written;
+    }
+  }
+
+ERROR_1:
+  close(pipefd[0]);
+  close(pipefd[1]);
+ERROR_0:
+  // pass an eof on so the peer winds down; on an error, tear down both
+  // directions.
+  if (n == 0) {
+    shutdown(out, SHUT_WR);
+  } else {
+    shutdown(in, SHUT_RDWR);
+    shutdown(out, SHUT_RDWR);
+  }
+}
+
+// proxy a connection in both directions until both sides are done.
+void proxy(const int connfd, const int backendfd) {
+  std::thread response_thread(splice_loop, backendfd, connfd);
+  splice_loop(connfd, backendfd);
+  response_thread.join();
+}
+
+// a data connection goes to the backend its primary connection is on.
+void data_handler(const int connfd) {
+  uint64_t session_id;
+  int stripe;
+  int backend = -1;
+  int request_id = DATA_REQUEST_ID;
+
+  if (recv(connfd, &session_id, sizeof(uint64_t), MSG_WAITALL) !=
+          sizeof(uint64_t) ||
+      recv(connfd, &stripe, sizeof(int), MSG_WAITALL) != sizeof(int)) {
+    close(connfd);
+    return;
+  }
+
+  // the client opens its data connections right after sending the session
+  // id, so this normally only waits for the primary's thread to catch up.
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += DATA_WAIT_SEC;
+  pthread_mutex_lock(&sessions_mutex);
+  while (sessions.find(session_id) == sessions.end() &&
+         pthread_cond_timedwait(&sessions_cond, &sessions_mutex, &deadline) !=
+             ETIMEDOUT)
+    ;
+  if (sessions.find(session_id) != sessions.end())
+    backend = sessions[session_id];
+  pthread_mutex_unlock(&sessions_mutex);
+
+  if (backend < 0) {
+    std::cerr << "Data connection for an unknown session." << std::endl;
+    close(connfd);
+    return;
+  }
+
+  struct iovec request[3] = {{&request_id, sizeof(int)},
+                             {&session_id, sizeof(uint64_t)},
+                             {&stripe, sizeof(int)}};
+  int backendfd = backend_connect(&backends[backend]);
+  if (backendfd < 0 || writev(backendfd, request, 3) < 0) {
+    std::cerr << "Connecting data connection to " << backends[backend].name
+              << " failed: " << strerror(errno) << std::endl;
+    if (backendfd >= 0)
+      close(backendfd);
+    close(connfd);
+    return;
+  }
+
+  proxy(connfd, backendfd);
+  close(backendfd);
+  close(connfd);
+}
+
+void client_handler(const int connfd) {
+  int request_id;
+  uint64_t session_id;
+  bool has_session = false;
+
+  if (recv(connfd, &request_id, sizeof(int), MSG_WAITALL) != sizeof(int)) {
+    close(connfd);
+    return;
+  }
+  if (request_id == DATA_REQUEST_ID) {
+    data_handler(connfd);
+    return;
+  }
+
+  int backend = place_session();
+  if (backend < 0) {
+    std::cerr << "No backend available for a new session." << std::endl;
+    close(connfd);
+    return;
+  }
+
+  int backendfd = backend_connect(&backends[backend]);
+  if (backendfd < 0) {
+    std::cerr << "Connecting to " << backends[backend].name
+              << " failed: " << strerror(errno) << std::endl;
+    end_session(backend);
+    close(connfd);
+    return;
+  }
+
+  // responses can flow as soon as the backend is connected; the client waits
+  // for the answer to its COMPRESS message before it goes on.
+  std::thread response_thread(splice_loop, backendfd, connfd);
+
+  // the client may open with COMPRESS and then SESSION. both are passed on,
+  // noting the session id; the first ordinary request ends the handshake and
+  // the rest of the connection is spliced.
+  if (send(backendfd, &request_id, sizeof(int), MSG_NOSIGNAL) != sizeof(int))
+    goto ERROR_0;
+  while (request_id == COMPRESS_REQUEST_ID ||
+         request_id == SESSION_REQUEST_ID) {
+    if (request_id == COMPRESS_REQUEST_ID) {
+      char compress[sizeof(int) + sizeof(uint64_t)];
+      if (forward(connfd, backendfd, compress, sizeof(compress)) < 0)
+        goto ERROR_0;
+    } else {
+      if (forward(connfd, backendfd, &session_id, sizeof(uint64_t)) < 0)
+        goto ERROR_0;
+      pthread_mutex_lock(&sessions_mutex);
+      sessions[session_id] = backend;
+      has_session = true;
+      pthread_cond_broadcast(&sessions_cond);
+      pthread_mutex_unlock(&sessions_mutex);
+    }
+
+    if (forward(connfd, backendfd, &request_id, sizeof(int)) < 0)
+      goto ERROR_0;
+  }
+
+  splice_loop(connfd, backendfd);
+  goto DONE;
+
+ERROR_0:
+  shutdown(connfd, SHUT_RDWR);
+  shutdown(backendfd, SHUT_RDWR);
+DONE:
+  response_thread.join();
+  if (has_session) {
+    pthread_mutex_lock(&sessions_mutex);
+    sessions.erase(session_id);
+    pthread_mutex_unlock(&sessions_mutex);
+  }
+  end_session(backend);
+  close(backendfd);
+  close(connfd);
+}
+
+// one command per connection on the control socket:
+//   drain <host:port>   stop placing new sessions on a backend
+//   resume <host:port>  start placing them again
+//   status              one line per backend
+std::string control_command(const std::string &line) {
+  size_t space = line.find(' ');
+  std::string command = line.substr(0, space);
+  std::string name = space == std::string::npos ? "" : line.substr(space + 1);
+  std::string reply;
+
+  pthread_mutex_lock(&backends_mutex);
+  if (command == "status") {
+    for (const backend_t &backend : backends) {
+      char status[256];
+      snprintf(status, sizeof(status),
+               "%s %s%s sessions=%d devices=%u memory=%llu/%lluMiB "
+               "utilization=%u%% load=%.1f\n",
+               backend.name.c_str(), backend.up ? "up" : "down",
+               backend.draining ? " draining" : "", backend.sessions,
+               backend.devices, backend.memory_used >> 20,
+               backend.memory_total >> 20, backend.utilization, backend.load);
+      reply += status;
+    }
+  } else if (command == "drain" || command == "resume") {
+    reply = "unknown backend " + name + "\n";
+    for (backend_t &backend : backends) {
+      if (backend.name != name)
+        continue;
+      backend.draining = command == "drain";
+      // once this reaches 0 the backend can be taken down.
+      reply = "ok sessions=" + std::to_string(backend.sessions) + "\n";
+      printf("Backend %s %s.\n", name.c_str(),
+             backend.draining ? "draining" : "resumed");
+    }
+  } else {
+    reply = "unknown command " + command + "\n";
+  }
+  pthread_mutex_unlock(&backends_mutex);
+  return reply;
+}
+
+void control_listener(const std::string path) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (sockfd == -1 ||
+      bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(sockfd, MAX_CLIENTS) != 0) {
+    std::cerr << "Listening on " << path << " failed: " << strerror(errno)
+              << std::endl;
+    return;
+  }
+
+  printf("Router control socket on %s...\n", path.c_str());
+
+  while (1) {
+    int connfd = accept(sockfd, NULL, NULL);
+    if (connfd < 0)
+      continue;
+
+    std::string line;
+    char c;
+    while (line.size() < 256 && recv(connfd, &c, 1, 0) == 1 && c != '\n')
+      line += c;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    std::string reply = control_command(line);
+    send(connfd, reply.c_str(), reply.size(), MSG_NOSIGNAL);
+    close(connfd);
+  }
+}
+
+int main() {
+  int port = DEFAULT_PORT;
+  struct sockaddr_in servaddr;
+
+  // a client or backend going away mid-write shows up as an error from
+  // splice or send instead.
+  signal(SIGPIPE, SIG_IGN);
+
+  // SCUDA_BACKENDS is a comma-separated list of host[:port] servers.
+  char *p = getenv("SCUDA_BACKENDS");
+  if (p == NULL) {
+    std::cerr << "SCUDA_BACKENDS is not set." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  char *list = strdup(p);
+  char *entry;
+  while ((entry = strsep(&list, ","))) {
+    if (*entry == '\0')
+      continue;
+    backend_t backend = {};
+    backend.name = entry;
+    backend.host = entry;
+    backend.port = std::to_string(DEFAULT_PORT);
+    size_t colon = backend.name.rfind(':');
+    if (colon != std::string::npos) {
+      backend.host = backend.name.substr(0, colon);
+      backend.port = backend.name.substr(colon + 1);
+    } else {
+      backend.name += ":" + backend.port;
+    }
+    backend.probe_fd = -1;
+    backends.push_back(backend);
+  }
+  if (backends.empty()) {
+    std::cerr << "SCUDA_BACKENDS has no servers." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  p = getenv("SCUDA_PORT");
+  if (p != NULL)
+    port = atoi(p);
+
+  p = getenv("SCUDA_ROUTER_POLL_MSEC");
+  if (p != NULL && atoi(p) > 0)
+    poll_msec = atoi(p);
+
+  // poll every backend once before taking clients, so the first sessions
+  // aren't turned away for lack of a backend that is up.
+  for (int i = 0; i < (int)backends.size(); i++) {
+    if (probe_backend(&backends[i]) < 0) {
+      std::cerr << "Backend " << backends[i].name << " is down." << std::endl;
+      if (backends[i].probe_fd >= 0)
+        close(backends[i].probe_fd);
+      backends[i].probe_fd = -1;
+    }
+    std::thread poll_thread(poll_loop, i);
+    poll_thread.detach();
+  }
+
+  // set SCUDA_ROUTER_CONTROL to move the control socket, or to an empty
+  // string to turn it off.
+  p = getenv("SCUDA_ROUTER_CONTROL");
+  std::string control_path = p != NULL ? p : "/tmp/scuda-router.sock";
+  if (!control_path.empty()) {
+    std::thread control_thread(control_listener, control_path);
+    control_thread.detach();
+  }
+
+  int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sockfd == -1) {
+    printf("Socket creation failed.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  memset(&servaddr, 0, sizeof(servaddr));
+  servaddr.sin_family = AF_INET;
+  servaddr.sin_addr.s_addr = INADDR_ANY;
+  servaddr.sin_port = htons(port);
+
+  const int enable = 1;
+  if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) < 0 ||
+      bind(sockfd, (struct sockaddr *)&servaddr, sizeof(servaddr)) != 0) {
+    printf("Socket bind failed.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (listen(sockfd, MAX_CLIENTS) != 0) {
+    printf("Listen failed.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("Router listening on port %d with %zu backends...\n", port,
+         backends.size());
+
+  while (1) {
+    int connfd = accept(sockfd, NULL, NULL);
+    if (connfd < 0) {
+      std::cerr << "Router accept failed." << std::endl;
+      continue;
+    }
+
+    int flag = 1;
+    setsockopt(connfd, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(int));
+
+    std::thread client_thread(client_handler, connfd);
+    client_thread.detach();
+  }
+
+  close(sockfd);
+  return 0;
+}
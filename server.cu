@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <arpa/inet.h>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <future>
 #include <iostream>
@@ -9,31 +12,744 @@
 #include <pthread.h>
 #include <stdio.h>
 #include <string>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
+#include <sys/un.h>
 #include <thread>
 #include <unistd.h>
 #include <unordered_map>
+#include <vector>
 
+#include "arena.h"
+#include "codegen/gen_api.h"
 #include "codegen/gen_server.h"
+#include "codegen/manual_server.h"
+#include "compress.h"
+#include "transport.h"
+#include "virtual_handle.h"
 
 #define DEFAULT_PORT 14833
-#define MAX_CLIENTS 10
+// listen backlog, so a burst of clients connecting at once isn't turned away.
+#define MAX_CLIENTS SOMAXCONN
+
+// request id the client uses to send a batch of requests in one frame.
+#define BATCH_REQUEST_ID -1
+
+// request ids that tie a client's data connections to its primary connection.
+// see rpc_connect_data in client.cpp.
+#define SESSION_REQUEST_ID -2
+#define DATA_REQUEST_ID -3
+
+// request id the client uses to ask for compressed payloads. see
+// rpc_negotiate_compression in client.cpp.
+#define COMPRESS_REQUEST_ID -4
+
+// request id that opens a connection which only polls the server's gpus
+// through nvml, such as scuda-router's. it isn't given devices, so it sees the
+// server's own numbering and doesn't count towards any device's load.
+#define PROBE_REQUEST_ID -5
+
+// responses of at least this many bytes are sent with MSG_ZEROCOPY,
+// overridable with SCUDA_ZEROCOPY_SIZE (0 disables zero-copy sends).
+size_t zerocopy_size = 1024 * 1024;
+
+// number of epoll reactor threads that watch all tcp and unix socket clients,
+// set with SCUDA_REACTOR_THREADS, and of the worker threads that serve their
+// requests, set with SCUDA_WORKER_THREADS. 0 reactor threads gives every
+// client a thread of its own instead.
+int reactor_threads = 1;
+int worker_threads = 8;
+std::vector<int> reactors;
+
+// requests a worker serves from one client before going on to the next.
+#define WORKER_BATCH 32
+
+// the thread serving a client reads the socket itself, up to this many bytes
+// at a time. reads at least this big skip the buffer.
+#define RECV_BUFFER_SIZE (64 * 1024)
+
+// how clients are given devices, set with SCUDA_DEVICE_POLICY:
+// "least-loaded" orders them by utilization, memory in use and the clients
+// already on them, "round-robin" starts each client one device further on and
+// "fixed" gives every client the server's own order. SCUDA_CLIENT_DEVICES caps
+// how many devices a client sees, 0 for all of them.
+#define DEVICE_POLICY_LEAST_LOADED 0
+#define DEVICE_POLICY_ROUND_ROBIN 1
+#define DEVICE_POLICY_FIXED 2
+int device_policy = DEVICE_POLICY_LEAST_LOADED;
+int client_devices = 0;
+
+// load added to a device for each client that starts out on it, since
+// utilization only catches up once the client gets going.
+#define DEVICE_CLIENT_PENALTY 10.0
+
+// executor threads per client that finish calls blocking on a stream or
+// event, set with SCUDA_STREAM_EXECUTORS. 0 runs them on the client's handler
+// thread, which then waits for the stream before reading the next request.
+// an executor's thread exits once it has been idle this long, and is started
+// again by the next job.
+int stream_executors = 4;
+#define EXECUTOR_IDLE_SEC 5
 
 typedef struct {
-  int connfd;
+  // the device current on the handler thread when the job was queued.
+  int device;
+  std::function<int()> run;
+} job_t;
+
+// runs the jobs for the streams that hash to it, in order.
+typedef struct {
+  std::thread thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  std::deque<job_t> jobs;
+  bool busy;
+  bool running;
+  bool stopping;
+} executor_t;
+
+typedef struct conn_t conn_t;
+
+// serves the requests of the clients assigned to it, one client at a time.
+// a client stays on one worker, as some of the __cuda* functions assume that
+// they run on the thread that calls cudaLaunchKernel.
+typedef struct {
+  std::thread thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  // clients whose socket the reactor found readable.
+  std::deque<conn_t *> ready;
+  int clients;
+} worker_t;
+
+std::vector<worker_t *> workers;
+pthread_mutex_t workers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+struct conn_t {
+  transport_t transport;
   int read_request_id;
   int write_request_id;
   pthread_mutex_t read_mutex, write_mutex;
   struct iovec write_iov[128];
   int write_iov_count = 0;
-} conn_t;
+  // pieces of write_iov that may go out with MSG_ZEROCOPY. only buffers that
+  // take a ticket before they are reused qualify; see rpc_write_payload.
+  bool write_zerocopy[128];
+  // set by the handler thread and picked up by sync points, which may finish
+  // on an executor. deferred_request_id is the request that failed, so a sync
+  // point only reports errors from requests sent before it.
+  pthread_mutex_t deferred_mutex;
+  int deferred_error = 0;
+  int deferred_request_id;
+
+  // the batch frame currently being unpacked; requests are read from it
+  // before going back to the socket.
+  std::vector<char> batch;
+  size_t batch_offset = 0;
+
+  // set if the client opened data connections for striped transfers.
+  uint64_t session_id = 0;
+
+  // codec the client asked for and the smallest payload it applies to.
+  int compress = COMPRESS_NONE;
+  size_t compress_size = 0;
+  uint32_t compress_header;
+  std::vector<char> compress_buf;
+  // responses may be written by an executor while the handler thread reads
+  // the next request, so they compress into buffers of their own. chunks
+  // alternate between the two, so one can be compressed into while the
+  // kernel may still be sending the other with MSG_ZEROCOPY.
+  std::vector<char> compress_out[2];
+  uint32_t compress_out_ticket[2];
+  int compress_out_next = 0;
+
+  // progress through payloads read or written in pieces. read_payload_left
+  // counts the bytes not yet taken off the wire, and decompressed holds what
+  // the last piece left over of a compressed chunk.
+  size_t read_payload_left = 0;
+  bool read_payload_compressed = false;
+  bool read_payload_stored = false;
+  std::vector<char> decompressed;
+  size_t decompressed_offset = 0;
+  bool write_payload_compressed = false;
+  bool write_payload_stored = false;
+
+  // scratch memory for the request being handled, reset once its handler
+  // returns. see rpc_arena_alloc.
+  arena_t arena;
+
+  // the server's devices in the order the client numbers them, set before
+  // its first request. see assign_devices.
+  bool devices_assigned = false;
+  std::vector<int> devices;
+
+  // started on first use. see rpc_run_on_stream.
+  std::vector<executor_t *> executors;
+
+  // the client's names for the streams, events and library handles it
+  // created, and the objects they stand for. only the handler thread uses
+  // these. see rpc_real_handle.
+  std::unordered_map<const void *, const void *> handles;
+  std::unordered_map<const void *, const void *> virtual_handles;
+
+  // bytes read ahead of the handler, so the small fields of one or more
+  // requests cost one recv instead of one each. only primary connections
+  // read ahead; a data connection's first bytes belong to its session.
+  bool recv_buffered = false;
+  std::vector<char> recv_buf;
+  size_t recv_offset = 0;
+  size_t recv_end = 0;
+
+  // with a reactor, the reactor waits for the socket to become readable and
+  // hands the client to its worker, which reads and serves what has arrived.
+  // the worker keeps the client's current device and capture mode here while
+  // it serves other clients.
+  int reactor = -1;
+  worker_t *worker = NULL;
+  int device = -1;
+  cudaStreamCaptureMode capture_mode = cudaStreamCaptureModeGlobal;
+};
+
+// (re)arm the reactor for the next time the socket becomes readable.
+// one-shot keeps a client on its worker's queue at most once.
+int reactor_arm(conn_t *conn, const int op) {
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = conn;
+  return epoll_ctl(conn->reactor, op, conn->transport.fd, &event);
+}
+
+// hand each client whose socket became readable to its worker. the reactor
+// reads nothing itself; the worker reads straight from the socket.
+void reactor_loop(const int epfd) {
+  struct epoll_event events[64];
+
+  while (1) {
+    int n = epoll_wait(epfd, events, 64, -1);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "Error waiting on reactor." << std::endl;
+      return;
+    }
+
+    for (int i = 0; i < n; i++) {
+      conn_t *conn = (conn_t *)events[i].data.ptr;
+      worker_t *worker = conn->worker;
+      pthread_mutex_lock(&worker->mutex);
+      worker->ready.push_back(conn);
+      pthread_cond_signal(&worker->cond);
+      pthread_mutex_unlock(&worker->mutex);
+    }
+  }
+}
+
+// put a new client on a reactor, and on the worker with the fewest clients.
+int reactor_add(conn_t *conn) {
+  static int next_reactor = 0;
+  conn->reactor = reactors[__sync_fetch_and_add(&next_reactor, 1) %
+                           reactors.size()];
+
+  pthread_mutex_lock(&workers_mutex);
+  for (worker_t *worker : workers)
+    if (conn->worker == NULL || worker->clients < conn->worker->clients)
+      conn->worker = worker;
+  conn->worker->clients++;
+  pthread_mutex_unlock(&workers_mutex);
+  return reactor_arm(conn, EPOLL_CTL_ADD);
+}
+
+// called by the client's worker, so the reactor has let go of conn: it was
+// disarmed when it handed conn over.
+void reactor_remove(conn_t *conn) {
+  epoll_ctl(conn->reactor, EPOLL_CTL_DEL, conn->transport.fd, NULL);
+  conn->reactor = -1;
+  pthread_mutex_lock(&workers_mutex);
+  conn->worker->clients--;
+  pthread_mutex_unlock(&workers_mutex);
+}
+
+// serve a read from the bytes already read ahead, then refill them with
+// whatever the socket has. large reads go straight into data once the buffer
+// is drained.
+int conn_recv_buffered(conn_t *conn, void *data, const size_t size) {
+  size_t copied = 0;
+  while (copied < size) {
+    if (conn->recv_offset == conn->recv_end) {
+      if (size - copied >= RECV_BUFFER_SIZE) {
+        ssize_t n = transport_read(&conn->transport, (char *)data + copied,
+                                   size - copied);
+        if (n < 0)
+          return -1;
+        return copied + n;
+      }
+
+      ssize_t n = recv(conn->transport.fd, conn->recv_buf.data(),
+                       conn->recv_buf.size(), 0);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        return -1;
+      if (n == 0)
+        break;
+      conn->recv_offset = 0;
+      conn->recv_end = n;
+    }
+
+    size_t n = std::min(size - copied, conn->recv_end - conn->recv_offset);
+    memcpy((char *)data + copied, conn->recv_buf.data() + conn->recv_offset,
+           n);
+    conn->recv_offset += n;
+    copied += n;
+  }
+  return copied;
+}
+
+// read from the client's socket, through the read-ahead buffer once there is
+// one. like recv with MSG_WAITALL, returns less than size only at eof.
+int conn_recv(conn_t *conn, void *data, const size_t size) {
+  if (conn->recv_buffered)
+    return conn_recv_buffered(conn, data, size);
+  return transport_read(&conn->transport, data, size);
+}
+
+// whether the next request has already been read off the socket, in which
+// case the reactor won't report it.
+bool conn_buffered(const conn_t *conn) {
+  return conn->batch_offset < conn->batch.size() ||
+         conn->recv_offset < conn->recv_end;
+}
+
+// data connections by session id, indexed by stripe. they are read and written
+// only by the handler thread of the session's primary connection.
+pthread_mutex_t data_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t data_cond = PTHREAD_COND_INITIALIZER;
+std::unordered_map<uint64_t, std::vector<int>> data_connections;
+
+int attach_data_connection(conn_t *conn) {
+  uint64_t session_id;
+  int stripe;
+  if (transport_read(&conn->transport, &session_id, sizeof(uint64_t)) < 0 ||
+      transport_read(&conn->transport, &stripe, sizeof(int)) < 0 ||
+      stripe < 0 || pthread_mutex_lock(&data_mutex) < 0)
+    return -1;
+
+  std::vector<int> &fds = data_connections[session_id];
+  if (fds.size() <= stripe)
+    fds.resize(stripe + 1, -1);
+  fds[stripe] = conn->transport.fd;
+
+  if (pthread_cond_broadcast(&data_cond) < 0 ||
+      pthread_mutex_unlock(&data_mutex) < 0)
+    return -1;
+  return 0;
+}
+
+// the client opens its data connections before sending any request, but they
+// are accepted on other threads, so wait for them to be attached.
+std::vector<int> get_data_connections(const conn_t *conn, const int stripes) {
+  std::vector<int> fds;
+  if (conn->session_id == 0 || pthread_mutex_lock(&data_mutex) < 0)
+    return fds;
+  while (true) {
+    std::vector<int> &attached = data_connections[conn->session_id];
+    int ready = 0;
+    while (ready < stripes && ready < attached.size() && attached[ready] >= 0)
+      ready++;
+    if (ready == stripes) {
+      fds.assign(attached.begin(), attached.begin() + stripes);
+      break;
+    }
+    pthread_cond_wait(&data_cond, &data_mutex);
+  }
+  pthread_mutex_unlock(&data_mutex);
+  return fds;
+}
+
+void close_data_connections(const conn_t *conn) {
+  if (conn->session_id == 0 || pthread_mutex_lock(&data_mutex) < 0)
+    return;
+  auto found = data_connections.find(conn->session_id);
+  if (found != data_connections.end()) {
+    for (int fd : found->second)
+      if (fd >= 0)
+        close(fd);
+    data_connections.erase(found);
+  }
+  pthread_mutex_unlock(&data_mutex);
+}
+
+// the server's devices, found in main. nvml is only used to weigh them, so a
+// device nvml doesn't know about gets a NULL handle and counts as idle.
+int device_count = 0;
+std::vector<nvmlDevice_t> device_handles;
+// clients whose first device each one is.
+std::vector<int> device_clients;
+int device_next = 0;
+pthread_mutex_t devices_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void init_devices() {
+  if (cudaGetDeviceCount(&device_count) != cudaSuccess)
+    device_count = 0;
+  device_clients.assign(device_count, 0);
+  device_handles.assign(device_count, NULL);
+
+  // match by pci bus id, since nvml and cuda may number devices differently.
+  if (nvmlInit_v2() != NVML_SUCCESS)
+    return;
+  for (int i = 0; i < device_count; i++) {
+    char bus_id[32];
+    if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), i) != cudaSuccess ||
+        nvmlDeviceGetHandleByPciBusId_v2(bus_id, &device_handles[i]) !=
+            NVML_SUCCESS)
+      device_handles[i] = NULL;
+  }
+}
+
+// called with devices_mutex held.
+double device_load(const int device) {
+  double load = DEVICE_CLIENT_PENALTY * device_clients[device];
+  nvmlUtilization_t rates;
+  nvmlMemory_t memory;
+  if (device_handles[device] != NULL &&
+      nvmlDeviceGetUtilizationRates(device_handles[device], &rates) ==
+          NVML_SUCCESS &&
+      nvmlDeviceGetMemoryInfo(device_handles[device], &memory) ==
+          NVML_SUCCESS &&
+      memory.total > 0)
+    load += rates.gpu + 100.0 * memory.used / memory.total;
+  return load;
+}
+
+// pick the devices a new client sees and make the first one current on its
+// handler thread, where the client's calls run until it picks another.
+int assign_devices(conn_t *conn) {
+  conn->devices_assigned = true;
+  if (device_count == 0)
+    return 0;
+
+  std::vector<int> order(device_count);
+  std::vector<double> loads(device_count);
+  if (pthread_mutex_lock(&devices_mutex) < 0)
+    return -1;
+  for (int i = 0; i < device_count; i++) {
+    order[i] = device_policy == DEVICE_POLICY_ROUND_ROBIN
+                   ? (device_next + i) % device_count
+                   : i;
+    if (device_policy == DEVICE_POLICY_LEAST_LOADED)
+      loads[i] = device_load(i);
+  }
+  device_next++;
+  if (device_policy == DEVICE_POLICY_LEAST_LOADED)
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return loads[a] < loads[b]; });
+
+  int n = client_devices > 0 && client_devices < device_count ? client_devices
+                                                              : device_count;
+  conn->devices.assign(order.begin(), order.begin() + n);
+  device_clients[conn->devices[0]]++;
+  if (pthread_mutex_unlock(&devices_mutex) < 0)
+    return -1;
+
+#ifdef VERBOSE
+  printf("Client starts on device %d.\n", conn->devices[0]);
+#endif
+  if (cudaSetDevice(conn->devices[0]) != cudaSuccess)
+    return -1;
+  return 0;
+}
+
+void release_devices(const conn_t *conn) {
+  if (conn->devices.empty() || pthread_mutex_lock(&devices_mutex) < 0)
+    return;
+  device_clients[conn->devices[0]]--;
+  pthread_mutex_unlock(&devices_mutex);
+}
+
+// the client numbers the devices it was given from 0. handlers translate
+// every device ordinal they pass on or hand back. a connection without devices,
+// a probe or one to a server without gpus, keeps the server's numbering.
+int rpc_server_device(const void *conn, const int device) {
+  const std::vector<int> &devices = ((conn_t *)conn)->devices;
+  // cudaCpuDeviceId and the like, or a server without devices.
+  if (device < 0 || devices.empty())
+    return device;
+  if (device < (int)devices.size())
+    return devices[device];
+  // still out of range, so the call fails the way it would for the client.
+  return device_count + device;
+}
+
+int rpc_client_device(const void *conn, const int device) {
+  const std::vector<int> &devices = ((conn_t *)conn)->devices;
+  if (device < 0 || devices.empty())
+    return device;
+  for (int i = 0; i < (int)devices.size(); i++)
+    if (devices[i] == device)
+      return i;
+  return -1;
+}
+
+// count is what the server itself reported.
+int rpc_client_device_count(const void *conn, const int count) {
+  const std::vector<int> &devices = ((conn_t *)conn)->devices;
+  if (devices.empty())
+    return count;
+  return devices.size();
+}
+
+// a create is answered before it runs, so the client names the new handle
+// itself and handlers look up what the name stands for. handles the client
+// didn't name, such as the legacy stream, pass through. a name whose create
+// failed becomes null, and the failure is reported at the next sync point.
+const void *rpc_real_handle(const void *conn, const void *handle) {
+  if (!((uintptr_t)handle & VIRTUAL_HANDLE_BIT))
+    return handle;
+  conn_t *c = (conn_t *)conn;
+  auto it = c->handles.find(handle);
+  if (it == c->handles.end())
+    return nullptr;
+  return it->second;
+}
+
+void rpc_map_handle(const void *conn, const void *handle, const void *real) {
+  conn_t *c = (conn_t *)conn;
+  c->handles[handle] = real;
+  c->virtual_handles[real] = handle;
+}
+
+const void *rpc_unmap_handle(const void *conn, const void *handle) {
+  conn_t *c = (conn_t *)conn;
+  const void *real = rpc_real_handle(conn, handle);
+  if (c->handles.erase(handle) > 0)
+    c->virtual_handles.erase(real);
+  return real;
+}
+
+// the client's name for a handle a call hands back, e.g. a library's stream.
+const void *rpc_virtual_handle(const void *conn, const void *real) {
+  conn_t *c = (conn_t *)conn;
+  auto it = c->virtual_handles.find(real);
+  if (it == c->virtual_handles.end())
+    return real;
+  return it->second;
+}
+
+void executor_loop(executor_t *executor) {
+  int device = -1;
+
+  pthread_mutex_lock(&executor->mutex);
+  while (1) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += EXECUTOR_IDLE_SEC;
+    int timedout = 0;
+    while (executor->jobs.empty() && !executor->stopping && timedout == 0)
+      timedout =
+          pthread_cond_timedwait(&executor->cond, &executor->mutex, &deadline);
+    if (executor->jobs.empty())
+      break;
+
+    job_t job = std::move(executor->jobs.front());
+    executor->jobs.pop_front();
+    executor->busy = true;
+    pthread_mutex_unlock(&executor->mutex);
+
+    if (job.device != device && cudaSetDevice(job.device) == cudaSuccess)
+      device = job.device;
+    if (job.run() < 0)
+      std::cerr << "Error handling request." << std::endl;
+
+    pthread_mutex_lock(&executor->mutex);
+    executor->busy = false;
+    pthread_cond_broadcast(&executor->cond);
+  }
+  executor->running = false;
+  pthread_mutex_unlock(&executor->mutex);
+}
+
+// the threads start with the first job queued on each executor.
+int start_executors(conn_t *conn) {
+  for (int i = 0; i < stream_executors; i++) {
+    executor_t *executor = new executor_t();
+    if (pthread_mutex_init(&executor->mutex, NULL) < 0 ||
+        pthread_cond_init(&executor->cond, NULL) < 0) {
+      delete executor;
+      return -1;
+    }
+    conn->executors.push_back(executor);
+  }
+  return 0;
+}
+
+// wait until every job queued so far is done.
+void wait_executors(const conn_t *conn) {
+  for (executor_t *executor : conn->executors) {
+    pthread_mutex_lock(&executor->mutex);
+    while (!executor->jobs.empty() || executor->busy)
+      pthread_cond_wait(&executor->cond, &executor->mutex);
+    pthread_mutex_unlock(&executor->mutex);
+  }
+}
+
+// finish the queued jobs, which may still write responses, and stop.
+void stop_executors(conn_t *conn) {
+  for (executor_t *executor : conn->executors) {
+    pthread_mutex_lock(&executor->mutex);
+    executor->stopping = true;
+    pthread_cond_broadcast(&executor->cond);
+    pthread_mutex_unlock(&executor->mutex);
+    if (executor->thread.joinable())
+      executor->thread.join();
+    pthread_mutex_destroy(&executor->mutex);
+    pthread_cond_destroy(&executor->cond);
+    delete executor;
+  }
+  conn->executors.clear();
+}
+
+// finish a request that has been read but blocks on stream, such as a
+// cudaStreamSynchronize or the wait before sending a device to host copy
+// back. job sends the response. it runs on the executor stream hashes to, so
+// requests on one stream still complete in order while the handler thread
+// goes on with the next request. job must not use the request arena. it runs
+// exactly once, right here if there are no executors.
+int rpc_run_on_stream(const void *conn, const void *stream,
+                      std::function<int()> job) {
+  conn_t *c = (conn_t *)conn;
+  if (stream_executors <= 0 ||
+      (c->executors.empty() && start_executors(c) < 0))
+    return job();
+
+  // fibonacci hashing spreads the handles, which are aligned, over the
+  // executors.
+  uint64_t hash = (uint64_t)(uintptr_t)stream * 0x9e3779b97f4a7c15ULL;
+  executor_t *executor = c->executors[(hash >> 32) % c->executors.size()];
+
+  job_t queued;
+  if (cudaGetDevice(&queued.device) != cudaSuccess)
+    queued.device = -1;
+  queued.run = std::move(job);
+
+  pthread_mutex_lock(&executor->mutex);
+  executor->jobs.push_back(std::move(queued));
+  bool start = !executor->running;
+  executor->running = true;
+  pthread_cond_signal(&executor->cond);
+  pthread_mutex_unlock(&executor->mutex);
+
+  // only this thread starts executors, so the one that timed out is done
+  // with executor once it has been joined.
+  if (start) {
+    if (executor->thread.joinable())
+      executor->thread.join();
+    executor->thread = std::thread(executor_loop, executor);
+  }
+  return 0;
+}
+
+// calls that wait for the executors first: those that destroy or free what a
+// queued job may be using, that act on the whole device, or that the runtime
+// orders after all earlier work. the last are the synchronous copies, which
+// wait on the legacy default stream and so on every blocking stream, and
+// stream and event queries, which must see the waits queued before them.
+// cudaGetLastError comes from the client only to collect deferred errors.
+bool is_barrier(const unsigned int op) {
+  switch (op) {
+  case RPC_cuCtxSynchronize:
+  case RPC_cuStreamDestroy_v2:
+  case RPC_cuEventDestroy_v2:
+  case RPC_cudaDeviceReset:
+  case RPC_cudaDeviceSynchronize:
+  case RPC_cudaThreadSynchronize:
+  case RPC_cudaStreamDestroy:
+  case RPC_cudaEventDestroy:
+  // frees, which the runtime also makes synchronize the device.
+  case RPC_cudaFree:
+  case RPC_cudaFreeHost:
+  case RPC_cudaFreeArray:
+  case RPC_cudaFreeMipmappedArray:
+  case RPC_cuMemFree_v2:
+  case RPC_cuMemFreeHost:
+  case RPC___scudaFreeBatch:
+  // synchronous copies.
+  case RPC_cudaMemcpy:
+  case RPC_cudaMemcpy2DToArray:
+  case RPC_cudaMemcpy2DArrayToArray:
+  case RPC_cudaMemcpy3D:
+  case RPC_cudaMemcpy3DPeer:
+  case RPC_cudaMemcpyArrayToArray:
+  case RPC_cudaMemcpyToArray:
+  case RPC_cudaMemcpyToSymbol:
+  case RPC_cuMemcpy:
+  case RPC_cuMemcpy2D_v2:
+  case RPC_cuMemcpy2DUnaligned_v2:
+  case RPC_cuMemcpy3D_v2:
+  case RPC_cuMemcpy3DPeer:
+  case RPC_cuMemcpyAtoA_v2:
+  case RPC_cuMemcpyAtoD_v2:
+  case RPC_cuMemcpyAtoH_v2:
+  case RPC_cuMemcpyDtoA_v2:
+  case RPC_cuMemcpyDtoD_v2:
+  case RPC_cuMemcpyHtoA_v2:
+  case RPC_cuMemcpyHtoD_v2:
+  case RPC_cuMemcpyPeer:
+  // queries.
+  case RPC_cudaStreamQuery:
+  case RPC_cudaEventQuery:
+  case RPC_cuStreamQuery:
+  case RPC_cuEventQuery:
+  // the client's cudaGetLastError, which collects the errors of the jobs.
+  case RPC_cudaGetLastError:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int rpc_read(const void *conn, void *data, size_t size);
+
+// read a whole batch frame so the requests in it can be served from memory.
+int read_batch(conn_t *conn) {
+  size_t length;
+  if (rpc_read(conn, &length, sizeof(size_t)) < 0)
+    return -1;
+  conn->batch.resize(length);
+  conn->batch_offset = 0;
+  if (conn_recv(conn, conn->batch.data(), length) < 0 ||
+      pthread_mutex_unlock(&conn->read_mutex) < 0)
+    return -1;
+  return 0;
+}
+
+// agree to compress large payloads if we know the codec the client asked for.
+int negotiate_compression(conn_t *conn) {
+  int codec;
+  uint64_t size;
+  if (rpc_read(conn, &codec, sizeof(int)) < 0 ||
+      rpc_read(conn, &size, sizeof(uint64_t)) < 0 ||
+      pthread_mutex_unlock(&conn->read_mutex) < 0)
+    return -1;
+
+  conn->compress = codec == COMPRESS_LZ4 ? codec : COMPRESS_NONE;
+  conn->compress_size = size;
+
+  int request_id = COMPRESS_REQUEST_ID;
+  struct iovec reply[2] = {{&request_id, sizeof(int)},
+                           {&conn->compress, sizeof(int)}};
+  if (pthread_mutex_lock(&conn->write_mutex) < 0 ||
+      transport_writev(&conn->transport, reply, 2, 0, NULL) < 0 ||
+      pthread_mutex_unlock(&conn->write_mutex) < 0)
+    return -1;
+  return 0;
+}
 
 int request_handler(const conn_t *conn) {
   unsigned int op;
 
   // Attempt to read the operation code from the client
-  if (read(conn->connfd, &op, sizeof(unsigned int)) < 0)
+  if (rpc_read(conn, &op, sizeof(unsigned int)) < 0)
     return -1;
 
   auto opHandler = get_handler(op);
@@ -43,60 +759,298 @@ int request_handler(const conn_t *conn) {
     return -1;
   }
 
-  return opHandler((void *)conn);
+  if (is_barrier(op))
+    wait_executors(conn);
+
+  int ret = opHandler((void *)conn);
+  arena_reset(&((conn_t *)conn)->arena);
+  return ret;
 }
 
-void client_handler(int connfd) {
-  conn_t conn = {connfd};
-  if (pthread_mutex_init(&conn.read_mutex, NULL) < 0 ||
-      pthread_mutex_init(&conn.write_mutex, NULL) < 0) {
+int conn_open(conn_t *conn, const int connfd, const transport_kind_t kind) {
+  transport_init(&conn->transport, kind, connfd, zerocopy_size);
+  if (pthread_mutex_init(&conn->read_mutex, NULL) < 0 ||
+      pthread_mutex_init(&conn->write_mutex, NULL) < 0 ||
+      pthread_mutex_init(&conn->deferred_mutex, NULL) < 0) {
     std::cerr << "Error initializing mutex." << std::endl;
-    return;
+    return -1;
+  }
+
+  if (kind == TRANSPORT_SHM) {
+    if (shm_accept(&conn->transport.shm, connfd) < 0) {
+      std::cerr << "Error mapping shared memory from client." << std::endl;
+      return -1;
+    }
+    // pin the rings so copies to and from the device can dma straight out
+    // of them. failing that, cuda stages the copies itself. this happens
+    // before the client is given its devices, so pin them for all of them.
+    cudaHostRegister(conn->transport.shm.region,
+                     conn->transport.shm.region_size,
+                     cudaHostRegisterPortable);
   }
 
 #ifdef VERBOSE
   printf("Client connected.\n");
 #endif
+  return 0;
+}
 
-  while (1) {
-    if (pthread_mutex_lock(&conn.read_mutex) < 0) {
-      std::cerr << "Error locking mutex." << std::endl;
-      break;
+// read and serve the next message from the client. returns -1 once the
+// connection is done with, whether the client went away or the socket now
+// belongs to another connection's session.
+int serve_message(conn_t *conn) {
+  if (pthread_mutex_lock(&conn->read_mutex) < 0) {
+    std::cerr << "Error locking mutex." << std::endl;
+    return -1;
+  }
+  int n = rpc_read(conn, &conn->read_request_id, sizeof(int));
+  if (n == 0) {
+    printf("client disconnected, loop continuing. \n");
+    return -1;
+  } else if (n < 0) {
+    printf("error reading from client.\n");
+    return -1;
+  }
+
+  if (conn->read_request_id == SESSION_REQUEST_ID) {
+    if (rpc_read(conn, &conn->session_id, sizeof(uint64_t)) < 0 ||
+        pthread_mutex_unlock(&conn->read_mutex) < 0) {
+      printf("error reading session from client.\n");
+      return -1;
     }
-    int n = read(connfd, &conn.read_request_id, sizeof(int));
-    if (n == 0) {
-      printf("client disconnected, loop continuing. \n");
-      break;
-    } else if (n < 0) {
-      printf("error reading from client.\n");
-      break;
+    return 0;
+  }
+
+  if (conn->read_request_id == PROBE_REQUEST_ID) {
+    conn->devices_assigned = true;
+    if (pthread_mutex_unlock(&conn->read_mutex) < 0)
+      return -1;
+    return 0;
+  }
+
+  if (conn->read_request_id == COMPRESS_REQUEST_ID) {
+    if (negotiate_compression(conn) < 0) {
+      printf("error negotiating compression with client.\n");
+      return -1;
     }
+    return 0;
+  }
 
-    // TODO: this can't be multithreaded as some of the __cuda* functions
-    // assume that they are running in the same thread as the one that
-    // calls cudaLaunchKernel. we'll need to find a better way to map
-    // function calls to threads. maybe each rpc maps to an optional
-    // thread id that is passed to the handler?
-    if (request_handler(&conn) < 0)
-      std::cerr << "Error handling request." << std::endl;
+  // this socket carries striped payloads for another connection; hand it
+  // to that session and stop reading requests from it. the session's
+  // handler reads it directly, so the reactor lets go of it first.
+  if (conn->read_request_id == DATA_REQUEST_ID) {
+    if (conn->reactor >= 0)
+      reactor_remove(conn);
+    if (attach_data_connection(conn) < 0)
+      printf("error attaching data connection.\n");
+    else
+      conn->transport.fd = -1;
+    return -1;
+  }
+
+  // data connections are read directly, so only start reading ahead once
+  // we know it's a primary connection.
+  if (!conn->recv_buffered && conn->transport.kind != TRANSPORT_SHM) {
+    conn->recv_buf.resize(RECV_BUFFER_SIZE);
+    conn->recv_buffered = true;
   }
 
-  if (pthread_mutex_destroy(&conn.read_mutex) < 0 ||
-      pthread_mutex_destroy(&conn.write_mutex) < 0)
+  if (!conn->devices_assigned && assign_devices(conn) < 0) {
+    printf("error assigning devices to client.\n");
+    return -1;
+  }
+
+  if (conn->read_request_id == BATCH_REQUEST_ID) {
+    if (read_batch(conn) < 0) {
+      printf("error reading batch from client.\n");
+      return -1;
+    }
+    return 0;
+  }
+
+  // requests are read and started in order on one thread, as some of the
+  // __cuda* functions assume that they run on the thread that calls
+  // cudaLaunchKernel. only the wait at the end of a call that blocks on a
+  // stream moves to an executor; see rpc_run_on_stream.
+  if (request_handler(conn) < 0)
+    std::cerr << "Error handling request." << std::endl;
+  return 0;
+}
+
+void conn_close(conn_t *conn) {
+  stop_executors(conn);
+  // a worker's staging pool is shared by its clients and outlives them, so
+  // its buffers must not wait on this connection's zero-copy sends later.
+  staging_forget(conn);
+  if (conn->worker == NULL)
+    staging_shutdown();
+  if (pthread_mutex_destroy(&conn->read_mutex) < 0 ||
+      pthread_mutex_destroy(&conn->write_mutex) < 0 ||
+      pthread_mutex_destroy(&conn->deferred_mutex) < 0)
     std::cerr << "Error destroying mutex." << std::endl;
-  close(connfd);
+  close_data_connections(conn);
+  release_devices(conn);
+  arena_destroy(&conn->arena);
+  if (conn->reactor >= 0)
+    reactor_remove(conn);
+  if (conn->transport.kind == TRANSPORT_SHM) {
+    cudaHostUnregister(conn->transport.shm.region);
+    shm_close(&conn->transport.shm);
+  }
+  if (conn->transport.fd >= 0)
+    close(conn->transport.fd);
+}
+
+// a client with a thread of its own: shared memory, which the reactor can't
+// wait on, or any client when there are no reactor threads.
+void client_handler(int connfd, transport_kind_t kind) {
+  conn_t conn = {};
+  if (conn_open(&conn, connfd, kind) < 0) {
+    close(connfd);
+    return;
+  }
+  while (serve_message(&conn) == 0)
+    ;
+  conn_close(&conn);
+}
+
+// serve the clients the reactor hands over. each gets its own device and
+// capture mode back on this thread, and up to WORKER_BATCH requests before
+// the next client's turn; then it goes back to the reactor, or to the end of
+// the queue if more of its requests were already read.
+void worker_loop(worker_t *worker) {
+  int device = -1;
+
+  pthread_mutex_lock(&worker->mutex);
+  while (1) {
+    while (worker->ready.empty())
+      pthread_cond_wait(&worker->cond, &worker->mutex);
+    conn_t *conn = worker->ready.front();
+    worker->ready.pop_front();
+    pthread_mutex_unlock(&worker->mutex);
+
+    if (conn->device >= 0 && conn->device != device &&
+        cudaSetDevice(conn->device) == cudaSuccess)
+      device = conn->device;
+    cudaThreadExchangeStreamCaptureMode(&conn->capture_mode);
+
+    int served = 0, ret;
+    do
+      ret = serve_message(conn);
+    while (ret == 0 && ++served < WORKER_BATCH && conn_buffered(conn));
+
+    cudaThreadExchangeStreamCaptureMode(&conn->capture_mode);
+    if (cudaGetDevice(&device) == cudaSuccess)
+      conn->device = device;
+
+    bool requeue = false;
+    if (ret == 0 && conn_buffered(conn))
+      requeue = true;
+    else if (ret == 0 && reactor_arm(conn, EPOLL_CTL_MOD) < 0)
+      ret = -1;
+    if (ret < 0) {
+      conn_close(conn);
+      delete conn;
+    }
+
+    pthread_mutex_lock(&worker->mutex);
+    if (requeue)
+      worker->ready.push_back(conn);
+  }
+}
+
+// give a newly accepted client to a reactor, or a thread of its own.
+void accept_client(const int connfd, const transport_kind_t kind) {
+  if (reactors.empty() || kind == TRANSPORT_SHM) {
+    std::thread client_thread(client_handler, connfd, kind);
+    // detach the thread so it runs independently
+    client_thread.detach();
+    return;
+  }
+
+  conn_t *conn = new conn_t();
+  if (conn_open(conn, connfd, kind) < 0) {
+    close(connfd);
+    delete conn;
+    return;
+  }
+  if (reactor_add(conn) < 0) {
+    std::cerr << "Error adding client to reactor." << std::endl;
+    conn_close(conn);
+    delete conn;
+  }
 }
 
 int rpc_read(const void *conn, void *data, size_t size) {
-  return recv(((conn_t *)conn)->connfd, data, size, MSG_WAITALL);
+  conn_t *c = (conn_t *)conn;
+  if (c->batch_offset < c->batch.size()) {
+    // a request never spans the end of its batch.
+    if (size > c->batch.size() - c->batch_offset)
+      return -1;
+    memcpy(data, c->batch.data() + c->batch_offset, size);
+    c->batch_offset += size;
+    return size;
+  }
+  return conn_recv(c, data, size);
+}
+
+// point data at up to size bytes of the request that are already in memory
+// (a batch frame or a shared-memory ring) so the handler can use them in
+// place. returns 0 when the transport has nothing to lend; use rpc_read then.
+int rpc_peek(const void *conn, void **data, size_t size) {
+  conn_t *c = (conn_t *)conn;
+  if (c->batch_offset < c->batch.size()) {
+    *data = c->batch.data() + c->batch_offset;
+    return std::min(size, c->batch.size() - c->batch_offset);
+  }
+  if (c->transport.kind == TRANSPORT_SHM)
+    return shm_peek(&c->transport.shm, data, size);
+  return 0;
+}
+
+// mark bytes returned by rpc_peek as read.
+int rpc_consume(const void *conn, size_t size) {
+  conn_t *c = (conn_t *)conn;
+  if (c->batch_offset < c->batch.size())
+    c->batch_offset += size;
+  else if (c->transport.kind == TRANSPORT_SHM)
+    shm_consume(&c->transport.shm, size);
+  else
+    return -1;
+  return 0;
 }
 
 int rpc_write(const void *conn, const void *data, const size_t size) {
-  ((conn_t *)conn)->write_iov[((conn_t *)conn)->write_iov_count++] =
-      (struct iovec){(void *)data, size};
+  conn_t *c = (conn_t *)conn;
+  c->write_zerocopy[c->write_iov_count] = false;
+  c->write_iov[c->write_iov_count++] = (struct iovec){(void *)data, size};
+  return 0;
+}
+
+// like rpc_write, but data may go out with MSG_ZEROCOPY. the caller must not
+// change it until rpc_zerocopy_release returns for a ticket taken once the
+// response is sent.
+static int rpc_write_zerocopy(const void *conn, const void *data,
+                              const size_t size) {
+  conn_t *c = (conn_t *)conn;
+  c->write_zerocopy[c->write_iov_count] = true;
+  c->write_iov[c->write_iov_count++] = (struct iovec){(void *)data, size};
   return 0;
 }
 
+// a ticket for everything sent on the connection so far.
+uint32_t rpc_zerocopy_ticket(const void *conn) {
+  return transport_ticket(&((conn_t *)conn)->transport);
+}
+
+// wait until the kernel is done sending buffers written before ticket was
+// taken, so they may be reused or freed. this is the only place a zero-copy
+// send is waited on, and only for buffers that are needed again.
+int rpc_zerocopy_release(const void *conn, const uint32_t ticket) {
+  return transport_release(&((conn_t *)conn)->transport, ticket);
+}
+
 // signal from the handler that the request read is complete.
 int rpc_end_request(const void *conn) {
   int request_id = ((conn_t *)conn)->read_request_id;
@@ -109,22 +1063,333 @@ int rpc_start_response(const void *conn, const int request_id) {
   if (pthread_mutex_lock(&((conn_t *)conn)->write_mutex) < 0)
     return -1;
   ((conn_t *)conn)->write_request_id = request_id;
+  ((conn_t *)conn)->write_iov[0] =
+      (struct iovec){&((conn_t *)conn)->write_request_id, sizeof(int)};
+  ((conn_t *)conn)->write_zerocopy[0] = false;
   ((conn_t *)conn)->write_iov_count = 1;
   return 0;
 }
 
 int rpc_end_response(const void *conn, void *result) {
-  ((conn_t *)conn)->write_iov[0] =
-      (struct iovec){&((conn_t *)conn)->write_request_id, sizeof(int)};
-  ((conn_t *)conn)->write_iov[((conn_t *)conn)->write_iov_count++] =
-      (struct iovec){result, sizeof(int)};
-  if (writev(((conn_t *)conn)->connfd, ((conn_t *)conn)->write_iov,
-             ((conn_t *)conn)->write_iov_count) < 0 ||
-      pthread_mutex_unlock(&((conn_t *)conn)->write_mutex) < 0)
+  conn_t *c = (conn_t *)conn;
+  rpc_write(conn, result, sizeof(int));
+
+  // payloads (device to host copies) may be sent with MSG_ZEROCOPY. we don't
+  // wait for the kernel to be done with them; the handler takes a ticket for
+  // its staging buffer and waits on it only before the buffer is reused.
+  if (transport_writev(&c->transport, c->write_iov, c->write_iov_count,
+                       zerocopy_size, c->write_zerocopy) < 0 ||
+      pthread_mutex_unlock(&c->write_mutex) < 0)
     return -1;
   return 0;
 }
 
+// memory a handler needs only until it returns, such as the arrays it reads
+// arguments into. it must not be kept past the request; it is reused for the
+// next one.
+void *rpc_arena_alloc(const void *conn, const size_t size) {
+  return arena_alloc(&((conn_t *)conn)->arena, size);
+}
+
+// whether a payload of size bytes is compressed on the wire, in which case it
+// has to be read with rpc_read_compressed rather than peeked at.
+int rpc_compressed(const void *conn, const size_t size) {
+  return ((conn_t *)conn)->compress != COMPRESS_NONE &&
+         size >= ((conn_t *)conn)->compress_size;
+}
+
+// start reading a payload of size bytes that the client wrote with
+// rpc_write_compressed. it can then be read in pieces of any size with
+// rpc_read_payload.
+int rpc_start_payload_read(const void *conn, const size_t size) {
+  conn_t *c = (conn_t *)conn;
+  c->read_payload_left = size;
+  c->read_payload_compressed = rpc_compressed(conn, size);
+  c->read_payload_stored = false;
+  c->decompressed.clear();
+  c->decompressed_offset = 0;
+  return 0;
+}
+
+// read the next size bytes of the payload. each compressed chunk is
+// decompressed while the next one is still arriving.
+int rpc_read_payload(const void *conn, void *data, const size_t size) {
+  conn_t *c = (conn_t *)conn;
+  size_t copied = 0;
+  while (copied < size) {
+    if (c->decompressed_offset < c->decompressed.size()) {
+      size_t n = std::min(size - copied,
+                          c->decompressed.size() - c->decompressed_offset);
+      memcpy((char *)data + copied,
+             c->decompressed.data() + c->decompressed_offset, n);
+      c->decompressed_offset += n;
+      copied += n;
+      continue;
+    }
+
+    if (!c->read_payload_compressed || c->read_payload_stored) {
+      if (rpc_read(conn, (char *)data + copied, size - copied) < 0)
+        return -1;
+      c->read_payload_left -= size - copied;
+      break;
+    }
+
+    uint32_t length;
+    if (rpc_read(conn, &length, sizeof(uint32_t)) < 0)
+      return -1;
+    if (length == COMPRESS_STORED) {
+      c->read_payload_stored = true;
+      continue;
+    }
+
+    size_t n = std::min((size_t)COMPRESS_CHUNK, c->read_payload_left);
+    if (length > n)
+      return -1;
+    c->compress_buf.resize(length);
+    if (rpc_read(conn, c->compress_buf.data(), length) < 0)
+      return -1;
+
+    // decompress straight into data unless only part of the chunk is wanted.
+    char *out = (char *)data + copied;
+    if (size - copied < n) {
+      c->decompressed.resize(n);
+      c->decompressed_offset = 0;
+      out = c->decompressed.data();
+    }
+    if (decompress_lz4(c->compress_buf.data(), length, out, n) != (ssize_t)n)
+      return -1;
+    c->read_payload_left -= n;
+    if (out != c->decompressed.data())
+      copied += n;
+  }
+  return size;
+}
+
+// read a whole payload written with rpc_write_compressed on the client.
+int rpc_read_compressed(const void *conn, void *data, const size_t size) {
+  if (!rpc_compressed(conn, size))
+    return rpc_read(conn, data, size);
+  if (rpc_start_payload_read(conn, size) < 0)
+    return -1;
+  return rpc_read_payload(conn, data, size);
+}
+
+// start writing a payload of size bytes into the response, compressed if the
+// client asked for it, in pieces passed to rpc_write_payload.
+int rpc_start_payload_write(const void *conn, const size_t size) {
+  conn_t *c = (conn_t *)conn;
+  c->write_payload_compressed = rpc_compressed(conn, size);
+  c->write_payload_stored = false;
+  return 0;
+}
+
+// send the next piece of the payload, after whatever the response already
+// holds. data may go out with MSG_ZEROCOPY, so the caller must not change it
+// until rpc_zerocopy_release returns for a ticket taken after this. every
+// piece but the last must be a multiple of COMPRESS_CHUNK, as the client
+// decompresses whole chunks.
+int rpc_write_payload(const void *conn, const void *data, const size_t size) {
+  conn_t *c = (conn_t *)conn;
+
+  if (!c->write_payload_compressed || c->write_payload_stored) {
+    rpc_write_zerocopy(conn, data, size);
+  } else {
+    for (size_t offset = 0; offset < size; offset += COMPRESS_CHUNK) {
+      size_t n = std::min((size_t)COMPRESS_CHUNK, size - offset);
+      int b = c->compress_out_next;
+      c->compress_out_next ^= 1;
+      if (transport_release(&c->transport, c->compress_out_ticket[b]) < 0)
+        return -1;
+      c->compress_out[b].resize(COMPRESS_CHUNK);
+
+      // like the client, fall back to sending the rest as is once a chunk
+      // doesn't shrink by at least an eighth.
+      size_t length = compress_lz4((char *)data + offset, n,
+                                   c->compress_out[b].data(), n - n / 8);
+      if (length == 0) {
+        c->write_payload_stored = true;
+        c->compress_header = COMPRESS_STORED;
+        rpc_write(conn, &c->compress_header, sizeof(uint32_t));
+        rpc_write_zerocopy(conn, (char *)data + offset, size - offset);
+        break;
+      }
+
+      // each chunk goes out while the next one is compressed.
+      c->compress_header = length;
+      rpc_write(conn, &c->compress_header, sizeof(uint32_t));
+      rpc_write_zerocopy(conn, c->compress_out[b].data(), length);
+      if (offset + n < size) {
+        if (transport_writev(&c->transport, c->write_iov, c->write_iov_count,
+                             zerocopy_size, c->write_zerocopy) < 0)
+          return -1;
+        c->write_iov_count = 0;
+        c->compress_out_ticket[b] = transport_ticket(&c->transport);
+      }
+    }
+  }
+
+  if (transport_writev(&c->transport, c->write_iov, c->write_iov_count,
+                       zerocopy_size, c->write_zerocopy) < 0)
+    return -1;
+  c->write_iov_count = 0;
+  c->compress_out_ticket[0] = c->compress_out_ticket[1] =
+      transport_ticket(&c->transport);
+  return 0;
+}
+
+// write a whole payload into the response, compressed if the client asked
+// for it. like rpc_write_payload, data may go out with MSG_ZEROCOPY.
+int rpc_write_compressed(const void *conn, const void *data,
+                         const size_t size) {
+  if (!rpc_compressed(conn, size))
+    return rpc_write_zerocopy(conn, data, size);
+  if (rpc_start_payload_write(conn, size) < 0)
+    return -1;
+  return rpc_write_payload(conn, data, size);
+}
+
+// whether request a was sent before request b. the client numbers requests
+// in the order it sends them, wrapping around.
+static bool request_before(const int a, const int b) {
+  return (int)((unsigned int)a - (unsigned int)b) < 0;
+}
+
+// record the result of the request being handled, which the client isn't
+// waiting on. called on the handler thread. like cuda's sticky errors, only
+// the first failure is kept until a sync point reports it.
+int rpc_defer_error(const void *conn, const int error) {
+  conn_t *c = (conn_t *)conn;
+  if (error == 0)
+    return 0;
+  pthread_mutex_lock(&c->deferred_mutex);
+  if (c->deferred_error == 0 ||
+      request_before(c->read_request_id, c->deferred_request_id)) {
+    c->deferred_error = error;
+    c->deferred_request_id = c->read_request_id;
+  }
+  pthread_mutex_unlock(&c->deferred_mutex);
+  return 0;
+}
+
+// called by sync points before responding; a successful result picks up the
+// deferred error of a request sent before request_id, if any, and clears it.
+// a sync point that finishes on an executor may run after later requests have
+// failed; their errors wait for the next one.
+int rpc_merge_deferred_error(const void *conn, const int request_id,
+                             void *result) {
+  conn_t *c = (conn_t *)conn;
+  if (*(int *)result != 0)
+    return 0;
+  pthread_mutex_lock(&c->deferred_mutex);
+  if (c->deferred_error != 0 &&
+      request_before(c->deferred_request_id, request_id)) {
+    *(int *)result = c->deferred_error;
+    c->deferred_error = 0;
+  }
+  pthread_mutex_unlock(&c->deferred_mutex);
+  return 0;
+}
+
+// stripe i covers [size * i / stripes, size * (i + 1) / stripes).
+static size_t stripe_offset(const size_t size, const int i,
+                            const int stripes) {
+  return size * i / stripes;
+}
+
+// read a payload the client striped across its data connections.
+int rpc_read_stripes(const void *conn, void *data, const size_t size,
+                     const int stripes) {
+  std::vector<int> fds = get_data_connections((conn_t *)conn, stripes);
+  if (fds.size() != stripes)
+    return -1;
+
+  std::vector<int> results(stripes, 0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < stripes; i++)
+    readers.emplace_back([&, i]() {
+      size_t offset = stripe_offset(size, i, stripes);
+      size_t length = stripe_offset(size, i + 1, stripes) - offset;
+      if (recv(fds[i], (char *)data + offset, length, MSG_WAITALL) !=
+          (ssize_t)length)
+        results[i] = -1;
+    });
+
+  int ret = 0;
+  for (int i = 0; i < stripes; i++) {
+    readers[i].join();
+    if (results[i] < 0)
+      ret = -1;
+  }
+  return ret;
+}
+
+// write a payload across the client's data connections. called after the
+// response, since the client reads the stripes once it has the result.
+int rpc_write_stripes(const void *conn, const void *data, const size_t size,
+                      const int stripes) {
+  std::vector<int> fds = get_data_connections((conn_t *)conn, stripes);
+  if (fds.size() != stripes)
+    return -1;
+
+  std::vector<int> results(stripes, 0);
+  std::vector<std::thread> writers;
+  for (int i = 0; i < stripes; i++)
+    writers.emplace_back([&, i]() {
+      size_t offset = stripe_offset(size, i, stripes);
+      size_t end = stripe_offset(size, i + 1, stripes);
+      while (offset < end) {
+        ssize_t n =
+            send(fds[i], (char *)data + offset, end - offset, MSG_NOSIGNAL);
+        if (n < 0 && errno != EINTR) {
+          results[i] = -1;
+          return;
+        }
+        if (n > 0)
+          offset += n;
+      }
+    });
+
+  int ret = 0;
+  for (int i = 0; i < stripes; i++) {
+    writers[i].join();
+    if (results[i] < 0)
+      ret = -1;
+  }
+  return ret;
+}
+
+// accept clients on this host over the unix socket at path. shared-memory
+// clients only use it to send the memfd with their rings.
+void unix_listener(const std::string path, const transport_kind_t kind) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (sockfd == -1 ||
+      bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(sockfd, MAX_CLIENTS) != 0) {
+    std::cerr << "Listening on " << path << " failed: " << strerror(errno)
+              << std::endl;
+    return;
+  }
+
+  printf("Server listening on %s%s...\n",
+         kind == TRANSPORT_SHM ? "shm://" : "unix://", path.c_str());
+
+  while (1) {
+    int connfd = accept(sockfd, NULL, NULL);
+    if (connfd < 0) {
+      std::cerr << "Server accept failed." << std::endl;
+      continue;
+    }
+
+    accept_client(connfd, kind);
+  }
+}
+
 int main() {
   int port = DEFAULT_PORT;
   struct sockaddr_in servaddr, cli;
@@ -142,6 +1407,62 @@ int main() {
     port = atoi(p);
   }
 
+  p = getenv("SCUDA_ZEROCOPY_SIZE");
+  if (p != NULL)
+    zerocopy_size = strtoul(p, NULL, 10);
+
+  p = getenv("SCUDA_DEVICE_POLICY");
+  if (p != NULL && strcmp(p, "round-robin") == 0)
+    device_policy = DEVICE_POLICY_ROUND_ROBIN;
+  else if (p != NULL && strcmp(p, "fixed") == 0)
+    device_policy = DEVICE_POLICY_FIXED;
+  else if (p != NULL && strcmp(p, "least-loaded") != 0)
+    std::cerr << "Unknown device policy: " << p << std::endl;
+
+  p = getenv("SCUDA_CLIENT_DEVICES");
+  if (p != NULL)
+    client_devices = atoi(p);
+
+  init_devices();
+  printf("Server has %d devices.\n", device_count);
+
+  p = getenv("SCUDA_STREAM_EXECUTORS");
+  if (p != NULL)
+    stream_executors = atoi(p);
+
+  p = getenv("SCUDA_REACTOR_THREADS");
+  if (p != NULL)
+    reactor_threads = atoi(p);
+  p = getenv("SCUDA_WORKER_THREADS");
+  if (p != NULL)
+    worker_threads = atoi(p);
+  if (reactor_threads > 0 && worker_threads <= 0)
+    worker_threads = 1;
+
+  for (int i = 0; reactor_threads > 0 && i < worker_threads; i++) {
+    worker_t *worker = new worker_t();
+    if (pthread_mutex_init(&worker->mutex, NULL) < 0 ||
+        pthread_cond_init(&worker->cond, NULL) < 0) {
+      printf("Worker creation failed.\n");
+      exit(EXIT_FAILURE);
+    }
+    worker->thread = std::thread(worker_loop, worker);
+    worker->thread.detach();
+    workers.push_back(worker);
+  }
+
+  for (int i = 0; i < reactor_threads; i++) {
+    int epfd = epoll_create1(0);
+    if (epfd < 0) {
+      printf("Reactor creation failed.\n");
+      exit(EXIT_FAILURE);
+    }
+    reactors.push_back(epfd);
+
+    std::thread reactor_thread(reactor_loop, epfd);
+    reactor_thread.detach();
+  }
+
   // Bind the socket
   memset(&servaddr, 0, sizeof(servaddr));
   servaddr.sin_family = AF_INET;
@@ -166,6 +1487,32 @@ int main() {
 
   printf("Server listening on port %d...\n", port);
 
+  // clients on this host find the shared-memory socket by port. set
+  // SCUDA_SHM_PATH to move it, or to an empty string to turn it off.
+  p = getenv("SCUDA_SHM_PATH");
+  std::string shm_path =
+      p != NULL ? p : "/tmp/scuda-" + std::to_string(port) + ".sock";
+  if (!shm_path.empty()) {
+    std::thread shm_thread(unix_listener, shm_path, TRANSPORT_SHM);
+    shm_thread.detach();
+  }
+
+  // SCUDA_LISTEN adds comma-separated unix:///path endpoints.
+  p = getenv("SCUDA_LISTEN");
+  if (p != NULL) {
+    char *endpoints = strdup(p);
+    char *endpoint;
+    while ((endpoint = strsep(&endpoints, ","))) {
+      if (strncmp(endpoint, "unix://", 7) != 0) {
+        std::cerr << "Unsupported endpoint: " << endpoint << std::endl;
+        continue;
+      }
+      std::thread unix_thread(unix_listener, std::string(endpoint + 7),
+                              TRANSPORT_UNIX);
+      unix_thread.detach();
+    }
+  }
+
   // Server loop
   while (1) {
     socklen_t len = sizeof(cli);
@@ -176,10 +1523,7 @@ int main() {
       continue;
     }
 
-    std::thread client_thread(client_handler, connfd);
-
-    // detach the thread so it runs independently
-    client_thread.detach();
+    accept_client(connfd, TRANSPORT_TCP);
   }
 
   close(sockfd);
@@ -0,0 +1,284 @@
+#ifndef SHM_H
+#define SHM_H
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+// how many times a reader or writer polls the ring before sleeping.
+#define SHM_SPIN 4096
+
+// one direction of a shared-memory connection: a single-producer,
+// single-consumer byte ring. head and tail count the bytes written and read
+// since the start and only ever grow.
+typedef struct {
+  alignas(64) std::atomic<uint64_t> head;
+  std::atomic<uint32_t> head_seq;
+  std::atomic<uint32_t> reader_waiting;
+  alignas(64) std::atomic<uint64_t> tail;
+  std::atomic<uint32_t> tail_seq;
+  std::atomic<uint32_t> writer_waiting;
+  alignas(64) uint64_t capacity;
+} shm_ring_t;
+
+// a connection made of two rings in one memfd region. the unix socket it was
+// handed over on stays open only so either side notices the other going away.
+typedef struct {
+  int sockfd;
+  char *region;
+  size_t region_size;
+  shm_ring_t *tx, *rx;
+} shm_t;
+
+static inline char *shm_ring_data(shm_ring_t *ring) {
+  return (char *)ring + sizeof(shm_ring_t);
+}
+
+static inline shm_ring_t *shm_ring(char *region, const size_t ring_size,
+                                   const int i) {
+  return (shm_ring_t *)(region + i * (sizeof(shm_ring_t) + ring_size));
+}
+
+// nothing is sent on the socket after the handshake, so it becoming readable
+// means the peer hung up.
+static inline bool shm_peer_closed(const shm_t *shm) {
+  struct pollfd pfd = {shm->sockfd, POLLIN, 0};
+  return poll(&pfd, 1, 0) != 0;
+}
+
+// sleep until seq_word moves past seq, waking up now and then to check on the
+// peer. returns -1 if the peer is gone.
+static inline int shm_sleep(const shm_t *shm, std::atomic<uint32_t> *seq_word,
+                            std::atomic<uint32_t> *waiting,
+                            const uint32_t seq) {
+  struct timespec timeout = {0, 100 * 1000 * 1000};
+  waiting->store(1);
+  long ret = syscall(SYS_futex, (uint32_t *)seq_word, FUTEX_WAIT, seq,
+                     &timeout, NULL, 0);
+  waiting->store(0);
+  if (ret < 0 && errno == ETIMEDOUT && shm_peer_closed(shm))
+    return -1;
+  return 0;
+}
+
+static inline void shm_wake(std::atomic<uint32_t> *seq_word,
+                            std::atomic<uint32_t> *waiting) {
+  seq_word->fetch_add(1);
+  if (waiting->load())
+    syscall(SYS_futex, (uint32_t *)seq_word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+// wait for bytes to read. returns how many are available, or 0 if the peer
+// is gone and the ring is drained.
+static inline uint64_t shm_readable(shm_t *shm) {
+  shm_ring_t *ring = shm->rx;
+  for (int spin = 0;; spin++) {
+    uint64_t available = ring->head.load() - ring->tail.load();
+    if (available > 0)
+      return available;
+    if (spin < SHM_SPIN)
+      continue;
+
+    uint32_t seq = ring->head_seq.load();
+    if (ring->head.load() == ring->tail.load() &&
+        shm_sleep(shm, &ring->head_seq, &ring->reader_waiting, seq) < 0 &&
+        ring->head.load() == ring->tail.load())
+      return 0;
+  }
+}
+
+// wait for room to write. returns how many bytes fit, or 0 if the peer is gone.
+static inline uint64_t shm_writable(shm_t *shm, const uint64_t head) {
+  shm_ring_t *ring = shm->tx;
+  for (int spin = 0;; spin++) {
+    uint64_t space = ring->capacity - (head - ring->tail.load());
+    if (space > 0)
+      return space;
+    if (spin < SHM_SPIN)
+      continue;
+
+    uint32_t seq = ring->tail_seq.load();
+    if (head - ring->tail.load() == ring->capacity &&
+        shm_sleep(shm, &ring->tail_seq, &ring->writer_waiting, seq) < 0)
+      return 0;
+  }
+}
+
+// point data at up to size contiguous bytes waiting in the ring, without
+// consuming them. returns 0 if the peer is gone.
+static inline ssize_t shm_peek(shm_t *shm, void **data, const size_t size) {
+  uint64_t available = shm_readable(shm);
+  if (available == 0)
+    return 0;
+
+  shm_ring_t *ring = shm->rx;
+  uint64_t offset = ring->tail.load() % ring->capacity;
+  *data = shm_ring_data(ring) + offset;
+  return std::min({(uint64_t)size, available, ring->capacity - offset});
+}
+
+static inline void shm_consume(shm_t *shm, const size_t size) {
+  shm->rx->tail.fetch_add(size);
+  shm_wake(&shm->rx->tail_seq, &shm->rx->writer_waiting);
+}
+
+// like recv with MSG_WAITALL; returns less than size only if the peer is gone.
+static inline ssize_t shm_read(shm_t *shm, void *data, const size_t size) {
+  size_t copied = 0;
+  while (copied < size) {
+    void *span;
+    ssize_t n = shm_peek(shm, &span, size - copied);
+    if (n == 0)
+      break;
+    memcpy((char *)data + copied, span, n);
+    shm_consume(shm, n);
+    copied += n;
+  }
+  return copied;
+}
+
+// copy iov into the ring. the reader is woken once per call, or whenever the
+// ring fills up.
+static inline ssize_t shm_writev(shm_t *shm, const struct iovec *iov,
+                                 const int iovcnt) {
+  shm_ring_t *ring = shm->tx;
+  uint64_t head = ring->head.load();
+  ssize_t total = 0;
+
+  for (int i = 0; i < iovcnt; i++) {
+    size_t written = 0;
+    while (written < iov[i].iov_len) {
+      if (head - ring->tail.load() == ring->capacity) {
+        ring->head.store(head);
+        shm_wake(&ring->head_seq, &ring->reader_waiting);
+      }
+      uint64_t space = shm_writable(shm, head);
+      if (space == 0)
+        return -1;
+
+      uint64_t offset = head % ring->capacity;
+      size_t n = std::min({(uint64_t)(iov[i].iov_len - written), space,
+                           ring->capacity - offset});
+      memcpy(shm_ring_data(ring) + offset, (char *)iov[i].iov_base + written,
+             n);
+      head += n;
+      written += n;
+    }
+    total += written;
+  }
+
+  ring->head.store(head);
+  shm_wake(&ring->head_seq, &ring->reader_waiting);
+  return total;
+}
+
+// client side: create the region and hand it to the server over sockfd.
+static inline int shm_create(shm_t *shm, const int sockfd,
+                             const size_t ring_size) {
+  shm->sockfd = sockfd;
+  shm->region_size = 2 * (sizeof(shm_ring_t) + ring_size);
+
+  int fd = memfd_create("scuda", MFD_CLOEXEC);
+  if (fd < 0 || ftruncate(fd, shm->region_size) < 0)
+    return -1;
+
+  shm->region = (char *)mmap(NULL, shm->region_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+  if (shm->region == MAP_FAILED) {
+    shm->region = NULL;
+    close(fd);
+    return -1;
+  }
+
+  // memfd pages start zeroed, which is a valid empty ring.
+  shm->tx = shm_ring(shm->region, ring_size, 0);
+  shm->rx = shm_ring(shm->region, ring_size, 1);
+  shm->tx->capacity = ring_size;
+  shm->rx->capacity = ring_size;
+
+  char byte = 0;
+  struct iovec iov = {&byte, 1};
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  ssize_t n = sendmsg(sockfd, &msg, 0);
+  close(fd);
+  return n == 1 ? 0 : -1;
+}
+
+// server side: map the region the client sent over sockfd.
+static inline int shm_accept(shm_t *shm, const int sockfd) {
+  shm->sockfd = sockfd;
+
+  char byte;
+  struct iovec iov = {&byte, 1};
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  if (recvmsg(sockfd, &msg, MSG_WAITALL) != 1)
+    return -1;
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS)
+    return -1;
+
+  int fd;
+  struct stat st;
+  memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  if (fstat(fd, &st) < 0 || st.st_size <= 2 * (off_t)sizeof(shm_ring_t)) {
+    close(fd);
+    return -1;
+  }
+
+  shm->region_size = st.st_size;
+  shm->region = (char *)mmap(NULL, shm->region_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+  close(fd);
+  if (shm->region == MAP_FAILED) {
+    shm->region = NULL;
+    return -1;
+  }
+
+  size_t ring_size = shm->region_size / 2 - sizeof(shm_ring_t);
+  shm->rx = shm_ring(shm->region, ring_size, 0);
+  shm->tx = shm_ring(shm->region, ring_size, 1);
+  if (shm->rx->capacity != ring_size || shm->tx->capacity != ring_size) {
+    munmap(shm->region, shm->region_size);
+    shm->region = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+static inline void shm_close(shm_t *shm) {
+  if (shm->region != NULL)
+    munmap(shm->region, shm->region_size);
+  shm->region = NULL;
+}
+
+#endif
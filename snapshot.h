@@ -0,0 +1,35 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+
+// attribute ids below this are queried for the snapshot. both the runtime's
+// and the driver's enums stay well under it; the ids a server doesn't know
+// come back with the error it gave.
+#define SNAPSHOT_ATTRIBUTES 256
+
+// what a client asks the server for once, with __scudaGetDeviceSnapshot, and
+// then answers the version, property and attribute queries from. the
+// response is [snapshot_t][int count][device_snapshot_t...], one per device
+// of the client's, in its ordinals. every value keeps the result of the call
+// that produced it so errors come back the same as they would have.
+typedef struct {
+  int driver_version;
+  cudaError_t driver_result;
+  int runtime_version;
+  cudaError_t runtime_result;
+  int cu_driver_version;
+  CUresult cu_driver_result;
+} snapshot_t;
+
+typedef struct {
+  cudaDeviceProp prop;
+  cudaError_t prop_result;
+  int attributes[SNAPSHOT_ATTRIBUTES];
+  cudaError_t attribute_results[SNAPSHOT_ATTRIBUTES];
+  int cu_attributes[SNAPSHOT_ATTRIBUTES];
+  CUresult cu_attribute_results[SNAPSHOT_ATTRIBUTES];
+} device_snapshot_t;
+
+#endif
@@ -0,0 +1,175 @@
+// exercises the slab allocator in allocator.h on made-up addresses. it is host
+// code only, so this runs without a server or a GPU. after every step the
+// allocator's blocks, free pools and idle count are checked against each
+// other.
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "allocator.h"
+
+#define MB (1024 * 1024)
+
+static bool check(const bool ok, const std::string &what) {
+  if (!ok)
+    std::cout << "FAILED: " << what << std::endl;
+  return ok;
+}
+
+// every slab is tiled by its blocks, no two free neighbours are left unmerged,
+// the pools hold exactly the free blocks, and idle counts the unused slabs.
+static bool consistent(const allocator_t &allocator, const std::string &what) {
+  size_t idle = 0, free_blocks = 0;
+  for (const auto &[base, slab] : allocator.slabs) {
+    uintptr_t end = base;
+    size_t used = 0;
+    bool previous_free = false;
+    for (auto it = allocator.blocks.find(base);
+         it != allocator.blocks.end() && it->second.slab == base; ++it) {
+      if (it->first != end || (previous_free && it->second.free))
+        return check(false, what + ": blocks don't tile the slab");
+      if (it->second.free) {
+        free_blocks++;
+        if (!allocator.free[slab.small ? 0 : 1].count(
+                {it->second.size, it->first}))
+          return check(false, what + ": free block missing from its pool");
+      } else {
+        used += it->second.size;
+      }
+      previous_free = it->second.free;
+      end += it->second.size;
+    }
+    if (end != base + slab.size || used != slab.used)
+      return check(false, what + ": slab size or use is off");
+    if (slab.used == 0)
+      idle += slab.size;
+  }
+  size_t pooled = allocator.free[0].size() + allocator.free[1].size();
+  return check(free_blocks == pooled,
+               what + ": pools hold blocks that aren't free") &&
+         check(idle == allocator.idle, what + ": idle count is off");
+}
+
+int main() {
+  allocator_t allocator;
+
+  // a large slab, then three blocks split off the front of it.
+  uintptr_t base = 0x10000000;
+  size_t slab = allocator_slab_size(4 * MB, 32 * MB);
+  if (!check(slab == 32 * MB, "large slab size") ||
+      !check(allocator_slab_size(100, 32 * MB) == ALLOCATOR_SMALL_SLAB,
+             "small slab size") ||
+      !check(allocator_slab_size(33 * MB, 32 * MB) ==
+                 allocator_round(33 * MB, ALLOCATOR_LARGE_ROUND),
+             "slab for a request bigger than a slab"))
+    return 1;
+  allocator_add_slab(&allocator, base, slab, false);
+  if (!check(allocator.idle == slab, "a new slab is idle"))
+    return 1;
+
+  uintptr_t a = allocator_alloc(&allocator, 4 * MB);
+  uintptr_t b = allocator_alloc(&allocator, 8 * MB);
+  uintptr_t c = allocator_alloc(&allocator, 4 * MB);
+  if (!check(a == base && b == base + 4 * MB && c == base + 12 * MB,
+             "split in address order") ||
+      !check(allocator.idle == 0, "a used slab isn't idle") ||
+      !consistent(allocator, "after splitting"))
+    return 1;
+
+  // what is left is 16 MB, so 20 MB doesn't fit.
+  if (!check(allocator_alloc(&allocator, 20 * MB) == 0, "too large"))
+    return 1;
+
+  // freeing b leaves a hole between used blocks; freeing a and c merges all
+  // of it back into the one block the slab started as.
+  if (!check(allocator_free(&allocator, b), "free b") ||
+      !check(!allocator_free(&allocator, b), "double free") ||
+      !check(!allocator_free(&allocator, base + 1), "free of a non-block") ||
+      !consistent(allocator, "after freeing b"))
+    return 1;
+
+  // best fit: 6 MB goes in b's 8 MB hole rather than the 16 MB tail.
+  uintptr_t d = allocator_alloc(&allocator, 6 * MB);
+  if (!check(d == b, "best fit") || !consistent(allocator, "best fit"))
+    return 1;
+  allocator_free(&allocator, d);
+
+  allocator_free(&allocator, a);
+  allocator_free(&allocator, c);
+  if (!check(allocator.blocks.size() == 1 && allocator.free[1].size() == 1 &&
+                 allocator.free[1].begin()->first == slab,
+             "merged back into one block") ||
+      !check(allocator.idle == slab, "an emptied slab is idle") ||
+      !consistent(allocator, "after merging"))
+    return 1;
+
+  // small requests come from small slabs only, and a second slab right
+  // after the first in memory isn't merged with it.
+  uintptr_t small_base = base + slab;
+  if (!check(allocator_alloc(&allocator, ALLOCATOR_ROUND) == 0,
+             "small request from a large slab"))
+    return 1;
+  allocator_add_slab(&allocator, small_base, ALLOCATOR_SMALL_SLAB, true);
+  uintptr_t e = allocator_alloc(&allocator, ALLOCATOR_ROUND);
+  uintptr_t f = allocator_alloc(&allocator, 2 * MB);
+  if (!check(e == small_base, "small request from a small slab") ||
+      !check(f == base, "large request from the large slab") ||
+      !consistent(allocator, "two slabs"))
+    return 1;
+  allocator_free(&allocator, e);
+  allocator_free(&allocator, f);
+  if (!check(allocator.blocks.count(small_base) &&
+                 allocator.blocks.at(small_base).size == ALLOCATOR_SMALL_SLAB,
+             "slabs kept apart") ||
+      !consistent(allocator, "after freeing the small block"))
+    return 1;
+
+  // random allocations and frees across three slabs keep everything in order.
+  allocator_add_slab(&allocator, 0x40000000, 64 * MB, false);
+  std::mt19937 random(1234);
+  std::vector<uintptr_t> live;
+  for (int i = 0; i < 5000; i++) {
+    if (!live.empty() && random() % 2) {
+      size_t j = random() % live.size();
+      if (!check(allocator_free(&allocator, live[j]), "random free"))
+        return 1;
+      live[j] = live.back();
+      live.pop_back();
+    } else {
+      size_t size = random() % 2 ? random() % (64 * 1024)
+                                 : random() % (8 * MB);
+      uintptr_t address =
+          allocator_alloc(&allocator, allocator_round(size + 1, 512));
+      if (address)
+        live.push_back(address);
+    }
+    if (!consistent(allocator, "random step " + std::to_string(i)))
+      return 1;
+  }
+  for (uintptr_t address : live)
+    allocator_free(&allocator, address);
+  if (!check(allocator.idle == slab + ALLOCATOR_SMALL_SLAB + 64 * MB,
+             "everything idle after freeing it all") ||
+      !consistent(allocator, "after the random steps"))
+    return 1;
+
+  // trim keeps at most keep bytes idle, and leaves slabs in use alone.
+  uintptr_t kept = allocator_alloc(&allocator, 40 * MB);
+  std::vector<uintptr_t> released =
+      allocator_trim(&allocator, ALLOCATOR_SMALL_SLAB);
+  if (!check(released.size() == 1 && released[0] == base, "trim") ||
+      !check(allocator.idle == ALLOCATOR_SMALL_SLAB, "idle after trim") ||
+      !check(allocator.slabs.count(0x40000000) == 1, "slab in use kept") ||
+      !consistent(allocator, "after trimming"))
+    return 1;
+  allocator_free(&allocator, kept);
+  released = allocator_trim(&allocator, 0);
+  if (!check(released.size() == 2 && allocator.slabs.empty() &&
+                 allocator.blocks.empty() && allocator.free[0].empty() &&
+                 allocator.free[1].empty() && allocator.idle == 0,
+             "trim everything"))
+    return 1;
+
+  std::cout << "PASSED" << std::endl;
+  return 0;
+}
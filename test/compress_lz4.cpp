@@ -0,0 +1,138 @@
+// round-trips the lz4 codec in compress.h and feeds it malformed blocks. it is
+// host code only, so this runs without a server or a GPU; build it with
+// -fsanitize=address,undefined to catch reads and writes out of bounds.
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compress.h"
+
+static bool check(const bool ok, const std::string &what) {
+  if (!ok)
+    std::cout << "FAILED: " << what << std::endl;
+  return ok;
+}
+
+static bool roundtrip(const std::vector<uint8_t> &data,
+                      const std::string &what) {
+  // the worst case grows the input by a length byte per 255 literals plus a
+  // token.
+  std::vector<uint8_t> compressed(data.size() + data.size() / 255 + 16);
+  size_t length = compress_lz4(data.data(), data.size(), compressed.data(),
+                               compressed.size());
+  if (!check(length > 0, what + ": compress"))
+    return false;
+
+  std::vector<uint8_t> out(data.size());
+  ssize_t n = decompress_lz4(compressed.data(), length, out.data(), out.size());
+  if (!check(n == (ssize_t)data.size() && out == data, what + ": round trip"))
+    return false;
+
+  // one byte short of room has to fail rather than write past the end.
+  if (!data.empty() &&
+      !check(decompress_lz4(compressed.data(), length, out.data(),
+                            out.size() - 1) < 0,
+             what + ": short output"))
+    return false;
+
+  // every truncation is either rejected or decodes to a prefix.
+  for (size_t cut = 0; cut < length; cut += 1 + length / 64) {
+    ssize_t m = decompress_lz4(compressed.data(), cut, out.data(), out.size());
+    if (!check(m < 0 || (m <= (ssize_t)data.size() &&
+                         std::equal(out.begin(), out.begin() + m,
+                                    data.begin())),
+               what + ": truncated to " + std::to_string(cut)))
+      return false;
+  }
+  return true;
+}
+
+int main() {
+  std::mt19937 random(1234);
+
+  // sizes around the format's limits: no matches below 13 bytes, literal and
+  // match lengths spilling into extra bytes past 15 and 15 + 255.
+  size_t sizes[] = {0, 1, 5, 12, 13, 14, 270, 4096, COMPRESS_CHUNK};
+  for (size_t size : sizes) {
+    std::vector<uint8_t> zeros(size, 0), text(size), noise(size);
+    const char *words = "the quick brown fox jumps over the lazy dog ";
+    for (size_t i = 0; i < size; i++) {
+      text[i] = words[i % strlen(words)];
+      noise[i] = (uint8_t)random();
+    }
+    std::string suffix = " of " + std::to_string(size) + " bytes";
+    if (!roundtrip(zeros, "zeros" + suffix) ||
+        !roundtrip(text, "text" + suffix) ||
+        !roundtrip(noise, "noise" + suffix))
+      return 1;
+  }
+
+  // a long literal run followed by a long match.
+  std::vector<uint8_t> mixed(1000);
+  for (size_t i = 0; i < 400; i++)
+    mixed[i] = (uint8_t)random();
+  if (!roundtrip(mixed, "literals then a match"))
+    return 1;
+
+  // an empty payload may come with null pointers.
+  if (!check(compress_lz4(NULL, 0, NULL, 0) == 0, "empty into nothing") ||
+      !check(decompress_lz4(NULL, 0, NULL, 0) == 0, "empty block"))
+    return 1;
+
+  // a capacity below the input size rejects data that doesn't shrink.
+  std::vector<uint8_t> noise(4096), small(4096 - 512);
+  for (auto &byte : noise)
+    byte = (uint8_t)random();
+  if (!check(compress_lz4(noise.data(), noise.size(), small.data(),
+                          small.size()) == 0,
+             "incompressible data under a capacity"))
+    return 1;
+
+  std::vector<uint8_t> out(64);
+  // a match before anything has been written.
+  uint8_t no_history[] = {0x00, 0x01, 0x00, 0x10};
+  // an offset of zero.
+  uint8_t zero_offset[] = {0x10, 'a', 0x00, 0x00, 0x10};
+  // a literal length that runs past the block.
+  uint8_t long_literals[] = {0xf0, 0xff, 0xff};
+  // literals claiming more bytes than follow.
+  uint8_t short_literals[] = {0x50, 'a', 'b'};
+  // a match length that never ends.
+  uint8_t open_match[] = {0x1f, 'a', 0x01, 0x00, 0xff};
+  // a match longer than the output.
+  uint8_t long_match[] = {0x1f, 'a', 0x01, 0x00, 0xff, 0x00, 0x00};
+  if (!check(decompress_lz4(no_history, sizeof(no_history), out.data(),
+                            out.size()) < 0,
+             "match without history") ||
+      !check(decompress_lz4(zero_offset, sizeof(zero_offset), out.data(),
+                            out.size()) < 0,
+             "zero offset") ||
+      !check(decompress_lz4(long_literals, sizeof(long_literals), out.data(),
+                            out.size()) < 0,
+             "literal length past the block") ||
+      !check(decompress_lz4(short_literals, sizeof(short_literals),
+                            out.data(), out.size()) < 0,
+             "missing literals") ||
+      !check(decompress_lz4(open_match, sizeof(open_match), out.data(),
+                            out.size()) < 0,
+             "unterminated match length") ||
+      !check(decompress_lz4(long_match, sizeof(long_match), out.data(),
+                            out.size()) < 0,
+             "match past the output"))
+    return 1;
+
+  // whatever garbage comes in, the decoder stays inside its buffers.
+  std::vector<uint8_t> garbage(256);
+  for (int i = 0; i < 10000; i++) {
+    size_t size = random() % garbage.size();
+    for (size_t j = 0; j < size; j++)
+      garbage[j] = (uint8_t)random();
+    ssize_t n = decompress_lz4(garbage.data(), size, out.data(), out.size());
+    if (!check(n <= (ssize_t)out.size(), "garbage block"))
+      return 1;
+  }
+
+  std::cout << "PASSED" << std::endl;
+  return 0;
+}
@@ -98,6 +98,21 @@ int main(int argc, char *argv[])
     print_matrix(m, n, d_C[1], ldc);
     printf("=====\n");
 
+    /*
+     *   C = | 19.0 | 22.0 | 111.0 | 122.0 |
+     *       | 43.0 | 50.0 | 151.0 | 166.0 |
+     */
+    const std::vector<std::vector<data_type>> expected = {{19.0, 43.0, 22.0, 50.0},
+                                                          {111.0, 151.0, 122.0, 166.0}};
+    for (int i = 0; i < batch_count; i++) {
+        for (int j = 0; j < m * n; j++) {
+            if (d_C[i][j] != expected[i][j]) {
+                printf("C[%d][%d] is %f, expected %f\n", i, j, d_C[i][j], expected[i][j]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
     /* Free resources */
     CUDA_CHECK(cudaFree(d_A_array));
     CUDA_CHECK(cudaFree(d_B_array));
@@ -112,5 +127,6 @@ int main(int argc, char *argv[])
     CUDA_CHECK(cudaStreamDestroy(stream));
     CUDA_CHECK(cudaDeviceReset());
 
+    printf("PASSED\n");
     return EXIT_SUCCESS;
 }
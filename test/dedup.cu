@@ -0,0 +1,79 @@
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+// uploads the same data more than once with SCUDA_DEDUP_SIZE set and checks
+// that the device ends up with the right bytes whether chunks came from the
+// client or from the server's cache. the client prints how many chunks each
+// copy sent, which local.sh compares against what should have hit.
+#define CHUNK (1024 * 1024)
+// four whole chunks and a partial one.
+#define SIZE (4 * CHUNK + 1000)
+
+static bool verify(const void *device, const std::vector<unsigned char> &host,
+                   const char *what) {
+  std::vector<unsigned char> back(SIZE);
+  if (cudaMemcpy(back.data(), device, SIZE, cudaMemcpyDeviceToHost) !=
+      cudaSuccess) {
+    printf("%s: copying back failed\n", what);
+    return false;
+  }
+  if (back != host) {
+    printf("%s: device memory doesn't match what was uploaded\n", what);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  // the server's cache outlives this process, so every run uploads data it
+  // hasn't seen before.
+  std::vector<unsigned char> host(SIZE);
+  srand(time(NULL) ^ getpid());
+  for (size_t i = 0; i < SIZE; i++)
+    host[i] = (unsigned char)rand();
+
+  unsigned char *a, *b, *c;
+  if (cudaMalloc(&a, SIZE) != cudaSuccess ||
+      cudaMalloc(&b, SIZE) != cudaSuccess ||
+      cudaMalloc(&c, SIZE) != cudaSuccess) {
+    printf("cudaMalloc failed\n");
+    return 1;
+  }
+
+  // nothing cached yet: all 5 chunks are sent.
+  if (cudaMemcpy(a, host.data(), SIZE, cudaMemcpyHostToDevice) !=
+          cudaSuccess ||
+      !verify(a, host, "first upload"))
+    return 1;
+
+  // the same data to another buffer: every chunk is a hit.
+  if (cudaMemcpy(b, host.data(), SIZE, cudaMemcpyHostToDevice) !=
+          cudaSuccess ||
+      !verify(b, host, "repeated upload"))
+    return 1;
+
+  // change the second chunk and the partial one: those two miss.
+  host[CHUNK + 5]++;
+  host[SIZE - 1]++;
+  if (cudaMemcpy(c, host.data(), SIZE, cudaMemcpyHostToDevice) !=
+          cudaSuccess ||
+      !verify(c, host, "changed upload"))
+    return 1;
+
+  // and once the changed chunks are cached they hit too.
+  if (cudaMemcpy(a, host.data(), SIZE, cudaMemcpyHostToDevice) !=
+          cudaSuccess ||
+      !verify(a, host, "changed upload again"))
+    return 1;
+
+  cudaFree(a);
+  cudaFree(b);
+  cudaFree(c);
+  printf("PASSED\n");
+  return 0;
+}
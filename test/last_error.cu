@@ -0,0 +1,38 @@
+#include <cuda_runtime.h>
+#include <stdio.h>
+
+// kernel launches don't wait for the server, so a launch that fails is only
+// known there. cudaPeekAtLastError and cudaGetLastError still have to report
+// it right after the launch, like the runtime does.
+__global__ void noop() {}
+
+int main() {
+  noop<<<1, 1>>>();
+  if (cudaGetLastError() != cudaSuccess) {
+    printf("a good launch left an error\n");
+    return 1;
+  }
+
+  // too many threads per block.
+  noop<<<1, 4096>>>();
+  cudaError_t peeked = cudaPeekAtLastError();
+  cudaError_t peeked_again = cudaPeekAtLastError();
+  cudaError_t got = cudaGetLastError();
+  cudaError_t cleared = cudaGetLastError();
+  if (peeked != cudaErrorInvalidConfiguration ||
+      peeked_again != cudaErrorInvalidConfiguration ||
+      got != cudaErrorInvalidConfiguration || cleared != cudaSuccess) {
+    printf("got %d, %d, %d and %d after a bad launch\n", peeked, peeked_again,
+           got, cleared);
+    return 1;
+  }
+
+  // collected once, the error isn't reported again by a sync point.
+  if (cudaDeviceSynchronize() != cudaSuccess) {
+    printf("the launch error was reported twice\n");
+    return 1;
+  }
+
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <chrono>
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// times small round trips to the server; run it against each transport to
+// compare them. every cudaMemcpy from the device waits on a response.
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 10000;
+  int *d_value;
+  int value = 0;
+
+  if (cudaMalloc(&d_value, sizeof(int)) != cudaSuccess ||
+      cudaMemcpy(d_value, &value, sizeof(int), cudaMemcpyHostToDevice) !=
+          cudaSuccess) {
+    printf("setup failed\n");
+    return 1;
+  }
+
+  std::vector<double> samples;
+  for (int i = 0; i < iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    cudaMemcpy(&value, d_value, sizeof(int), cudaMemcpyDeviceToHost);
+    auto end = std::chrono::steady_clock::now();
+    samples.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+
+  std::sort(samples.begin(), samples.end());
+  double total = 0;
+  for (double sample : samples)
+    total += sample;
+
+  cudaFree(d_value);
+
+  printf("%d round trips: avg %.2f us, p50 %.2f us, p99 %.2f us\n", iterations,
+         total / iterations, samples[iterations / 2],
+         samples[iterations * 99 / 100]);
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <vector>
+
+// run with SCUDA_SERVER listing more than one server (the same one twice
+// will do) and data connections turned on. every device gets its own buffer,
+// stream and kernel; the buffers are then read back and copied between
+// devices while another device is current, so each call has to find the
+// server that owns its pointer. the buffers are large enough to be striped.
+#define SIZE (4 * 1024 * 1024)
+
+__global__ void add(unsigned char *data, size_t size, unsigned char value) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < size;
+       i += gridDim.x * blockDim.x)
+    data[i] += value;
+}
+
+static unsigned char expected(const int device, const size_t i) {
+  return (unsigned char)(i * 13 + device) + (unsigned char)(device + 1);
+}
+
+static bool verify(const void *device_ptr, const int device, const char *what) {
+  std::vector<unsigned char> back(SIZE);
+  if (cudaMemcpy(back.data(), device_ptr, SIZE, cudaMemcpyDeviceToHost) !=
+      cudaSuccess) {
+    printf("%s: copying back from device %d failed\n", what, device);
+    return false;
+  }
+  for (size_t i = 0; i < SIZE; i++) {
+    if (back[i] != expected(device, i)) {
+      printf("%s: device %d byte %zu is %d, expected %d\n", what, device, i,
+             back[i], expected(device, i));
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  int count;
+  if (cudaGetDeviceCount(&count) != cudaSuccess || count < 2) {
+    printf("need at least 2 devices across the servers\n");
+    return 1;
+  }
+
+  std::vector<unsigned char *> buffers(count);
+  std::vector<cudaStream_t> streams(count);
+  std::vector<unsigned char> host(SIZE);
+  for (int device = 0; device < count; device++) {
+    for (size_t i = 0; i < SIZE; i++)
+      host[i] = (unsigned char)(i * 13 + device);
+
+    cudaEvent_t done;
+    if (cudaSetDevice(device) != cudaSuccess ||
+        cudaMalloc(&buffers[device], SIZE) != cudaSuccess ||
+        cudaStreamCreate(&streams[device]) != cudaSuccess ||
+        cudaEventCreate(&done) != cudaSuccess ||
+        cudaMemcpy(buffers[device], host.data(), SIZE,
+                   cudaMemcpyHostToDevice) != cudaSuccess) {
+      printf("setting up device %d failed\n", device);
+      return 1;
+    }
+    add<<<64, 256, 0, streams[device]>>>(buffers[device], SIZE,
+                                          (unsigned char)(device + 1));
+    if (cudaEventRecord(done, streams[device]) != cudaSuccess ||
+        cudaEventSynchronize(done) != cudaSuccess ||
+        cudaEventDestroy(done) != cudaSuccess) {
+      printf("running on device %d failed\n", device);
+      return 1;
+    }
+
+    int current;
+    if (cudaGetDevice(&current) != cudaSuccess || current != device) {
+      printf("cudaGetDevice returned %d, expected %d\n", current, device);
+      return 1;
+    }
+  }
+
+  // every buffer is read back through the server that owns it, whichever
+  // device is current.
+  cudaSetDevice(0);
+  for (int device = 0; device < count; device++)
+    if (!verify(buffers[device], device, "read back"))
+      return 1;
+
+  // a device to device copy between the first and last device, which sit on
+  // different servers.
+  if (cudaMemcpy(buffers[0], buffers[count - 1], SIZE,
+                 cudaMemcpyDeviceToDevice) != cudaSuccess ||
+      !verify(buffers[0], count - 1, "copy between devices"))
+    return 1;
+
+  for (int device = 0; device < count; device++) {
+    cudaSetDevice(device);
+    if (cudaStreamDestroy(streams[device]) != cudaSuccess ||
+        cudaFree(buffers[device]) != cudaSuccess) {
+      printf("cleaning up device %d failed\n", device);
+      return 1;
+    }
+  }
+
+  printf("PASSED\n");
+  return 0;
+}
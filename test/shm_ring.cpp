@@ -0,0 +1,101 @@
+// exercises the shared-memory transport on its own: no server, no GPU. both
+// ends of a connection live in this process, on the two sides of a
+// socketpair.
+#include <iostream>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+#include "shm.h"
+
+// small enough that every transfer below wraps around and fills the ring.
+#define RING_SIZE 4096
+
+static bool check(const bool ok, const char *what) {
+  if (!ok)
+    std::cout << "FAILED: " << what << std::endl;
+  return ok;
+}
+
+static std::vector<char> pattern(const size_t size, const int seed) {
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = (char)(i * 31 + seed);
+  return data;
+}
+
+int main() {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+    std::cout << "FAILED: socketpair" << std::endl;
+    return 1;
+  }
+
+  shm_t client = {}, server = {};
+  if (!check(shm_create(&client, fds[0], RING_SIZE) == 0, "shm_create") ||
+      !check(shm_accept(&server, fds[1]) == 0, "shm_accept") ||
+      !check((char *)server.rx - server.region ==
+                 (char *)client.tx - client.region,
+             "ring layout"))
+    return 1;
+
+  // a request made of several pieces, many times the ring's size, has to
+  // arrive in order while the reader drains it in odd-sized reads.
+  std::vector<char> a = pattern(3, 1), b = pattern(10 * RING_SIZE + 17, 2),
+                    c = pattern(RING_SIZE, 3);
+  std::thread writer([&] {
+    struct iovec iov[3] = {{a.data(), a.size()},
+                           {b.data(), b.size()},
+                           {c.data(), c.size()}};
+    ssize_t size = a.size() + b.size() + c.size();
+    if (shm_writev(&client, iov, 3) != size)
+      std::cout << "FAILED: shm_writev" << std::endl;
+  });
+
+  std::vector<char> expected = a;
+  expected.insert(expected.end(), b.begin(), b.end());
+  expected.insert(expected.end(), c.begin(), c.end());
+  std::vector<char> received(expected.size());
+  size_t offset = 0;
+  for (size_t n = 1; offset < received.size(); n = n * 3 % 5000 + 1) {
+    size_t size = std::min(n, received.size() - offset);
+    if (!check(shm_read(&server, received.data() + offset, size) ==
+                   (ssize_t)size,
+               "shm_read"))
+      return 1;
+    offset += size;
+  }
+  writer.join();
+  if (!check(received == expected, "client to server bytes"))
+    return 1;
+
+  // the other ring carries the response.
+  std::vector<char> response = pattern(2 * RING_SIZE + 1, 4);
+  std::thread responder([&] {
+    struct iovec iov = {response.data(), response.size()};
+    shm_writev(&server, &iov, 1);
+  });
+  std::vector<char> got(response.size());
+  bool read = shm_read(&client, got.data(), got.size()) == (ssize_t)got.size();
+  responder.join();
+  if (!check(read && got == response, "server to client bytes"))
+    return 1;
+
+  // bytes written before the peer hangs up can still be read; after that a
+  // read comes back short instead of blocking.
+  struct iovec last = {a.data(), a.size()};
+  if (!check(shm_writev(&client, &last, 1) == (ssize_t)a.size(), "last write"))
+    return 1;
+  close(fds[0]);
+  std::vector<char> tail(a.size() + 1);
+  if (!check(shm_read(&server, tail.data(), tail.size()) == (ssize_t)a.size(),
+             "read after hangup") ||
+      !check(std::equal(a.begin(), a.end(), tail.begin()), "drained bytes"))
+    return 1;
+
+  shm_close(&client);
+  shm_close(&server);
+  close(fds[1]);
+  std::cout << "PASSED" << std::endl;
+  return 0;
+}
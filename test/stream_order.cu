@@ -0,0 +1,77 @@
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <thread>
+#include <unistd.h>
+
+// checks that the server's per-stream executors keep cuda's ordering: work
+// on a stream completes in order, synchronous copies wait for blocking
+// streams, and an error from an async call is reported by the first sync
+// point sent after it rather than one that was already waiting.
+
+// about half a second on current gpus; long enough that whatever is queued
+// behind it is sent before it finishes.
+#define SPIN_CYCLES (1000LL * 1000 * 1000)
+
+__global__ void spin_then_write(int *flag, long long cycles, int value) {
+  long long start = clock64();
+  while (clock64() - start < cycles)
+    ;
+  *flag = value;
+}
+
+__global__ void noop() {}
+
+int main() {
+  int *flag;
+  int value = 0;
+  cudaStream_t a;
+  if (cudaMalloc(&flag, sizeof(int)) != cudaSuccess ||
+      cudaMemset(flag, 0, sizeof(int)) != cudaSuccess ||
+      cudaStreamCreate(&a) != cudaSuccess) {
+    printf("setup failed\n");
+    return 1;
+  }
+
+  // a copy queued behind a kernel on the same stream sees what it wrote.
+  spin_then_write<<<1, 1, 0, a>>>(flag, SPIN_CYCLES, 1);
+  cudaMemcpyAsync(&value, flag, sizeof(int), cudaMemcpyDeviceToHost, a);
+  if (cudaStreamSynchronize(a) != cudaSuccess || value != 1) {
+    printf("stream order: got %d, expected 1\n", value);
+    return 1;
+  }
+
+  // a synchronous copy on the legacy stream waits for a blocking stream.
+  spin_then_write<<<1, 1, 0, a>>>(flag, SPIN_CYCLES, 2);
+  if (cudaMemcpy(&value, flag, sizeof(int), cudaMemcpyDeviceToHost) !=
+          cudaSuccess ||
+      value != 2) {
+    printf("implicit synchronization: got %d, expected 2\n", value);
+    return 1;
+  }
+  if (cudaStreamQuery(a) != cudaSuccess) {
+    printf("stream still busy after a synchronous copy\n");
+    return 1;
+  }
+
+  // one thread waits on a busy stream while another makes a launch that
+  // fails. the failure belongs to the second thread's next sync point, not
+  // to the wait that was sent before it.
+  spin_then_write<<<1, 1, 0, a>>>(flag, SPIN_CYCLES, 3);
+  cudaError_t waited = cudaErrorUnknown;
+  std::thread waiter([&] { waited = cudaStreamSynchronize(a); });
+  usleep(100 * 1000);
+  noop<<<1, 4096>>>();
+  cudaError_t synced = cudaDeviceSynchronize();
+  waiter.join();
+  if (waited != cudaSuccess || synced != cudaErrorInvalidConfiguration) {
+    printf("deferred error: wait returned %d, sync returned %d\n", waited,
+           synced);
+    return 1;
+  }
+  cudaGetLastError();
+
+  cudaStreamDestroy(a);
+  cudaFree(flag);
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// moves buffers to the device and back through a kernel, over whichever
+// transport SCUDA_SERVER picks. the sizes cover a response that fits the
+// client's receive buffer, one read straight into the caller's memory, and one
+// larger than a default shared-memory ring.
+__global__ void increment(unsigned char *data, size_t size) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < size;
+       i += gridDim.x * blockDim.x)
+    data[i]++;
+}
+
+static bool roundtrip(const size_t size, const bool async) {
+  std::vector<unsigned char> host(size), back(size);
+  for (size_t i = 0; i < size; i++)
+    host[i] = (unsigned char)(i * 7);
+
+  unsigned char *device;
+  if (cudaMalloc(&device, size) != cudaSuccess) {
+    printf("cudaMalloc of %zu bytes failed\n", size);
+    return false;
+  }
+
+  cudaError_t err;
+  if (async) {
+    cudaMemcpyAsync(device, host.data(), size, cudaMemcpyHostToDevice, 0);
+    increment<<<64, 256>>>(device, size);
+    cudaMemcpyAsync(back.data(), device, size, cudaMemcpyDeviceToHost, 0);
+    err = cudaStreamSynchronize(0);
+  } else {
+    cudaMemcpy(device, host.data(), size, cudaMemcpyHostToDevice);
+    increment<<<64, 256>>>(device, size);
+    err = cudaMemcpy(back.data(), device, size, cudaMemcpyDeviceToHost);
+  }
+  cudaFree(device);
+
+  if (err != cudaSuccess) {
+    printf("copying %zu bytes failed: %d\n", size, err);
+    return false;
+  }
+  for (size_t i = 0; i < size; i++) {
+    if (back[i] != (unsigned char)(host[i] + 1)) {
+      printf("%zu bytes: byte %zu is %d, expected %d\n", size, i, back[i],
+             (unsigned char)(host[i] + 1));
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  size_t sizes[] = {16, 1024 * 1024, 24 * 1024 * 1024};
+  for (size_t size : sizes)
+    if (!roundtrip(size, false) || !roundtrip(size, true))
+      return 1;
+
+  printf("PASSED\n");
+  return 0;
+}
@@ -1,63 +1,154 @@
 #include <cuda_runtime.h>
+#include <fcntl.h>
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
 
-// CUDA Kernel to add elements of two arrays
-// __global__ void addKernel(int *a, int *b, int *c, int size) {
-//     int idx = threadIdx.x + blockIdx.x * blockDim.x;
-//     if (idx < size) {
-//         c[idx] = a[idx] * b[idx];
-//     }
-// }
+// managed memory as the client keeps it: a host mirror uploaded a page at a
+// time before a launch and downloaded whole after it. the client logs every
+// upload and download, which local.sh compares against what the steps should
+// move. the mirrors are also written by the system, through a large device to
+// host copy and a read() from a file.
+#define BIG (16 * 1024 * 1024)
+#define FILE_SIZE (1024 * 1024)
 
 __global__ void mulKernel(int *a, int *c, int size) {
-    int idx = threadIdx.x + blockIdx.x * blockDim.x;
-    if (idx < size) {
-        c[idx] = a[idx] * 100;
-    }
+  int idx = threadIdx.x + blockIdx.x * blockDim.x;
+  if (idx < size) {
+    c[idx] = a[idx] * 100;
+  }
 }
 
-int main() {
-
-    // Define array size
-    const int size = 10;
-    const int bytes = size * sizeof(int);
+__host__ __device__ int pattern(const size_t i, const int seed) {
+  return (int)(i * 2654435761u) ^ seed;
+}
 
-    // Unified memory allocation
-    int *a, *c;
+__global__ void fill(int *data, size_t n, int seed) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+       i += gridDim.x * blockDim.x)
+    data[i] = pattern(i, seed);
+}
 
-    cudaMallocManaged(&c, bytes);
-    cudaMallocManaged(&a, bytes);
+__global__ void count_mismatches(const int *data, size_t n, int seed,
+                                 int *mismatches) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n;
+       i += gridDim.x * blockDim.x)
+    if (data[i] != pattern(i, seed))
+      atomicAdd(mismatches, 1);
+}
 
-    // Initialize arrays on the CPU
-    for (int i = 0; i < size; ++i) {
-        a[i] = i;
+static bool host_matches(const int *data, size_t n, int seed,
+                         const char *what) {
+  for (size_t i = 0; i < n; i++) {
+    if (data[i] != pattern(i, seed)) {
+      std::cout << what << ": element " << i << " is " << data[i]
+                << ", expected " << pattern(i, seed) << std::endl;
+      return false;
     }
+  }
+  return true;
+}
 
-    // Define kernel launch parameters
-    const int threadsPerBlock = 256;
-    const int blocks = (size + threadsPerBlock - 1) / threadsPerBlock;
+int main() {
+  const int size = 10;
+  const int bytes = size * sizeof(int);
 
-    std::cout << "launching kernel..." << std::endl;
+  int *a, *c, *mismatches;
+  if (cudaMallocManaged(&c, bytes) != cudaSuccess ||
+      cudaMallocManaged(&a, bytes) != cudaSuccess ||
+      cudaMallocManaged(&mismatches, 2 * sizeof(int)) != cudaSuccess) {
+    std::cout << "cudaMallocManaged failed" << std::endl;
+    return 1;
+  }
 
-    for (int i = 0; i < size; ++i) {
-        std::cout << "a[" << i << "] + b[" << i << "] = " << a[i] << "\n";
+  // only the page of a the host wrote goes up; all three come back.
+  for (int i = 0; i < size; ++i)
+    a[i] = i;
+  mulKernel<<<1, 256>>>(a, c, size);
+  cudaDeviceSynchronize();
+  for (int i = 0; i < size; ++i) {
+    if (c[i] != i * 100) {
+      std::cout << "c[" << i << "] is " << c[i] << ", expected " << i * 100
+                << std::endl;
+      return 1;
     }
+  }
 
-    // Launch the kernel
-    mulKernel<<<blocks, threadsPerBlock>>>(a, c, size);
+  // launches that follow move nothing up, since the host wrote nothing.
+  mulKernel<<<1, 256>>>(a, c, size);
+  mulKernel<<<1, 256>>>(a, c, size);
+  cudaDeviceSynchronize();
+  if (c[size - 1] != (size - 1) * 100) {
+    std::cout << "c changed across launches" << std::endl;
+    return 1;
+  }
 
-    // Wait for GPU to finish
-    cudaDeviceSynchronize();
-
-    // Display results
-    std::cout << "Results:\n";
-    for (int i = 0; i < size; ++i) {
-        std::cout << "a[" << i << "] + b[" << i << "] = " << c[i] << "\n";
-    }
+  // a device to host copy into managed memory, large enough to be received
+  // straight into it, then checked on the device, which needs it uploaded.
+  int *device, *big;
+  size_t n = BIG / sizeof(int);
+  if (cudaMalloc(&device, BIG) != cudaSuccess) {
+    std::cout << "cudaMalloc failed" << std::endl;
+    return 1;
+  }
+  fill<<<64, 256>>>(device, n, 1);
+  if (cudaMallocManaged(&big, BIG) != cudaSuccess ||
+      cudaMemcpy(big, device, BIG, cudaMemcpyDeviceToHost) != cudaSuccess) {
+    std::cout << "large copy into managed memory failed" << std::endl;
+    return 1;
+  }
+  if (!host_matches(big, n, 1, "large copy"))
+    return 1;
+  count_mismatches<<<64, 256>>>(big, n, 1, &mismatches[0]);
+  cudaDeviceSynchronize();
+  if (mismatches[0] != 0) {
+    std::cout << "device saw " << mismatches[0]
+              << " wrong elements after the large copy" << std::endl;
+    return 1;
+  }
 
-    // Free unified memory
-    cudaFree(a);
-    cudaFree(c);
+  // read() into managed memory, which the host writes first so the kernel
+  // finds the pages writable.
+  std::vector<int> contents(FILE_SIZE / sizeof(int));
+  for (size_t i = 0; i < contents.size(); i++)
+    contents[i] = pattern(i, 2);
+  char path[] = "/tmp/scuda_unified_XXXXXX";
+  int fd = mkstemp(path);
+  int *from_file;
+  if (fd < 0 ||
+      write(fd, contents.data(), FILE_SIZE) != FILE_SIZE ||
+      lseek(fd, 0, SEEK_SET) != 0 ||
+      cudaMallocManaged(&from_file, FILE_SIZE) != cudaSuccess) {
+    std::cout << "setting up the file failed" << std::endl;
+    return 1;
+  }
+  memset(from_file, 0, FILE_SIZE);
+  ssize_t got = read(fd, from_file, FILE_SIZE);
+  close(fd);
+  unlink(path);
+  if (got != FILE_SIZE) {
+    std::cout << "read() into managed memory returned " << got << std::endl;
+    return 1;
+  }
+  if (!host_matches(from_file, contents.size(), 2, "read()"))
+    return 1;
+  count_mismatches<<<64, 256>>>(from_file, contents.size(), 2,
+                                &mismatches[1]);
+  cudaDeviceSynchronize();
+  if (mismatches[1] != 0) {
+    std::cout << "device saw " << mismatches[1]
+              << " wrong elements after read()" << std::endl;
+    return 1;
+  }
 
-    return 0;
+  cudaFree(device);
+  cudaFree(big);
+  cudaFree(from_file);
+  cudaFree(a);
+  cudaFree(c);
+  cudaFree(mismatches);
+  std::cout << "PASSED" << std::endl;
+  return 0;
 }
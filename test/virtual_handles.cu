@@ -0,0 +1,118 @@
+#include <cublas_v2.h>
+#include <cuda_runtime.h>
+#include <stdio.h>
+
+// streams, events and cublas handles are named by the client and created on
+// the server without a round trip. these are used the moment they are
+// created, in the same batch as their creates, and must act on the objects
+// the server made for them. a name whose create failed, or that was
+// destroyed, must give an error rather than act on something else.
+#define N 1024
+
+__global__ void fill(float *data, const float value) {
+  int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < N)
+    data[i] = value;
+}
+
+int main() {
+  float *x, *y;
+  if (cudaMalloc(&x, N * sizeof(float)) != cudaSuccess ||
+      cudaMalloc(&y, N * sizeof(float)) != cudaSuccess) {
+    printf("cudaMalloc failed\n");
+    return 1;
+  }
+
+  // fill x on one stream, and have another wait for it through an event
+  // before it fills y from x.
+  cudaStream_t a, b;
+  cudaEvent_t start, filled;
+  if (cudaStreamCreate(&a) != cudaSuccess ||
+      cudaStreamCreateWithFlags(&b, cudaStreamNonBlocking) != cudaSuccess ||
+      cudaEventCreate(&start) != cudaSuccess ||
+      cudaEventCreate(&filled) != cudaSuccess) {
+    printf("creating streams and events failed\n");
+    return 1;
+  }
+  if (a == b || start == filled || a == 0 || b == 0) {
+    printf("the client handed out the same handle twice\n");
+    return 1;
+  }
+  cudaEventRecord(start, a);
+  fill<<<N / 256, 256, 0, a>>>(x, 2.0f);
+  cudaEventRecord(filled, a);
+  cudaStreamWaitEvent(b, filled, 0);
+  cudaMemcpyAsync(y, x, N * sizeof(float), cudaMemcpyDeviceToDevice, b);
+
+  // y += 3 * y through cublas, on stream b.
+  cublasHandle_t handle;
+  cudaStream_t got;
+  const float alpha = 3.0f;
+  if (cublasCreate(&handle) != CUBLAS_STATUS_SUCCESS ||
+      cublasSetStream(handle, b) != CUBLAS_STATUS_SUCCESS ||
+      cublasGetStream(handle, &got) != CUBLAS_STATUS_SUCCESS || got != b) {
+    printf("cublas handle doesn't hand back the stream it was given\n");
+    return 1;
+  }
+  if (cublasSaxpy(handle, N, &alpha, y, 1, y, 1) != CUBLAS_STATUS_SUCCESS ||
+      cudaStreamSynchronize(b) != cudaSuccess) {
+    printf("cublasSaxpy failed\n");
+    return 1;
+  }
+
+  float host[N];
+  if (cudaMemcpy(host, y, sizeof(host), cudaMemcpyDeviceToHost) !=
+      cudaSuccess) {
+    printf("copying back failed\n");
+    return 1;
+  }
+  for (int i = 0; i < N; i++) {
+    if (host[i] != 8.0f) {
+      printf("y[%d] is %f, expected 8\n", i, host[i]);
+      return 1;
+    }
+  }
+
+  float ms;
+  if (cudaEventQuery(filled) != cudaSuccess ||
+      cudaEventElapsedTime(&ms, start, filled) != cudaSuccess || ms < 0) {
+    printf("events weren't recorded\n");
+    return 1;
+  }
+
+  // a destroyed name no longer stands for anything.
+  if (cublasDestroy(handle) != CUBLAS_STATUS_SUCCESS ||
+      cudaEventDestroy(filled) != cudaSuccess) {
+    printf("destroying handles failed\n");
+    return 1;
+  }
+  cudaError_t err = cudaEventQuery(filled);
+  if (err == cudaSuccess || err == cudaErrorNotReady) {
+    printf("a destroyed event could still be queried\n");
+    return 1;
+  }
+  cudaGetLastError();
+
+  // an event with flags the runtime rejects. the create doesn't wait, so its
+  // error comes from the next sync point, and the name maps to nothing.
+  cudaEvent_t bad = nullptr;
+  if (cudaEventCreateWithFlags(&bad, 0x80) == cudaSuccess &&
+      cudaDeviceSynchronize() != cudaErrorInvalidValue) {
+    printf("a failed create wasn't reported\n");
+    return 1;
+  }
+  err = cudaEventQuery(bad);
+  if (err == cudaSuccess || err == cudaErrorNotReady) {
+    printf("an event that failed to create could be queried\n");
+    return 1;
+  }
+  cudaGetLastError();
+
+  cudaEventDestroy(start);
+  cudaStreamDestroy(a);
+  cudaStreamDestroy(b);
+  cudaFree(x);
+  cudaFree(y);
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "shm.h"
+#include "zerocopy.h"
+
+typedef enum {
+  TRANSPORT_TCP,
+  TRANSPORT_UNIX,
+  TRANSPORT_SHM,
+} transport_kind_t;
+
+// how a connection moves bytes. the rpc layer above (rpc_write, rpc_read,
+// rpc_end_response, ...) only goes through transport_read and
+// transport_writev, so it doesn't care which one it's on.
+typedef struct {
+  transport_kind_t kind;
+  // the socket. for shared memory, the unix socket the region was handed over
+  // on, which stays open so either side notices the other going away.
+  int fd;
+  shm_t shm;
+  zerocopy_t zerocopy;
+} transport_t;
+
+// sends of at least zerocopy_size bytes over tcp use MSG_ZEROCOPY; 0 turns
+// that off.
+static inline void transport_init(transport_t *t, const transport_kind_t kind,
+                                  const int fd, const size_t zerocopy_size) {
+  t->kind = kind;
+  t->fd = fd;
+  t->zerocopy.enabled = false;
+  if (kind == TRANSPORT_TCP && zerocopy_size > 0)
+    zerocopy_init(&t->zerocopy, fd);
+}
+
+// like recv with MSG_WAITALL; returns less than size only at eof.
+static inline ssize_t transport_read(transport_t *t, void *data,
+                                     const size_t size) {
+  if (t->kind == TRANSPORT_SHM)
+    return shm_read(&t->shm, data, size);
+  return recv(t->fd, data, size, MSG_WAITALL);
+}
+
+// pieces of at least zerocopy_size bytes (of those marked in zerocopy, if
+// given) may go out with MSG_ZEROCOPY, in which case they must stay unchanged
+// until transport_release returns for a ticket taken after this.
+static inline ssize_t transport_writev(transport_t *t, struct iovec *iov,
+                                       const int iovcnt,
+                                       const size_t zerocopy_size,
+                                       const bool *zerocopy) {
+  if (t->kind == TRANSPORT_SHM)
+    return shm_writev(&t->shm, iov, iovcnt);
+
+  if (t->zerocopy.enabled && zerocopy_size > 0)
+    return zerocopy_writev(&t->zerocopy, t->fd, iov, iovcnt, zerocopy_size,
+                           zerocopy);
+  return writev(t->fd, iov, iovcnt);
+}
+
+// a ticket for everything written so far; see transport_release.
+static inline uint32_t transport_ticket(transport_t *t) {
+  if (t->kind == TRANSPORT_SHM)
+    return 0;
+  return zerocopy_ticket(&t->zerocopy);
+}
+
+// wait until buffers written before ticket was taken may be changed again.
+// returns right away unless they went out with MSG_ZEROCOPY.
+static inline int transport_release(transport_t *t, const uint32_t ticket) {
+  if (t->kind == TRANSPORT_SHM)
+    return 0;
+  return zerocopy_wait(&t->zerocopy, t->fd, ticket);
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef VIRTUAL_HANDLE_H
+#define VIRTUAL_HANDLE_H
+
+#include <stdint.h>
+
+// set in the handles a client makes up for the streams, events and library
+// handles it creates. real handles are user-space addresses, which never have
+// the top bit set, so the server can tell the two apart.
+#define VIRTUAL_HANDLE_BIT (1ull << 63)
+
+#endif
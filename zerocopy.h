@@ -0,0 +1,201 @@
+#ifndef ZEROCOPY_H
+#define ZEROCOPY_H
+
+#include <errno.h>
+// linux/errqueue.h uses struct timespec without including its definition.
+#include <time.h>
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+// smaller pieces are always copied, so headers on the stack and inline fields
+// can be reused as soon as the write returns. pinning pages doesn't pay off
+// below this anyway.
+#define ZEROCOPY_MIN_SIZE (16 * 1024)
+
+// MSG_ZEROCOPY state of a socket. the kernel numbers every zero-copy send on a
+// socket and reports ranges of finished sends on its error queue; until then
+// it still references the pages of the caller's buffers. a caller that wants
+// to reuse a buffer takes a ticket (the value of sent) right after sending it
+// and waits for that ticket just before the reuse, so sends never wait on
+// themselves.
+typedef struct {
+  bool enabled;
+  // the kernel copied a send anyway, so the rest go out normally.
+  bool copied;
+  pthread_mutex_t mutex;
+  uint32_t sent;
+  uint32_t completed;
+} zerocopy_t;
+
+static inline void zerocopy_init(zerocopy_t *zc, const int fd) {
+  const int enable = 1;
+  zc->enabled =
+      setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(int)) == 0;
+  zc->copied = false;
+  pthread_mutex_init(&zc->mutex, NULL);
+  zc->sent = 0;
+  zc->completed = 0;
+}
+
+// take whatever notifications are on the error queue without blocking. called
+// with zc->mutex held.
+static inline int zerocopy_reap(zerocopy_t *zc, const int fd) {
+  while (zc->completed != zc->sent) {
+    char control[128];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      if (errno == EINTR)
+        continue;
+      return errno == EAGAIN ? 0 : -1;
+    }
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+        continue;
+
+      struct sock_extended_err *err =
+          (struct sock_extended_err *)CMSG_DATA(cmsg);
+      if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+
+      // [ee_info, ee_data] is an inclusive range of finished sends.
+      zc->completed += err->ee_data - err->ee_info + 1;
+
+      // the kernel had to copy anyway (loopback, no scatter-gather support),
+      // so the notifications are pure overhead from here on.
+      if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        zc->copied = true;
+    }
+  }
+  return 0;
+}
+
+// the ticket for everything sent on this socket so far.
+static inline uint32_t zerocopy_ticket(zerocopy_t *zc) {
+  if (!zc->enabled)
+    return 0;
+  pthread_mutex_lock(&zc->mutex);
+  uint32_t ticket = zc->sent;
+  pthread_mutex_unlock(&zc->mutex);
+  return ticket;
+}
+
+// block until the kernel has released the buffers of every send up to and
+// including ticket.
+static inline int zerocopy_wait(zerocopy_t *zc, const int fd,
+                                const uint32_t ticket) {
+  if (!zc->enabled)
+    return 0;
+  for (;;) {
+    pthread_mutex_lock(&zc->mutex);
+    int ret = zerocopy_reap(zc, fd);
+    bool done = (int32_t)(zc->completed - ticket) >= 0;
+    pthread_mutex_unlock(&zc->mutex);
+    if (ret < 0 || done)
+      return ret;
+
+    // error queue entries show up as POLLERR. another thread may take them
+    // first, so don't sleep on it for long.
+    struct pollfd pfd = {fd, 0, 0};
+    if (poll(&pfd, 1, 1) < 0 && errno != EINTR)
+      return -1;
+    if (pfd.revents & (POLLHUP | POLLNVAL)) {
+      errno = EPIPE;
+      return -1;
+    }
+  }
+}
+
+static inline bool zerocopy_eligible(const zerocopy_t *zc,
+                                     const struct iovec *iov, const int i,
+                                     const size_t threshold,
+                                     const bool *eligible) {
+  return !zc->copied && iov[i].iov_len >= threshold &&
+         iov[i].iov_len >= ZEROCOPY_MIN_SIZE &&
+         (eligible == NULL || eligible[i]);
+}
+
+// writev without copying the pieces of at least threshold bytes (of those
+// marked in eligible, if given) into the socket buffer. the rest are copied
+// as usual. returns without waiting for the
+// kernel; the caller must not change a zero-copy piece until zerocopy_wait
+// returns for the ticket taken after this.
+static inline ssize_t zerocopy_writev(zerocopy_t *zc, const int fd,
+                                      struct iovec *iov, const int iovcnt,
+                                      const size_t threshold,
+                                      const bool *eligible) {
+  ssize_t total = 0;
+  for (int start = 0; start < iovcnt;) {
+    // the longest run of pieces that go out the same way.
+    const bool zerocopy =
+        zerocopy_eligible(zc, iov, start, threshold, eligible);
+    int end = start + 1;
+    while (end < iovcnt &&
+           zerocopy_eligible(zc, iov, end, threshold, eligible) == zerocopy)
+      end++;
+
+    struct msghdr msg = {};
+    msg.msg_iov = iov + start;
+    msg.msg_iovlen = end - start;
+    const int more = end < iovcnt ? MSG_MORE : 0;
+    while (msg.msg_iovlen > 0) {
+      ssize_t n = -1;
+      if (zerocopy) {
+        n = sendmsg(fd, &msg, MSG_ZEROCOPY | more);
+        if (n >= 0) {
+          pthread_mutex_lock(&zc->mutex);
+          zc->sent++;
+          pthread_mutex_unlock(&zc->mutex);
+        }
+      }
+      // out of option memory to pin more pages; send this part normally.
+      if (!zerocopy || (n < 0 && errno == ENOBUFS))
+        n = sendmsg(fd, &msg, more);
+
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        return -1;
+      }
+      total += n;
+
+      // skip past whatever was sent.
+      while (msg.msg_iovlen > 0 && (size_t)n >= msg.msg_iov->iov_len) {
+        n -= msg.msg_iov->iov_len;
+        msg.msg_iov++;
+        msg.msg_iovlen--;
+      }
+      if (msg.msg_iovlen > 0) {
+        msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + n;
+        msg.msg_iov->iov_len -= n;
+      }
+    }
+    start = end;
+  }
+
+  // keep the error queue short.
+  pthread_mutex_lock(&zc->mutex);
+  int ret = zerocopy_reap(zc, fd);
+  pthread_mutex_unlock(&zc->mutex);
+  return ret < 0 ? -1 : total;
+}
+
+#endif